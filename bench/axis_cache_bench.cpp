@@ -0,0 +1,194 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <math.hpp>
+#include <dynamic_aabb_tree.hpp>
+#include <collision_hull.hpp>
+#include <separating_axis_cache.hpp>
+
+namespace
+{
+	constexpr int FRAMES = 600;
+
+	volatile float sink = 0.f;
+
+	/**
+	* @brief Shape that drifts and spins slowly and bounces off the world borders
+	*/
+	struct Body
+	{
+		std::unique_ptr<sf::Shape> Shape;
+		sf::Vector2f Velocity;
+		float AngularVelocity;
+	};
+
+	void step(Body& body, float worldSize)
+	{
+		sf::Vector2f position = body.Shape->getPosition() + body.Velocity;
+
+		if (position.x < 0.f || position.x > worldSize)
+		{
+			body.Velocity.x = -body.Velocity.x;
+		}
+
+		if (position.y < 0.f || position.y > worldSize)
+		{
+			body.Velocity.y = -body.Velocity.y;
+		}
+
+		body.Shape->move(body.Velocity);
+		body.Shape->rotate(body.AngularVelocity);
+	}
+
+	/**
+	* @brief Scatters rectangles and regular polygons, the world grows with the amount of bodies to keep the density
+	*/
+	std::vector<Body> makeScene(size_t bodiesAmount, float speed, float worldSize)
+	{
+		std::mt19937 generator{ 42 };
+		std::uniform_real_distribution<float> position{ 0.f, worldSize };
+		std::uniform_real_distribution<float> size{ 15.f, 40.f };
+		std::uniform_real_distribution<float> velocity{ -speed, speed };
+		std::uniform_real_distribution<float> angularVelocity{ -0.5f, 0.5f };
+		std::uniform_real_distribution<float> angle{ 0.f, 360.f };
+		std::uniform_int_distribution<size_t> points{ 3, 12 };
+
+		std::vector<Body> bodies;
+
+		for (size_t i = 0; i < bodiesAmount; i++)
+		{
+			std::unique_ptr<sf::Shape> shape;
+
+			if (i % 2 == 0)
+			{
+				shape = std::make_unique<sf::RectangleShape>(sf::Vector2f{ size(generator), size(generator) });
+			}
+			else
+			{
+				shape = std::make_unique<sf::CircleShape>(size(generator), points(generator));
+			}
+
+			shape->setPosition({ position(generator), position(generator) });
+			shape->setRotation(angle(generator));
+			bodies.push_back(Body{ std::move(shape), { velocity(generator), velocity(generator) }, angularVelocity(generator) });
+		}
+
+		return bodies;
+	}
+
+	struct Result
+	{
+		double PlainFrameTime = 0.;
+		double CachedFrameTime = 0.;
+		double PairsPerFrame = 0.;
+		double CollisionsPerFrame = 0.;
+		double HitRate = 0.;
+	};
+
+	/**
+	* @brief Simulates the scene, every frame candidate pairs from the broadphase are checked
+	* with plain hull SAT and with the axis cache
+	*/
+	Result run(size_t bodiesAmount, float speed)
+	{
+		const float WORLD_SIZE = 125.f * std::sqrt(static_cast<float>(bodiesAmount));
+		std::vector<Body> bodies = makeScene(bodiesAmount, speed, WORLD_SIZE);
+		std::vector<Engine::CollisionHull> hulls;
+		std::vector<int32_t> proxies;
+
+		// generous margin keeps pairs alive for many frames, the usual case the cache is made for
+		Engine::DynamicAabbTree<uint32_t> broadphase{ 16.f };
+
+		for (size_t i = 0; i < bodies.size(); i++)
+		{
+			hulls.emplace_back(bodies[i].Shape.get());
+			proxies.push_back(broadphase.CreateProxy(Engine::Aabb::FromRect(bodies[i].Shape->getGlobalBounds()), static_cast<uint32_t>(i)));
+		}
+
+		Engine::SeparatingAxisCache cache;
+		std::vector<Engine::DynamicAabbTree<uint32_t>::ProxyPair> pairs;
+		Result result;
+		size_t collisions = 0;
+		size_t pairsAmount = 0;
+
+		for (int frame = 0; frame < FRAMES; frame++)
+		{
+			for (size_t i = 0; i < bodies.size(); i++)
+			{
+				step(bodies[i], WORLD_SIZE);
+				hulls[i].Update(bodies[i].Shape.get());
+				broadphase.MoveProxy(proxies[i], Engine::Aabb::FromRect(bodies[i].Shape->getGlobalBounds()), bodies[i].Velocity);
+			}
+
+			broadphase.QueryOverlappingPairs(pairs);
+			pairsAmount += pairs.size();
+
+			auto start = std::chrono::steady_clock::now();
+
+			for (const auto& [proxyA, proxyB] : pairs)
+			{
+				uint32_t a = broadphase.GetUserData(proxyA);
+				uint32_t b = broadphase.GetUserData(proxyB);
+
+				if (auto response = Engine::processCollision(hulls[a], hulls[b]))
+				{
+					sink = sink + response->MinimumTransitionVector.x;
+					collisions++;
+				}
+			}
+
+			auto middle = std::chrono::steady_clock::now();
+
+			for (const auto& [proxyA, proxyB] : pairs)
+			{
+				uint32_t a = broadphase.GetUserData(proxyA);
+				uint32_t b = broadphase.GetUserData(proxyB);
+
+				if (auto response = cache.ProcessCollision(a, hulls[a], b, hulls[b]))
+				{
+					sink = sink + response->MinimumTransitionVector.x;
+				}
+			}
+
+			cache.NextFrame();
+			auto end = std::chrono::steady_clock::now();
+			result.PlainFrameTime += std::chrono::duration<double, std::micro>(middle - start).count();
+			result.CachedFrameTime += std::chrono::duration<double, std::micro>(end - middle).count();
+		}
+
+		result.PlainFrameTime /= FRAMES;
+		result.CachedFrameTime /= FRAMES;
+		result.PairsPerFrame = static_cast<double>(pairsAmount) / FRAMES;
+		result.CollisionsPerFrame = static_cast<double>(collisions) / FRAMES;
+		result.HitRate = cache.GetStatistics().HitRate();
+		return result;
+	}
+} // namespace
+
+int main()
+{
+	std::printf("%7s | %6s | %10s | %10s | %14s | %14s | %8s | %8s\n",
+		"bodies", "speed", "pairs", "collisions", "plain us/frame", "cached us/frame", "speedup", "hit rate");
+
+	for (size_t bodiesAmount : { 250, 1000, 4000 })
+	{
+		for (float speed : { 0.25f, 1.f, 4.f })
+		{
+			Result result = run(bodiesAmount, speed);
+
+			std::printf("%7zu | %6.2f | %10.1f | %10.1f | %14.2f | %15.2f | %7.2fx | %7.1f%%\n",
+				bodiesAmount, speed, result.PairsPerFrame, result.CollisionsPerFrame,
+				result.PlainFrameTime, result.CachedFrameTime, result.PlainFrameTime / result.CachedFrameTime,
+				result.HitRate * 100.);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <world.hpp>
+#include <world_batch.hpp>
+
+namespace
+{
+	/**
+	* @brief Shapes of the demo scene: a falling box, two map parts and a floor, the world keeps pointers to them
+	*/
+	struct Scene
+	{
+		std::array<sf::RectangleShape, 4> Shapes;
+	};
+
+	/**
+	* @brief The demo scene with the box dropped from a position and rotation that depend on the index, like a parameter sweep
+	*/
+	void buildScene(Scene& scene, Engine::World& world, size_t index)
+	{
+		auto& [obj, movableMapRect, staticMapRect, floor] = scene.Shapes;
+
+		obj.setSize({ 200.f, 100.f });
+		obj.setPosition({ 200.f + static_cast<float>(index % 50) * 4.f, 250.f });
+		obj.setRotation(-10.f + static_cast<float>(index % 21));
+		movableMapRect.setSize({ 200.f, 100.f });
+		movableMapRect.setPosition({ 410.f, 230.f });
+		movableMapRect.setRotation(-12.f);
+		staticMapRect.setSize({ 200.f, 300.f });
+		staticMapRect.setPosition({ 600.f, 300.f });
+		floor.setSize({ 1280.f, 32.f });
+		floor.setPosition({ 0.f, 688.f });
+
+		world.SetGravity({ 0.f, 300.f });
+		world.CreateDynamicBody(&obj);
+		world.CreateStaticBody(&movableMapRect);
+		world.CreateStaticGeometry(&staticMapRect);
+		world.CreateStaticGeometry(&floor);
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0))
+	{
+		std::printf("usage: %s [worlds] [steps] [max workers]\n"
+			"  steps the same batch of worlds with 1, 2, 4, ... workers up to max workers and prints world steps per second\n", argv[0]);
+		return 0;
+	}
+
+	size_t worldCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+	size_t steps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 240;
+	size_t maxWorkers = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+	std::printf("worlds: %zu, steps: %zu\n", worldCount, steps);
+	std::printf("workers,seconds,world_steps_per_second,speedup\n");
+	std::vector<size_t> workerCounts;
+
+	for (size_t workers = 1; workers < maxWorkers; workers *= 2)
+	{
+		workerCounts.push_back(workers);
+	}
+
+	workerCounts.push_back(maxWorkers);
+	double singleWorkerRate = 0.;
+
+	for (size_t workers : workerCounts)
+	{
+		// every run starts from the same scenes
+		std::vector<Scene> scenes(worldCount);
+		Engine::WorldBatch batch{ workers };
+
+		for (size_t index = 0; index < worldCount; index++)
+		{
+			buildScene(scenes[index], batch.CreateWorld(), index);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		batch.Step(steps);
+		auto end = std::chrono::steady_clock::now();
+
+		double seconds = std::chrono::duration<double>(end - start).count();
+		double rate = static_cast<double>(worldCount * steps) / seconds;
+		singleWorkerRate = workers == 1 ? rate : singleWorkerRate;
+		std::printf("%zu,%.3f,%.0f,%.2f\n", workers, seconds, rate, rate / singleWorkerRate);
+	}
+
+	return 0;
+}
\ No newline at end of file
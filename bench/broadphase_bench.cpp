@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <dynamic_aabb_tree.hpp>
+
+namespace
+{
+	constexpr size_t QUERIES = 100;
+	constexpr int REPEATS = 10;
+
+	/**
+	* @brief runs the function REPEATS times
+	* @returns average duration of a single run in nanoseconds
+	*/
+	template <typename Function>
+	double measure(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < REPEATS; i++)
+		{
+			function();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / REPEATS;
+	}
+
+	/**
+	* @brief scatters boxes over a square world whose side grows with the count, so density stays the same
+	*/
+	std::vector<sf::FloatRect> makeScene(size_t count, std::mt19937& random)
+	{
+		const float WORLD_SIDE = 60.f * std::sqrt(static_cast<float>(count));
+		std::uniform_real_distribution<float> position(0.f, WORLD_SIDE);
+		std::uniform_real_distribution<float> size(10.f, 50.f);
+
+		std::vector<sf::FloatRect> scene(count);
+
+		for (auto& rect : scene)
+		{
+			rect = sf::FloatRect{ position(random), position(random), size(random), size(random) };
+		}
+
+		return scene;
+	}
+} // namespace
+
+int main()
+{
+	std::mt19937 random{ 42 };
+
+	std::printf("%8s | %12s | %12s | %12s | %12s | %12s | %10s\n",
+		"shapes", "scan ns/q", "tree ns/q", "speedup", "build ms", "move ns/op", "pairs ms");
+
+	for (size_t count : { 10, 100, 1000, 10000, 100000 })
+	{
+		std::vector<sf::FloatRect> scene = makeScene(count, random);
+		std::vector<sf::FloatRect> bodies = makeScene(QUERIES, random);
+
+		// bodies are spread over the same world as the scene
+		const float SCALE = std::sqrt(static_cast<float>(count) / QUERIES);
+
+		for (auto& body : bodies)
+		{
+			body.left *= SCALE;
+			body.top *= SCALE;
+		}
+
+		// linear bounds scan as done in main.cpp
+		size_t scanCandidates = 0;
+		double scanTime = measure([&]()
+		{
+			scanCandidates = 0;
+
+			for (const auto& body : bodies)
+			{
+				for (const auto& part : scene)
+				{
+					scanCandidates += body.intersects(part);
+				}
+			}
+		});
+
+		Engine::DynamicAabbTree<size_t> tree;
+		std::vector<int32_t> proxies(count);
+
+		double buildTime = measure([&]()
+		{
+			tree = Engine::DynamicAabbTree<size_t>{};
+
+			for (size_t i = 0; i < count; i++)
+			{
+				proxies[i] = tree.CreateProxy(Engine::Aabb::FromRect(scene[i]), i);
+			}
+		});
+
+		size_t treeCandidates = 0;
+		double treeTime = measure([&]()
+		{
+			treeCandidates = 0;
+
+			for (const auto& body : bodies)
+			{
+				tree.Query(Engine::Aabb::FromRect(body), [&](int32_t)
+				{
+					treeCandidates++;
+					return true;
+				});
+			}
+		});
+
+		// small jitter, most of the moves stay inside the fattened boxes
+		std::uniform_real_distribution<float> jitter(-1.f, 1.f);
+		double moveTime = measure([&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				sf::Vector2f displacement{ jitter(random), jitter(random) };
+				scene[i].left += displacement.x;
+				scene[i].top += displacement.y;
+				tree.MoveProxy(proxies[i], Engine::Aabb::FromRect(scene[i]), displacement);
+			}
+		});
+
+		std::vector<Engine::DynamicAabbTree<size_t>::ProxyPair> pairs;
+		double pairsTime = measure([&]()
+		{
+			tree.QueryOverlappingPairs(pairs);
+		});
+
+		std::printf("%8zu | %12.1f | %12.1f | %11.1fx | %12.3f | %12.1f | %10.3f   (candidates: scan %zu, tree %zu, pairs %zu)\n",
+			count,
+			scanTime / QUERIES,
+			treeTime / QUERIES,
+			scanTime / treeTime,
+			buildTime / 1e6,
+			moveTime / count,
+			pairsTime / 1e6,
+			scanCandidates, treeCandidates, pairs.size());
+	}
+
+	return 0;
+}
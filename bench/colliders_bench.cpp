@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <math.hpp>
+#include <colliders.hpp>
+
+namespace
+{
+	constexpr int ITERATIONS = 200000;
+
+	volatile float sink = 0.f;
+
+	/**
+	* @brief runs the function ITERATIONS times
+	* @returns average duration of a single run in nanoseconds
+	*/
+	template <typename Function>
+	double measure(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+			function();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+	}
+
+	void consume(const std::optional<Engine::CollisionResponse>& response)
+	{
+		sink = sink + (response ? response->MinimumTransitionVector.x : 1.f);
+	}
+
+	/**
+	* @brief compares SAT over vertex vectors with the routine picked for the collider types
+	*/
+	void compare(const char* name, const sf::Shape& a, const sf::Shape& b)
+	{
+		std::vector<sf::Vector2f> verticesA = Engine::getVertices(&a);
+		std::vector<sf::Vector2f> verticesB = Engine::getVertices(&b);
+		Engine::Collider colliderA = Engine::makeCollider(&a);
+		Engine::Collider colliderB = Engine::makeCollider(&b);
+		Engine::CollisionScratch scratch;
+
+		bool isColliding = Engine::processCollision(verticesA, verticesB, scratch).has_value();
+
+		double genericTime = measure([&]()
+		{
+			consume(Engine::processCollision(verticesA, verticesB, scratch));
+		});
+
+		double colliderTime = measure([&]()
+		{
+			consume(Engine::processCollision(colliderA, colliderB, scratch));
+		});
+
+		std::printf("%-19s | %9s | %12.1f | %12.1f | %7.2fx\n", name, isColliding ? "colliding" : "separated",
+			genericTime, colliderTime, genericTime / colliderTime);
+	}
+} // namespace
+
+int main()
+{
+	std::printf("%-19s | %9s | %12s | %12s | %8s\n", "pair", "", "generic ns", "collider ns", "speedup");
+
+	// colliding pair and separated pair with overlapping bounds
+	for (float distance : { 30.f, 80.f })
+	{
+		sf::RectangleShape rectangleA{ { 100.f, 40.f } };
+		rectangleA.setRotation(20.f);
+		sf::RectangleShape rectangleB{ { 60.f, 60.f } };
+		rectangleB.setPosition({ distance, distance });
+		rectangleB.setRotation(-35.f);
+
+		sf::CircleShape circleA{ 30.f };
+		sf::CircleShape circleB{ 30.f };
+		circleB.setPosition({ distance, distance });
+
+		compare("rectangle-rectangle", rectangleA, rectangleB);
+		compare("circle-circle", circleA, circleB);
+		compare("circle-rectangle", circleA, rectangleB);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,808 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/Graphics/ConvexShape.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <math.hpp>
+#include <collision_hull.hpp>
+#include <collision_lod.hpp>
+#include <convex_decomposition.hpp>
+#include <dynamic_aabb_tree.hpp>
+#include <static_bvh.hpp>
+#include <time_of_impact.hpp>
+#include <spatial_query.hpp>
+#include <tile_layer.hpp>
+#include <scene_file.hpp>
+#include <world.hpp>
+
+namespace
+{
+	// every sample runs for at least this long, the reported time is the median of SAMPLES samples
+	constexpr double SAMPLE_NANOSECONDS = 20e6;
+	constexpr int SAMPLES = 5;
+
+	volatile float sink = 0.f;
+
+	void consume(float value)
+	{
+		sink = sink + value;
+	}
+
+	struct Result
+	{
+		std::string Name;
+		double NanosecondsPerOp;
+		uint64_t Iterations;
+	};
+
+	struct Options
+	{
+		std::string Filter;
+		std::string OutputPath;
+		std::string BaselinePath;
+		// relative slowdown reported as a regression
+		double Threshold = 0.1;
+	};
+
+	/**
+	* @brief Runs registered benchmarks whose name contains the filter and keeps their results
+	*/
+	class Suite
+	{
+	public:
+		explicit Suite(const std::string& filter)
+			: _filter(filter) {}
+
+		/**
+		* @brief Measures the function, the batch size grows until a sample takes SAMPLE_NANOSECONDS
+		* @param name: unique name, "group/case/parameters"
+		* @param function: one operation
+		*/
+		template <typename Function>
+		void Run(const std::string& name, Function&& function)
+		{
+			if (name.find(_filter) == std::string::npos)
+			{
+				return;
+			}
+
+			uint64_t batch = 1;
+			double batchTime = 0.;
+
+			// warms up caches and finds the batch size
+			while ((batchTime = RunBatch(function, batch)) < SAMPLE_NANOSECONDS / 10.)
+			{
+				batch *= 2;
+			}
+
+			batch = std::max<uint64_t>(1, static_cast<uint64_t>(batch * SAMPLE_NANOSECONDS / batchTime));
+			std::vector<double> samples(SAMPLES);
+
+			for (double& sample : samples)
+			{
+				sample = RunBatch(function, batch) / static_cast<double>(batch);
+			}
+
+			std::sort(samples.begin(), samples.end());
+			_results.push_back(Result{ name, samples[SAMPLES / 2], batch * SAMPLES });
+			std::fprintf(stderr, "%-48s %14.1f ns/op\n", name.c_str(), samples[SAMPLES / 2]);
+		}
+
+		const std::vector<Result>& GetResults() const noexcept
+		{
+			return _results;
+		}
+
+	private:
+		template <typename Function>
+		static double RunBatch(Function& function, uint64_t batch)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			for (uint64_t i = 0; i < batch; i++)
+			{
+				function();
+			}
+
+			auto end = std::chrono::steady_clock::now();
+			return std::chrono::duration<double, std::nano>(end - start).count();
+		}
+
+		std::string _filter;
+		std::vector<Result> _results;
+	};
+
+	/**
+	* @brief Writes results as CSV: a header line, then "name,ns_per_op,iterations" per benchmark
+	*/
+	void writeCsv(std::ostream& stream, const std::vector<Result>& results)
+	{
+		stream << "name,ns_per_op,iterations\n";
+
+		for (const auto& result : results)
+		{
+			stream << result.Name << ',' << result.NanosecondsPerOp << ',' << result.Iterations << '\n';
+		}
+	}
+
+	/**
+	* @brief Reads a file written by writeCsv
+	* @returns time per operation by benchmark name
+	*/
+	std::map<std::string, double> readCsv(std::istream& stream)
+	{
+		std::map<std::string, double> results;
+		std::string line;
+		std::getline(stream, line);
+
+		while (std::getline(stream, line))
+		{
+			std::istringstream fields{ line };
+			std::string name;
+			std::string time;
+
+			if (std::getline(fields, name, ',') && std::getline(fields, time, ','))
+			{
+				results[name] = std::strtod(time.c_str(), nullptr);
+			}
+		}
+
+		return results;
+	}
+
+	/**
+	* @brief Prints the change of every benchmark against the baseline
+	* @returns number of benchmarks slower than the baseline by more than the threshold
+	*/
+	size_t compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline, double threshold)
+	{
+		size_t regressions = 0;
+		std::printf("%-48s | %14s | %14s | %8s\n", "benchmark", "baseline ns", "current ns", "change");
+
+		for (const auto& result : results)
+		{
+			auto found = baseline.find(result.Name);
+
+			if (found == baseline.end() || found->second <= 0.)
+			{
+				std::printf("%-48s | %14s | %14.1f | %8s\n", result.Name.c_str(), "-", result.NanosecondsPerOp, "new");
+				continue;
+			}
+
+			double change = result.NanosecondsPerOp / found->second - 1.;
+			bool isRegression = change > threshold;
+			regressions += isRegression;
+
+			std::printf("%-48s | %14.1f | %14.1f | %+7.1f%%%s\n",
+				result.Name.c_str(), found->second, result.NanosecondsPerOp, change * 100., isRegression ? "  REGRESSION" : "");
+		}
+
+		return regressions;
+	}
+
+	/**
+	* @brief SAT of two regular polygons of the same size
+	* @param overlap: depth of the overlap relative to the polygon diameter, 0 and less means the polygons are apart
+	*/
+	void benchCollision(Suite& suite, size_t vertices, float overlap, const char* overlapName)
+	{
+		const float RADIUS = 50.f;
+		sf::CircleShape a{ RADIUS, vertices };
+		sf::CircleShape b{ RADIUS, vertices };
+		a.setOrigin({ RADIUS, RADIUS });
+		b.setOrigin({ RADIUS, RADIUS });
+		b.setPosition({ 2.f * RADIUS * (1.f - overlap), 0.f });
+		b.setRotation(7.f);
+
+		std::vector<sf::Vector2f> verticesA = Engine::getVertices(&a);
+		std::vector<sf::Vector2f> verticesB = Engine::getVertices(&b);
+		Engine::CollisionScratch scratch;
+		std::string parameters = "/v" + std::to_string(vertices) + "/" + overlapName;
+
+		suite.Run("sat/vertices" + parameters, [&]()
+		{
+			auto response = Engine::processCollision(verticesA, verticesB, scratch);
+			consume(response ? response->MinimumTransitionVector.x : 0.f);
+		});
+
+		// without the code for triangles and quads, for comparison
+		suite.Run("sat/generic" + parameters, [&]()
+		{
+			auto response = Engine::detail::separatingAxisTest(verticesA, verticesB, scratch);
+			consume(response ? response->MinimumTransitionVector.x : 0.f);
+		});
+
+		Engine::CollisionHull hullA{ &a };
+		Engine::CollisionHull hullB{ &b };
+
+		suite.Run("sat/hull" + parameters, [&]()
+		{
+			auto response = Engine::processCollision(hullA, hullB);
+			consume(response ? response->MinimumTransitionVector.x : 0.f);
+		});
+
+		suite.Run("sat/hull_generic" + parameters, [&]()
+		{
+			auto response = Engine::detail::hullSeparatingAxisTest(hullA.GetView(), hullB.GetView(), hullA.GetView().Vertices, hullB.GetView().Vertices);
+			consume(response ? response->MinimumTransitionVector.x : 0.f);
+		});
+	}
+
+	/**
+	* @brief SAT of two overlapping circles on their 8 vertex collision proxies, compare with sat/hull on the full ones
+	*/
+	void benchCollisionLod(Suite& suite, size_t vertices)
+	{
+		const float RADIUS = 50.f;
+		sf::CircleShape circle{ RADIUS, vertices };
+		circle.setOrigin({ RADIUS, RADIUS });
+		std::vector<sf::Vector2f> circleVertices = Engine::getVertices(&circle);
+		std::string parameters = "/v" + std::to_string(vertices);
+
+		suite.Run("lod/simplify" + parameters, [&]()
+		{
+			consume(Engine::simplifyConvexPolygon(circleVertices, Engine::CollisionLod{}).MaxDeviation);
+		});
+
+		std::vector<sf::Vector2f> proxy = Engine::simplifyConvexPolygon(circleVertices, Engine::CollisionLod{}).Vertices;
+		sf::ConvexShape a{ proxy.size() };
+		sf::ConvexShape b{ proxy.size() };
+
+		for (size_t i = 0; i < proxy.size(); i++)
+		{
+			a.setPoint(i, proxy[i]);
+			b.setPoint(i, proxy[i]);
+		}
+
+		b.setPosition({ RADIUS, 0.f });
+		b.setRotation(7.f);
+
+		Engine::CollisionHull hullA{ &a };
+		Engine::CollisionHull hullB{ &b };
+
+		suite.Run("sat/lod_hull" + parameters + "/overlap50", [&]()
+		{
+			auto response = Engine::processCollision(hullA, hullB);
+			consume(response ? response->MinimumTransitionVector.x : 0.f);
+		});
+	}
+
+	/**
+	* @brief Swept SAT of a polygon moving onto another one from a distance of a diameter
+	*/
+	void benchTimeOfImpact(Suite& suite, size_t vertices)
+	{
+		const float RADIUS = 50.f;
+		sf::CircleShape a{ RADIUS, vertices };
+		sf::CircleShape b{ RADIUS, vertices };
+		a.setOrigin({ RADIUS, RADIUS });
+		b.setOrigin({ RADIUS, RADIUS });
+		b.setPosition({ 4.f * RADIUS, 0.f });
+		b.setRotation(7.f);
+
+		Engine::CollisionHull hullA{ &a };
+		Engine::CollisionHull hullB{ &b };
+
+		suite.Run("toi/hull/v" + std::to_string(vertices), [&]()
+		{
+			auto hit = Engine::sweptSeparatingAxisTest(hullA, hullB, { 8.f * RADIUS, RADIUS });
+			consume(hit ? hit->Time : 0.f);
+		});
+	}
+
+	void benchGeometry(Suite& suite, size_t vertices)
+	{
+		sf::CircleShape shape{ 50.f, vertices };
+		shape.setPosition({ 10.f, 20.f });
+		shape.setRotation(30.f);
+		std::vector<sf::Vector2f> shapeVertices = Engine::getVertices(&shape);
+		std::string parameters = "/v" + std::to_string(vertices);
+
+		suite.Run("geometry/get_vertices" + parameters, [&]()
+		{
+			consume(Engine::getVertices(&shape)[0].x);
+		});
+
+		suite.Run("geometry/shape_edges" + parameters, [&]()
+		{
+			consume(Engine::getShapeEdges(shapeVertices)[0].first.x);
+		});
+
+		suite.Run("geometry/centroid" + parameters, [&]()
+		{
+			consume(Engine::centroid(shapeVertices).x);
+		});
+
+		// a star with every other vertex pulled in, half of its corners are reflex
+		std::vector<sf::Vector2f> star = shapeVertices;
+		sf::Vector2f center = Engine::centroid(shapeVertices);
+
+		for (size_t i = 1; i < star.size(); i += 2)
+		{
+			star[i] = center + (star[i] - center) * 0.5f;
+		}
+
+		suite.Run("geometry/decompose" + parameters, [&]()
+		{
+			consume(static_cast<float>(Engine::decomposeConvex(star).size()));
+		});
+	}
+
+	/**
+	* @brief scatters boxes over a square world whose side grows with the count, so density stays the same
+	*/
+	std::vector<sf::FloatRect> makeBoxes(size_t count, std::mt19937& random)
+	{
+		const float WORLD_SIDE = 60.f * std::sqrt(static_cast<float>(count));
+		std::uniform_real_distribution<float> position(0.f, WORLD_SIDE);
+		std::uniform_real_distribution<float> size(10.f, 50.f);
+
+		std::vector<sf::FloatRect> boxes(count);
+
+		for (auto& box : boxes)
+		{
+			box = sf::FloatRect{ position(random), position(random), size(random), size(random) };
+		}
+
+		return boxes;
+	}
+
+	void benchBroadphase(Suite& suite, size_t count)
+	{
+		std::mt19937 random{ 42 };
+		std::vector<sf::FloatRect> boxes = makeBoxes(count, random);
+		std::string parameters = "/n" + std::to_string(count);
+
+		suite.Run("broadphase/build" + parameters, [&]()
+		{
+			Engine::DynamicAabbTree<size_t> tree;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				tree.CreateProxy(Engine::Aabb::FromRect(boxes[i]), i);
+			}
+
+			consume(static_cast<float>(tree.GetHeight()));
+		});
+
+		Engine::DynamicAabbTree<size_t> tree;
+		std::vector<int32_t> proxies(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			proxies[i] = tree.CreateProxy(Engine::Aabb::FromRect(boxes[i]), i);
+		}
+
+		std::vector<Engine::DynamicAabbTree<size_t>::ProxyPair> pairs;
+
+		suite.Run("broadphase/pairs" + parameters, [&]()
+		{
+			tree.QueryOverlappingPairs(pairs);
+			consume(static_cast<float>(pairs.size()));
+		});
+
+		// jitter inside the fattened boxes with an occasional reinsertion, moved back and forth so the scene stays the same
+		float direction = 1.f;
+
+		suite.Run("broadphase/move" + parameters, [&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				sf::Vector2f displacement{ direction, -direction };
+				boxes[i].left += displacement.x;
+				boxes[i].top += displacement.y;
+				tree.MoveProxy(proxies[i], Engine::Aabb::FromRect(boxes[i]), displacement);
+			}
+
+			direction = -direction;
+		});
+	}
+
+	/**
+	* @brief Queries of every box against the incremental tree and against the baked static BVH of the same boxes
+	*/
+	void benchStaticQueries(Suite& suite, size_t count)
+	{
+		std::mt19937 random{ 42 };
+		std::vector<sf::FloatRect> boxes = makeBoxes(count, random);
+		std::string parameters = "/n" + std::to_string(count);
+
+		Engine::DynamicAabbTree<size_t> tree;
+		std::vector<Engine::StaticBvh<size_t>::Item> items;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			tree.CreateProxy(Engine::Aabb::FromRect(boxes[i]), i);
+			items.push_back({ Engine::Aabb::FromRect(boxes[i]), i });
+		}
+
+		Engine::StaticBvh<size_t> bvh;
+		bvh.Build(items);
+
+		suite.Run("broadphase/query_tree" + parameters, [&]()
+		{
+			size_t hits = 0;
+
+			for (const auto& box : boxes)
+			{
+				tree.Query(Engine::Aabb::FromRect(box), [&](int32_t) { hits++; return true; });
+			}
+
+			consume(static_cast<float>(hits));
+		});
+
+		suite.Run("broadphase/query_static" + parameters, [&]()
+		{
+			size_t hits = 0;
+
+			for (const auto& box : boxes)
+			{
+				bvh.Query(Engine::Aabb::FromRect(box), [&](size_t) { hits++; return true; });
+			}
+
+			consume(static_cast<float>(hits));
+		});
+
+		suite.Run("broadphase/bake_static" + parameters, [&]()
+		{
+			bvh.Build(items);
+			consume(static_cast<float>(bvh.GetNodeCount()));
+		});
+	}
+
+	/**
+	* @brief Rays through a map of rotated walls with some balls, cast one by one and as one batch
+	*/
+	void benchRaycasts(Suite& suite, size_t rayCount)
+	{
+		std::mt19937 random{ 42 };
+		std::uniform_real_distribution<float> position(0.f, 2000.f);
+		std::uniform_real_distribution<float> angle(0.f, 360.f);
+		std::vector<sf::RectangleShape> walls(1000, sf::RectangleShape{ { 60.f, 10.f } });
+		std::vector<sf::CircleShape> balls(200, sf::CircleShape{ 10.f, 12 });
+
+		Engine::World world;
+
+		for (auto& wall : walls)
+		{
+			wall.setPosition({ position(random), position(random) });
+			wall.setRotation(angle(random));
+			world.CreateStaticGeometry(&wall);
+		}
+
+		for (auto& ball : balls)
+		{
+			ball.setPosition({ position(random), position(random) });
+			world.CreateDynamicBody(&ball);
+		}
+
+		world.BakeStaticGeometry();
+
+		// rays of up to 300 pixels, like lines of sight
+		std::uniform_real_distribution<float> translation(-300.f, 300.f);
+		std::vector<Engine::Ray> rays(rayCount);
+
+		for (auto& ray : rays)
+		{
+			ray = Engine::Ray{ { position(random), position(random) }, { translation(random), translation(random) } };
+		}
+
+		std::vector<Engine::RayHit> hits(rayCount);
+		std::string parameters = "/n" + std::to_string(rayCount);
+
+		suite.Run("query/raycast_single" + parameters, [&]()
+		{
+			size_t hitCount = 0;
+
+			for (const auto& ray : rays)
+			{
+				hitCount += world.Raycast(ray).has_value();
+			}
+
+			consume(static_cast<float>(hitCount));
+		});
+
+		suite.Run("query/raycast_batch" + parameters, [&]()
+		{
+			world.Raycast(rays, hits);
+			consume(hits.back().Fraction);
+		});
+	}
+
+	/**
+	* @brief World steps of boxes stacked in columns on a floor, the scene settles after the first steps
+	*/
+	void benchFrame(Suite& suite, size_t bodies)
+	{
+		const size_t COLUMNS = 32;
+		sf::RectangleShape floor{ sf::Vector2f{ COLUMNS * 25.f + 100.f, 20.f } };
+		floor.setPosition({ -50.f, 0.f });
+		std::vector<sf::RectangleShape> boxes;
+		boxes.reserve(bodies);
+
+		Engine::World world;
+		world.CreateStaticGeometry(&floor);
+
+		for (size_t i = 0; i < bodies; i++)
+		{
+			boxes.emplace_back(sf::Vector2f{ 20.f, 20.f });
+			boxes.back().setPosition({ 25.f * (i % COLUMNS), -21.f * (i / COLUMNS + 1) });
+			world.CreateDynamicBody(&boxes.back());
+		}
+
+		suite.Run("frame/pile/n" + std::to_string(bodies), [&]()
+		{
+			world.Step(world.GetTimeStep());
+			consume(static_cast<float>(world.GetContacts().size()));
+		});
+	}
+
+	/**
+	* @brief Tile map of a hilly terrain with floating platforms: merging the whole map, and
+	* rebuilding the chunk of an edited tile with the static BVH it invalidates
+	*/
+	void benchTiles(Suite& suite, uint32_t side)
+	{
+		std::mt19937 random{ 42 };
+		std::uniform_int_distribution<int> slope(-1, 1);
+		std::vector<uint8_t> tiles(static_cast<size_t>(side) * side, 0);
+		uint32_t ground = side / 2;
+
+		for (uint32_t x = 0; x < side; x++)
+		{
+			ground = std::clamp<uint32_t>(ground + slope(random), side / 4, side - 1);
+
+			for (uint32_t y = ground; y < side; y++)
+			{
+				tiles[static_cast<size_t>(y) * side + x] = 1;
+			}
+
+			if (x % 12 < 5)
+			{
+				tiles[static_cast<size_t>(side / 8 + x % 7) * side + x] = 1;
+			}
+		}
+
+		std::string parameters = "/side" + std::to_string(side);
+
+		suite.Run("tiles/merge" + parameters, [&]()
+		{
+			consume(static_cast<float>(Engine::mergeTiles(tiles, side, Engine::TileRect{ 0, 0, side, side }).size()));
+		});
+
+		Engine::World world;
+		Engine::TileLayer layer{ world, side, side, { 16.f, 16.f } };
+
+		for (uint32_t y = 0; y < side; y++)
+		{
+			for (uint32_t x = 0; x < side; x++)
+			{
+				layer.SetSolid(x, y, tiles[static_cast<size_t>(y) * side + x] != 0);
+			}
+		}
+
+		layer.Rebuild();
+
+		suite.Run("tiles/rebuild_edit" + parameters, [&]()
+		{
+			layer.SetSolid(side / 2, side - 2, !layer.IsSolid(side / 2, side - 2));
+			consume(static_cast<float>(layer.Rebuild()));
+			world.BakeStaticGeometry();
+		});
+	}
+
+	/**
+	* @brief Loading a map of rotated platforms and L blocks: building it from shapes, which decomposes and
+	* transforms every part, against opening it as a mapped scene file and creating the bodies from the file
+	*/
+	void benchScene(Suite& suite, size_t count)
+	{
+		std::mt19937 random{ 42 };
+		std::uniform_real_distribution<float> jitter(-10.f, 10.f);
+		std::uniform_real_distribution<float> rotation(-30.f, 30.f);
+		const size_t SIDE = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+		std::vector<std::vector<sf::Vector2f>> polygons;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			sf::Vector2f position{ 60.f * (i % SIDE) + jitter(random), 60.f * (i / SIDE) + jitter(random) };
+
+			if (i % 10 == 0)
+			{
+				polygons.push_back({ position, position + sf::Vector2f{ 40.f, 0.f }, position + sf::Vector2f{ 40.f, 10.f },
+					position + sf::Vector2f{ 10.f, 10.f }, position + sf::Vector2f{ 10.f, 40.f }, position + sf::Vector2f{ 0.f, 40.f } });
+				continue;
+			}
+
+			sf::RectangleShape platform{ { 40.f, 8.f } };
+			platform.setPosition(position);
+			platform.setRotation(rotation(random));
+			polygons.push_back(Engine::getVertices(&platform));
+		}
+
+		std::string parameters = "/n" + std::to_string(count);
+		std::string path = (std::filesystem::temp_directory_path() / ("collision_bench_" + std::to_string(count) + ".scene")).string();
+
+		{
+			std::ofstream output{ path, std::ios::binary };
+			Engine::writeScene(output, polygons, 1024.f);
+		}
+
+		suite.Run("scene/build_shapes" + parameters, [&]()
+		{
+			Engine::World world;
+			std::vector<sf::ConvexShape> shapes;
+			shapes.reserve(polygons.size() * 2);
+
+			for (const auto& polygon : polygons)
+			{
+				for (const auto& piece : Engine::decomposeConvex(polygon))
+				{
+					sf::ConvexShape& shape = shapes.emplace_back(piece.size());
+
+					for (size_t i = 0; i < piece.size(); i++)
+					{
+						shape.setPoint(i, piece[i]);
+					}
+
+					world.CreateStaticGeometry(&shape);
+				}
+			}
+
+			world.BakeStaticGeometry();
+			consume(static_cast<float>(shapes.size()));
+		});
+
+		suite.Run("scene/open" + parameters, [&]()
+		{
+			Engine::SceneFile scene;
+			scene.Open(path);
+			consume(static_cast<float>(scene.GetHeader().ShapeCount));
+		});
+
+		suite.Run("scene/load_all" + parameters, [&]()
+		{
+			Engine::SceneFile scene;
+			Engine::World world;
+			scene.Open(path);
+
+			for (uint32_t shape = 0; shape < scene.GetHeader().ShapeCount; shape++)
+			{
+				world.CreateStaticGeometry(scene.GetPolygon(shape));
+			}
+
+			world.BakeStaticGeometry();
+			consume(static_cast<float>(scene.GetHeader().ShapeCount));
+		});
+
+		std::filesystem::remove(path);
+	}
+
+	void printUsage(const char* program)
+	{
+		std::printf("usage: %s [--filter text] [--out results.csv] [--baseline results.csv] [--threshold 0.1]\n"
+			"  results are written as CSV to stdout or to --out, progress goes to stderr\n"
+			"  with --baseline the results are compared and the exit code is 1 if any benchmark is slower than the threshold\n",
+			program);
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+		{
+			options.Filter = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--out") == 0 && hasValue)
+		{
+			options.OutputPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue)
+		{
+			options.BaselinePath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue)
+		{
+			options.Threshold = std::strtod(argv[++i], nullptr);
+		}
+		else
+		{
+			printUsage(argv[0]);
+			return std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0 ? 0 : 2;
+		}
+	}
+
+	std::map<std::string, double> baseline;
+
+	if (!options.BaselinePath.empty())
+	{
+		std::ifstream baselineFile{ options.BaselinePath };
+
+		if (!baselineFile)
+		{
+			std::fprintf(stderr, "can't open baseline %s\n", options.BaselinePath.c_str());
+			return 2;
+		}
+
+		baseline = readCsv(baselineFile);
+	}
+
+	Suite suite{ options.Filter };
+
+	for (size_t vertices : { 3, 4, 8, 16, 32, 64 })
+	{
+		benchCollision(suite, vertices, -0.1f, "apart");
+		benchCollision(suite, vertices, 0.1f, "overlap10");
+		benchCollision(suite, vertices, 0.5f, "overlap50");
+		benchCollision(suite, vertices, 0.9f, "overlap90");
+	}
+
+	for (size_t vertices : { 4, 16, 64 })
+	{
+		benchGeometry(suite, vertices);
+		benchTimeOfImpact(suite, vertices);
+		benchCollisionLod(suite, vertices);
+	}
+
+	for (size_t count : { 100, 1000, 10000 })
+	{
+		benchBroadphase(suite, count);
+		benchStaticQueries(suite, count);
+	}
+
+	benchRaycasts(suite, 10000);
+
+	for (uint32_t side : { 64, 256 })
+	{
+		benchTiles(suite, side);
+	}
+
+	for (size_t count : { 10000, 100000 })
+	{
+		benchScene(suite, count);
+	}
+
+	for (size_t bodies : { 64, 256, 1024 })
+	{
+		benchFrame(suite, bodies);
+	}
+
+	if (!options.OutputPath.empty())
+	{
+		std::ofstream output{ options.OutputPath };
+		writeCsv(output, suite.GetResults());
+	}
+	else if (options.BaselinePath.empty())
+	{
+		writeCsv(std::cout, suite.GetResults());
+	}
+
+	if (!options.BaselinePath.empty())
+	{
+		size_t regressions = compare(suite.GetResults(), baseline, options.Threshold);
+		std::printf("%zu regression(s) above %.0f%%\n", regressions, options.Threshold * 100.);
+		return regressions == 0 ? 0 : 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <SFML/Graphics/CircleShape.hpp>
+
+#include <math.hpp>
+#include <collision_hull.hpp>
+#include <gjk.hpp>
+
+namespace
+{
+	constexpr int ITERATIONS = 100000;
+
+	volatile float sink = 0.f;
+
+	/**
+	* @brief runs the function ITERATIONS times
+	* @returns average duration of a single run in nanoseconds
+	*/
+	template <typename Function>
+	double measure(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+			function();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+	}
+
+	void consume(const std::optional<Engine::CollisionResponse>& response)
+	{
+		sink = sink + (response ? response->MinimumTransitionVector.x : 1.f);
+	}
+} // namespace
+
+int main()
+{
+	std::printf("both shapes are regular polygons with the same vertex count, time per pair\n");
+	std::printf("%8s | %9s | %12s | %12s | %8s | %13s || %12s | %12s | %8s\n",
+		"vertices", "pair", "SAT ns", "GJK ns", "speedup", "cold GJK ns", "hull SAT ns", "hull GJK ns", "speedup");
+
+	for (size_t vertices : { 3, 4, 6, 8, 12, 16, 24, 32, 48, 64 })
+	{
+		// colliding pair needs EPA, separated pair has overlapping bounds but a gap between the shapes
+		for (float distance : { 30.f, 95.f })
+		{
+			sf::CircleShape a{ 50.f, vertices };
+			sf::CircleShape b{ 50.f, vertices };
+			b.setPosition({ distance, distance });
+			b.setRotation(7.f);
+
+			std::vector<sf::Vector2f> verticesA = Engine::getVertices(&a);
+			std::vector<sf::Vector2f> verticesB = Engine::getVertices(&b);
+			Engine::CollisionHull hullA{ &a };
+			Engine::CollisionHull hullB{ &b };
+			Engine::CollisionScratch scratch;
+			Engine::GjkCache cache;
+
+			bool isColliding = Engine::processCollision(verticesA, verticesB, scratch).has_value();
+
+			double satTime = measure([&]()
+			{
+				consume(Engine::processCollision(verticesA, verticesB, scratch));
+			});
+
+			double gjkTime = measure([&]()
+			{
+				consume(Engine::gjkCollision(verticesA, verticesB, cache));
+			});
+
+			// no start vertices and direction from the previous query
+			double coldGjkTime = measure([&]()
+			{
+				Engine::GjkCache coldCache;
+				coldCache.Polytope.swap(cache.Polytope);
+				consume(Engine::gjkCollision(verticesA, verticesB, coldCache));
+				coldCache.Polytope.swap(cache.Polytope);
+			});
+
+			double hullSatTime = measure([&]()
+			{
+				consume(Engine::processCollision(hullA, hullB));
+			});
+
+			double hullGjkTime = measure([&]()
+			{
+				consume(Engine::gjkCollision(hullA, hullB, cache));
+			});
+
+			std::printf("%8zu | %9s | %12.1f | %12.1f | %7.2fx | %13.1f || %12.1f | %12.1f | %7.2fx\n",
+				vertices, isColliding ? "colliding" : "separated",
+				satTime, gjkTime, satTime / gjkTime, coldGjkTime,
+				hullSatTime, hullGjkTime, hullSatTime / hullGjkTime);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
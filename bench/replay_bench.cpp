@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <world.hpp>
+#include <replay.hpp>
+
+#include "../src/demo_scene.hpp"
+
+#ifdef ENGINE_PROFILING
+#include <iostream>
+#include <profiler.hpp>
+#endif
+
+namespace
+{
+	struct FrameTiming
+	{
+		float FrameTime;
+		uint64_t Steps;
+		double Microseconds;
+	};
+
+	double percentile(std::vector<double> values, double fraction)
+	{
+		std::sort(values.begin(), values.end());
+		return values[std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()))];
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0)
+	{
+		std::printf("usage: %s session.rpl [--out frames.csv] [--workers 1]\n"
+			"  runs a session recorded by the demo with --record as fast as possible, without a window\n"
+			"  --out writes the time of every frame as CSV, e.g. to compare two builds frame by frame\n", argv[0]);
+		return argc < 2 ? 1 : 0;
+	}
+
+	const char* outputPath = nullptr;
+	size_t workers = 1;
+
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		if (std::strcmp(argv[i], "--out") == 0)
+		{
+			outputPath = argv[i + 1];
+		}
+		else if (std::strcmp(argv[i], "--workers") == 0)
+		{
+			workers = std::strtoull(argv[i + 1], nullptr, 10);
+		}
+	}
+
+	std::ifstream recordingFile{ argv[1], std::ios::binary };
+	Engine::ReplayReader reader{ recordingFile };
+
+	if (!reader.IsValid())
+	{
+		std::fprintf(stderr, "%s is not a recording\n", argv[1]);
+		return 2;
+	}
+
+	DemoScene scene{ workers };
+	Engine::World& world = scene.GetWorld();
+	Engine::ReplayFrame frame;
+	std::vector<FrameTiming> timings;
+	size_t snapshots = 0;
+	float maxDifference = 0.f;
+	size_t firstDivergentFrame = std::numeric_limits<size_t>::max();
+
+#ifdef ENGINE_PROFILING
+	// one JSON line per 120 frames, like the demo
+	Engine::Profiler::Get().Reset();
+	Engine::ProfileReporter profileReporter{ std::cout, 120 };
+#endif
+
+	while (reader.ReadFrame(frame))
+	{
+		uint64_t stepsBefore = world.GetStepCount();
+		auto start = std::chrono::steady_clock::now();
+		scene.Update(frame.Events, frame.FrameTime);
+		auto end = std::chrono::steady_clock::now();
+
+		timings.push_back(FrameTiming{ frame.FrameTime, world.GetStepCount() - stepsBefore, std::chrono::duration<double, std::micro>(end - start).count() });
+
+#ifdef ENGINE_PROFILING
+		profileReporter.EndFrame();
+#endif
+
+		// the replay has to follow the session, or its timings are of a different simulation
+		if (frame.Snapshot)
+		{
+			float difference = Engine::snapshotDifference(world.CaptureSnapshot(), *frame.Snapshot);
+			snapshots++;
+			maxDifference = std::max(maxDifference, difference);
+
+			if (difference > 0.f && firstDivergentFrame == std::numeric_limits<size_t>::max())
+			{
+				firstDivergentFrame = timings.size() - 1;
+			}
+		}
+	}
+
+	if (timings.empty())
+	{
+		std::fprintf(stderr, "%s has no frames\n", argv[1]);
+		return 2;
+	}
+
+	if (outputPath != nullptr)
+	{
+		std::ofstream output{ outputPath };
+		output << "frame,frame_time_ms,steps,update_us\n";
+
+		for (size_t i = 0; i < timings.size(); i++)
+		{
+			output << i << ',' << timings[i].FrameTime * 1000.f << ',' << timings[i].Steps << ',' << timings[i].Microseconds << '\n';
+		}
+	}
+
+	std::vector<double> microseconds;
+	double totalMicroseconds = 0.;
+	double sessionSeconds = 0.;
+	uint64_t totalSteps = 0;
+	size_t slowestFrame = 0;
+
+	for (size_t i = 0; i < timings.size(); i++)
+	{
+		microseconds.push_back(timings[i].Microseconds);
+		totalMicroseconds += timings[i].Microseconds;
+		sessionSeconds += timings[i].FrameTime;
+		totalSteps += timings[i].Steps;
+		slowestFrame = timings[i].Microseconds > timings[slowestFrame].Microseconds ? i : slowestFrame;
+	}
+
+	std::printf("frames: %zu, steps: %llu, session: %.1f s, replayed in %.3f s\n",
+		timings.size(), static_cast<unsigned long long>(totalSteps), sessionSeconds, totalMicroseconds / 1e6);
+	std::printf("us/frame: mean %.1f, p50 %.1f, p99 %.1f, max %.1f at frame %zu (%llu steps)\n",
+		totalMicroseconds / timings.size(), percentile(microseconds, 0.5), percentile(microseconds, 0.99),
+		timings[slowestFrame].Microseconds, slowestFrame, static_cast<unsigned long long>(timings[slowestFrame].Steps));
+
+	if (firstDivergentFrame == std::numeric_limits<size_t>::max())
+	{
+		std::printf("snapshots: %zu, all match the session\n", snapshots);
+		return 0;
+	}
+
+	std::printf("snapshots: %zu, the replay diverges at frame %zu by up to %g\n", snapshots, firstDivergentFrame, maxDifference);
+	return 3;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <SFML/Graphics/CircleShape.hpp>
+
+#include <math.hpp>
+#include <sat_simd.hpp>
+
+namespace
+{
+	constexpr int ITERATIONS = 200000;
+
+	volatile float sink = 0.f;
+
+	/**
+	* @brief runs the function ITERATIONS times
+	* @returns average duration of a single run in nanoseconds
+	*/
+	template <typename Function>
+	double measure(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+			function();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+	}
+
+	/**
+	* @brief projects the polygon onto every axis with the kernel
+	*/
+	template <typename Kernel>
+	double measureKernel(const Engine::SoaPolygon& polygon, const std::vector<sf::Vector2f>& axes, Kernel kernel)
+	{
+		return measure([&]()
+		{
+			for (const auto& axis : axes)
+			{
+				Engine::simd::ProjectionRange range = kernel(polygon.X.data(), polygon.Y.data(), polygon.size(), axis.x, axis.y);
+				sink = sink + range.Max - range.Min;
+			}
+		});
+	}
+} // namespace
+
+int main()
+{
+#if ENGINE_SIMD_AVX2
+	std::printf("widest kernel: AVX2\n");
+#elif ENGINE_SIMD_SSE2
+	std::printf("widest kernel: SSE2\n");
+#else
+	std::printf("widest kernel: scalar\n");
+#endif
+
+	std::printf("%8s | %14s | %14s | %8s || %14s | %14s | %14s\n",
+		"vertices", "SAT AoS ns", "SAT SoA ns", "speedup", "scalar ns/axes", "SSE2 ns/axes", "AVX2 ns/axes");
+
+	for (size_t vertices : { 4, 8, 32, 64 })
+	{
+		// two overlapping regular polygons, every axis has to be tested
+		sf::CircleShape a{ 50.f, vertices };
+		sf::CircleShape b{ 50.f, vertices };
+		b.setPosition({ 30.f, 10.f });
+		b.setRotation(7.f);
+
+		std::vector<sf::Vector2f> verticesA = Engine::getVertices(&a);
+		std::vector<sf::Vector2f> verticesB = Engine::getVertices(&b);
+		Engine::SoaPolygon soaA{ verticesA };
+		Engine::SoaPolygon soaB{ verticesB };
+		Engine::CollisionScratch scratch;
+
+		double aosTime = measure([&]()
+		{
+			sink = sink + Engine::processCollision(verticesA, verticesB, scratch)->MinimumTransitionVector.x;
+		});
+
+		double soaTime = measure([&]()
+		{
+			sink = sink + Engine::processCollision(soaA, soaB, scratch)->MinimumTransitionVector.x;
+		});
+
+		std::vector<sf::Vector2f> axes;
+
+		for (size_t i = 0; i < verticesA.size(); i++)
+		{
+			axes.push_back(Engine::normal(verticesA[(i + 1) % verticesA.size()] - verticesA[i]));
+		}
+
+		double scalarTime = measureKernel(soaA, axes, Engine::simd::projectScalar);
+		double sse2Time = 0.;
+		double avx2Time = 0.;
+#if ENGINE_SIMD_SSE2
+		sse2Time = measureKernel(soaA, axes, Engine::simd::projectSse2);
+#endif
+#if ENGINE_SIMD_AVX2
+		avx2Time = measureKernel(soaA, axes, Engine::simd::projectAvx2);
+#endif
+
+		std::printf("%8zu | %14.1f | %14.1f | %7.2fx || %14.1f | %8.1f (%4.2fx) | %8.1f (%4.2fx)\n",
+			vertices, aosTime, soaTime, aosTime / soaTime,
+			scalarTime,
+			sse2Time, sse2Time > 0. ? scalarTime / sse2Time : 0.,
+			avx2Time, avx2Time > 0. ? scalarTime / avx2Time : 0.);
+	}
+
+	return 0;
+}
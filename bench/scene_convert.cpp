@@ -0,0 +1,201 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <math.hpp>
+#include <scene_file.hpp>
+
+namespace
+{
+	/**
+	* @brief Reads a text scene, one part per line, # starts a comment:
+	* "rect x y width height [rotation]" places a rectangle like sf::RectangleShape at its position,
+	* "poly x y x y x y ..." is a polygon in world space
+	* @returns false if a line can't be read, with its number in errorLine
+	*/
+	bool readTextScene(std::istream& input, std::vector<std::vector<sf::Vector2f>>& polygons, size_t& errorLine)
+	{
+		std::string line;
+		errorLine = 0;
+
+		while (std::getline(input, line))
+		{
+			errorLine++;
+			std::istringstream fields{ line.substr(0, line.find('#')) };
+			std::string kind;
+
+			if (!(fields >> kind))
+			{
+				continue;
+			}
+
+			if (kind == "rect")
+			{
+				float x = 0.f;
+				float y = 0.f;
+				float width = 0.f;
+				float height = 0.f;
+				float rotation = 0.f;
+
+				if (!(fields >> x >> y >> width >> height))
+				{
+					return false;
+				}
+
+				fields >> rotation;
+				sf::RectangleShape rectangle{ { width, height } };
+				rectangle.setPosition({ x, y });
+				rectangle.setRotation(rotation);
+				polygons.push_back(Engine::getVertices(&rectangle));
+			}
+			else if (kind == "poly")
+			{
+				std::vector<sf::Vector2f> polygon;
+				sf::Vector2f vertex;
+
+				while (fields >> vertex.x >> vertex.y)
+				{
+					polygon.push_back(vertex);
+				}
+
+				if (polygon.size() < 3)
+				{
+					return false;
+				}
+
+				polygons.push_back(std::move(polygon));
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	* @brief A square map of rotated platforms and some concave blocks, for load benchmarks
+	*/
+	std::vector<std::vector<sf::Vector2f>> generateScene(size_t count)
+	{
+		std::mt19937 random{ 42 };
+		std::uniform_real_distribution<float> jitter(-10.f, 10.f);
+		std::uniform_real_distribution<float> rotation(-30.f, 30.f);
+		const size_t SIDE = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+		std::vector<std::vector<sf::Vector2f>> polygons;
+		polygons.reserve(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			sf::Vector2f position{ 60.f * (i % SIDE) + jitter(random), 60.f * (i / SIDE) + jitter(random) };
+
+			if (i % 10 == 0)
+			{
+				// an L
+				polygons.push_back({ position, position + sf::Vector2f{ 40.f, 0.f }, position + sf::Vector2f{ 40.f, 10.f },
+					position + sf::Vector2f{ 10.f, 10.f }, position + sf::Vector2f{ 10.f, 40.f }, position + sf::Vector2f{ 0.f, 40.f } });
+				continue;
+			}
+
+			sf::RectangleShape platform{ { 40.f, 8.f } };
+			platform.setPosition(position);
+			platform.setRotation(rotation(random));
+			polygons.push_back(Engine::getVertices(&platform));
+		}
+
+		return polygons;
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	bool isGenerated = argc > 1 && std::strcmp(argv[1], "--generate") == 0;
+	int optionsBegin = isGenerated ? 4 : 3;
+
+	if (argc < optionsBegin || std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0)
+	{
+		std::printf("usage: %s input.txt output.scene [--chunk 1024]\n"
+			"       %s --generate parts output.scene [--chunk 1024]\n"
+			"  converts a text scene to the binary scene format, input lines are\n"
+			"  \"rect x y width height [rotation]\" and \"poly x y x y x y ...\"\n"
+			"  --generate writes a synthetic map of the given number of parts\n", argv[0], argv[0]);
+		return argc < optionsBegin ? 1 : 0;
+	}
+
+	const char* outputPath = argv[optionsBegin - 1];
+	float chunkSize = 1024.f;
+
+	for (int i = optionsBegin; i + 1 < argc; i += 2)
+	{
+		if (std::strcmp(argv[i], "--chunk") == 0)
+		{
+			chunkSize = std::strtof(argv[i + 1], nullptr);
+		}
+	}
+
+	if (chunkSize <= 0.f)
+	{
+		std::fprintf(stderr, "chunk size must be positive\n");
+		return 1;
+	}
+
+	std::vector<std::vector<sf::Vector2f>> polygons;
+
+	if (isGenerated)
+	{
+		polygons = generateScene(std::strtoull(argv[2], nullptr, 10));
+	}
+	else
+	{
+		std::ifstream input{ argv[1] };
+		size_t errorLine = 0;
+
+		if (!input)
+		{
+			std::fprintf(stderr, "can't open %s\n", argv[1]);
+			return 2;
+		}
+
+		if (!readTextScene(input, polygons, errorLine))
+		{
+			std::fprintf(stderr, "%s:%zu: can't read the part\n", argv[1], errorLine);
+			return 2;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::ofstream output{ outputPath, std::ios::binary };
+
+	if (!output)
+	{
+		std::fprintf(stderr, "can't write %s\n", outputPath);
+		return 2;
+	}
+
+	Engine::writeScene(output, polygons, chunkSize);
+	output.close();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	Engine::SceneFile scene;
+
+	if (!scene.Open(outputPath))
+	{
+		std::fprintf(stderr, "%s can't be read back\n", outputPath);
+		return 2;
+	}
+
+	const Engine::SceneHeader& header = scene.GetHeader();
+	std::printf("parts: %zu, convex shapes: %u, vertices: %u, chunks: %ux%u of %.0f px, tree nodes: %u, converted in %.3f s\n",
+		polygons.size(), header.ShapeCount, header.VertexCount, header.ChunksX, header.ChunksY, header.ChunkSize, header.NodeCount, seconds);
+	return 0;
+}
\ No newline at end of file
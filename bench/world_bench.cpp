@@ -0,0 +1,147 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <world.hpp>
+
+#ifdef ENGINE_PROFILING
+#include <iostream>
+#include <profiler.hpp>
+#endif
+
+namespace
+{
+	/**
+	* @brief Shapes of a test scene, the world keeps pointers to them
+	*/
+	struct Scene
+	{
+		std::vector<sf::RectangleShape> StaticParts;
+		std::vector<sf::RectangleShape> Bodies;
+	};
+
+	/**
+	* @brief boxes stacked in columns on a single floor
+	*/
+	Scene pileScene(size_t bodies)
+	{
+		Scene scene;
+		const size_t COLUMNS = 32;
+
+		scene.StaticParts.emplace_back(sf::Vector2f{ COLUMNS * 25.f + 100.f, 20.f });
+		scene.StaticParts.back().setPosition({ -50.f, 0.f });
+
+		for (size_t i = 0; i < bodies; i++)
+		{
+			scene.Bodies.emplace_back(sf::Vector2f{ 20.f, 20.f });
+			scene.Bodies.back().setPosition({ 25.f * (i % COLUMNS), -21.f * (i / COLUMNS + 1) });
+		}
+
+		return scene;
+	}
+
+	/**
+	* @brief boxes falling through a field of rotated platforms
+	*/
+	Scene rainScene(size_t bodies)
+	{
+		Scene scene;
+		const size_t COLUMNS = 64;
+		const size_t ROWS = 16;
+
+		for (size_t row = 0; row < ROWS; row++)
+		{
+			for (size_t column = 0; column < COLUMNS; column++)
+			{
+				scene.StaticParts.emplace_back(sf::Vector2f{ 40.f, 8.f });
+				scene.StaticParts.back().setPosition({ 60.f * column + 30.f * (row % 2), 80.f * row });
+				scene.StaticParts.back().setRotation(row % 2 == 0 ? 15.f : -15.f);
+			}
+		}
+
+		for (size_t i = 0; i < bodies; i++)
+		{
+			scene.Bodies.emplace_back(sf::Vector2f{ 6.f, 6.f });
+			scene.Bodies.back().setPosition({ 9.f * (i % 400), -9.f * (i / 400 + 1) });
+		}
+
+		return scene;
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0))
+	{
+		std::printf("usage: %s [pile|rain] [dynamic bodies] [steps] [workers]\n", argv[0]);
+		return 0;
+	}
+
+	const char* sceneName = argc > 1 ? argv[1] : "pile";
+	size_t bodies = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+	size_t steps = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000;
+	size_t workers = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+
+	Scene scene;
+
+	if (std::strcmp(sceneName, "pile") == 0)
+	{
+		scene = pileScene(bodies);
+	}
+	else if (std::strcmp(sceneName, "rain") == 0)
+	{
+		scene = rainScene(bodies);
+	}
+	else
+	{
+		std::fprintf(stderr, "unknown scene '%s'\n", sceneName);
+		return 1;
+	}
+
+	Engine::World world{ 1.f / 120.f, workers };
+
+	for (auto& part : scene.StaticParts)
+	{
+		world.CreateStaticGeometry(&part);
+	}
+
+	for (auto& body : scene.Bodies)
+	{
+		world.CreateDynamicBody(&body);
+	}
+
+	size_t contacts = 0;
+
+#ifdef ENGINE_PROFILING
+	// one JSON line per 100 steps
+	Engine::Profiler::Get().Reset();
+	Engine::ProfileReporter profileReporter{ std::cout, 100 };
+#endif
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t step = 0; step < steps; step++)
+	{
+		world.Step(world.GetTimeStep());
+		contacts += world.GetContacts().size();
+
+#ifdef ENGINE_PROFILING
+		profileReporter.EndFrame();
+#endif
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	std::printf("scene: %s, static parts: %zu, dynamic bodies: %zu, workers: %zu\n",
+		sceneName, scene.StaticParts.size(), scene.Bodies.size(), workers);
+	std::printf("steps: %zu in %.3f s, %.1f steps/s, %.1f us/step, %.1f contacts/step\n",
+		steps, seconds, steps / seconds, seconds * 1e6 / steps, static_cast<double>(contacts) / steps);
+	std::printf("sleeping bodies after the last step: %zu\n", world.GetSleepingBodyCount());
+
+	return 0;
+}
\ No newline at end of file
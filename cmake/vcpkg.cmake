@@ -0,0 +1,6 @@
+# Included before project(): packages come from vcpkg when VCPKG_ROOT is set,
+# otherwise from the system (e.g. libsfml-dev and catch2 on Linux) or CMAKE_PREFIX_PATH
+if(DEFINED ENV{VCPKG_ROOT} AND NOT DEFINED CMAKE_TOOLCHAIN_FILE)
+	file(TO_CMAKE_PATH "$ENV{VCPKG_ROOT}" vcpkgRoot)
+	set(CMAKE_TOOLCHAIN_FILE "${vcpkgRoot}/scripts/buildsystems/vcpkg.cmake" CACHE FILEPATH "vcpkg toolchain")
+endif()
\ No newline at end of file
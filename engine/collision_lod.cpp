@@ -0,0 +1,78 @@
+#include <collision_lod.hpp>
+
+namespace Engine
+{
+	namespace detail
+	{
+		float distanceToLine(const sf::Vector2f& point, const sf::Vector2f& a, const sf::Vector2f& b)
+		{
+			sf::Vector2f line = b - a;
+			float length = std::sqrt(dot(line, line));
+			return length > 0.f ? std::abs(cross(line, point - a)) / length : std::sqrt(dot(point - a, point - a));
+		}
+	} // namespace detail
+
+	SimplifiedPolygon simplifyConvexPolygon(std::span<const sf::Vector2f> polygon, const CollisionLod& lod)
+	{
+		const size_t MAX_VERTICES = std::max<size_t>(lod.MaxVertices, 3);
+		std::vector<size_t> kept(polygon.size());
+
+		for (size_t i = 0; i < polygon.size(); i++)
+		{
+			kept[i] = i;
+		}
+
+		// farthest original vertex between two kept ones from the chord joining them
+		auto chordDeviation = [&](size_t first, size_t last)
+		{
+			float deviation = 0.f;
+
+			for (size_t i = (first + 1) % polygon.size(); i != last; i = (i + 1) % polygon.size())
+			{
+				deviation = std::max(deviation, detail::distanceToLine(polygon[i], polygon[first], polygon[last]));
+			}
+
+			return deviation;
+		};
+
+		auto removalDeviation = [&](size_t position)
+		{
+			return chordDeviation(kept[(position + kept.size() - 1) % kept.size()], kept[(position + 1) % kept.size()]);
+		};
+
+		while (kept.size() > 3)
+		{
+			size_t cheapest = 0;
+			float cheapestDeviation = std::numeric_limits<float>::infinity();
+
+			for (size_t position = 0; position < kept.size(); position++)
+			{
+				float deviation = removalDeviation(position);
+
+				if (deviation < cheapestDeviation)
+				{
+					cheapest = position;
+					cheapestDeviation = deviation;
+				}
+			}
+
+			if (kept.size() <= MAX_VERTICES && cheapestDeviation > lod.Tolerance)
+			{
+				break;
+			}
+
+			kept.erase(kept.begin() + cheapest);
+		}
+
+		SimplifiedPolygon simplified;
+		simplified.Vertices.reserve(kept.size());
+
+		for (size_t position = 0; position < kept.size(); position++)
+		{
+			simplified.Vertices.push_back(polygon[kept[position]]);
+			simplified.MaxDeviation = std::max(simplified.MaxDeviation, chordDeviation(kept[position], kept[(position + 1) % kept.size()]));
+		}
+
+		return simplified;
+	}
+} // namespace Engine
\ No newline at end of file
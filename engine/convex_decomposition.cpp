@@ -0,0 +1,172 @@
+#include <convex_decomposition.hpp>
+
+namespace Engine
+{
+	namespace detail
+	{
+		/**
+		* @brief Ear clipping: cuts off convex corners that hold no other vertex until a triangle is left
+		* @returns triangles as indices into the points, in the winding of the polygon
+		*/
+		std::vector<std::vector<size_t>> triangulate(std::span<const sf::Vector2f> points, float winding)
+		{
+			std::vector<std::vector<size_t>> triangles;
+			std::vector<size_t> remaining(points.size());
+
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				remaining[i] = i;
+			}
+
+			while (remaining.size() > 3)
+			{
+				size_t ear = remaining.size();
+
+				for (size_t i = 0; i < remaining.size() && ear == remaining.size(); i++)
+				{
+					size_t previous = remaining[(i + remaining.size() - 1) % remaining.size()];
+					size_t next = remaining[(i + 1) % remaining.size()];
+
+					if (turn(points[previous], points[remaining[i]], points[next], winding) <= 0.f)
+					{
+						continue;
+					}
+
+					bool isEar = true;
+
+					for (size_t other : remaining)
+					{
+						if (other != previous && other != remaining[i] && other != next
+							&& isInTriangle(points[other], points[previous], points[remaining[i]], points[next], winding))
+						{
+							isEar = false;
+							break;
+						}
+					}
+
+					if (isEar)
+					{
+						ear = i;
+					}
+				}
+
+				auto corner = [&](size_t i)
+				{
+					return turn(points[remaining[(i + remaining.size() - 1) % remaining.size()]], points[remaining[i]], points[remaining[(i + 1) % remaining.size()]], winding);
+				};
+
+				// only collinear or touching corners are left, the flattest one is cut off
+				if (ear == remaining.size())
+				{
+					ear = 0;
+
+					for (size_t i = 1; i < remaining.size(); i++)
+					{
+						ear = std::abs(corner(i)) < std::abs(corner(ear)) ? i : ear;
+					}
+				}
+
+				// a flat corner leaves no triangle
+				if (corner(ear) > 0.f)
+				{
+					triangles.push_back({ remaining[(ear + remaining.size() - 1) % remaining.size()], remaining[ear], remaining[(ear + 1) % remaining.size()] });
+				}
+
+				remaining.erase(remaining.begin() + ear);
+			}
+
+			if (turn(points[remaining[0]], points[remaining[1]], points[remaining[2]], winding) > 0.f)
+			{
+				triangles.push_back(remaining);
+			}
+
+			return triangles;
+		}
+
+		/**
+		* @brief Joins two polygons sharing the edge first[edge] -> first[edge + 1], which runs the other way in the second one
+		*/
+		std::vector<size_t> joinPolygons(const std::vector<size_t>& first, size_t edge, const std::vector<size_t>& second, size_t secondEdge)
+		{
+			std::vector<size_t> joined;
+			joined.reserve(first.size() + second.size() - 2);
+
+			// the first polygon from the end of the shared edge around to its start, then the rest of the second one
+			for (size_t i = 1; i <= first.size(); i++)
+			{
+				joined.push_back(first[(edge + i) % first.size()]);
+			}
+
+			for (size_t i = 2; i < second.size(); i++)
+			{
+				joined.push_back(second[(secondEdge + i) % second.size()]);
+			}
+
+			return joined;
+		}
+	} // namespace detail
+
+	std::vector<std::vector<sf::Vector2f>> decomposeConvex(std::span<const sf::Vector2f> polygon)
+	{
+		if (isConvex(polygon))
+		{
+			return { std::vector<sf::Vector2f>{ polygon.begin(), polygon.end() } };
+		}
+
+		std::vector<sf::Vector2f> vertices{ polygon.begin(), polygon.end() };
+		float winding = orientedArea(vertices) > 0.f ? 1.f : -1.f;
+		std::vector<std::vector<size_t>> pieces = detail::triangulate(polygon, winding);
+		bool hasMerged = true;
+
+		while (hasMerged)
+		{
+			hasMerged = false;
+
+			for (size_t i = 0; i < pieces.size() && !hasMerged; i++)
+			{
+				for (size_t j = i + 1; j < pieces.size() && !hasMerged; j++)
+				{
+					for (size_t edge = 0; edge < pieces[i].size() && !hasMerged; edge++)
+					{
+						size_t start = pieces[i][edge];
+						size_t end = pieces[i][(edge + 1) % pieces[i].size()];
+
+						for (size_t secondEdge = 0; secondEdge < pieces[j].size(); secondEdge++)
+						{
+							if (pieces[j][secondEdge] != end || pieces[j][(secondEdge + 1) % pieces[j].size()] != start)
+							{
+								continue;
+							}
+
+							std::vector<size_t> joined = detail::joinPolygons(pieces[i], edge, pieces[j], secondEdge);
+
+							if (detail::isConvex(polygon, joined, winding))
+							{
+								pieces[i] = std::move(joined);
+								pieces.erase(pieces.begin() + j);
+								hasMerged = true;
+							}
+
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		std::vector<std::vector<sf::Vector2f>> convexPieces;
+		convexPieces.reserve(pieces.size());
+
+		for (const auto& piece : pieces)
+		{
+			std::vector<sf::Vector2f>& convexPiece = convexPieces.emplace_back();
+
+			for (size_t index : piece)
+			{
+				convexPiece.push_back(polygon[index]);
+			}
+		}
+
+		return convexPieces;
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,26 @@
+// Every header once. Headers are included by several translation units of a program,
+// so a function defined in one without inline fails to link here rather than in a game
+#include <math.hpp>
+#include <projection.hpp>
+#include <collision_response.hpp>
+#include <aabb.hpp>
+#include <dynamic_aabb_tree.hpp>
+#include <static_bvh.hpp>
+#include <sat_simd.hpp>
+#include <collision_hull.hpp>
+#include <separating_axis_cache.hpp>
+#include <gjk.hpp>
+#include <colliders.hpp>
+#include <parallel_narrowphase.hpp>
+#include <contact_manifold.hpp>
+#include <time_of_impact.hpp>
+#include <convex_decomposition.hpp>
+#include <collision_lod.hpp>
+#include <tile_layer.hpp>
+#include <world_batch.hpp>
+#include <replay.hpp>
+#include <scene_file.hpp>
+#include <body_storage.hpp>
+#include <spatial_query.hpp>
+#include <world.hpp>
+#include <profiler.hpp>
\ No newline at end of file
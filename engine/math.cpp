@@ -0,0 +1,60 @@
+#include <math.hpp>
+
+namespace Engine
+{
+	std::vector<std::pair<sf::Vector2f, sf::Vector2f>> getShapeEdges(const std::vector<sf::Vector2f>& shapeVertices)
+	{
+		const size_t VERTICES = shapeVertices.size();
+		const size_t LAST = VERTICES - 1;
+		ENGINE_PROFILE_COUNT(Allocations, 1);
+		std::vector<std::pair<sf::Vector2f, sf::Vector2f>> edges(VERTICES);
+
+		for (size_t i = 1; i < VERTICES; i++)
+		{
+			edges[i - 1] = std::make_pair(shapeVertices[i - 1], shapeVertices[i]);
+		}
+
+		edges[LAST] = std::make_pair(shapeVertices[LAST], shapeVertices[0]);
+
+		return edges;
+	}
+
+	std::vector<sf::Vector2f> getVertices(const sf::Shape* shape)
+	{
+		ENGINE_PROFILE_SCOPE(Vertices);
+		ENGINE_PROFILE_COUNT(Allocations, 1);
+		size_t verticesAmount = shape->getPointCount();
+		std::vector<sf::Vector2f> verteces(verticesAmount);
+		sf::Transform transform = shape->getTransform();
+
+		for (size_t i = 0; i < verticesAmount; i++)
+		{
+			verteces[i] = transform.transformPoint(shape->getPoint(i));
+		}
+
+		return verteces;
+	}
+
+	bool isShapeConcave(sf::Shape* shape)
+	{
+		float previousRotateDirection = 0.f;
+		size_t verticesCount = shape->getPointCount();
+		std::vector<sf::Vector2f> vertices = getVertices(shape);
+
+		for (size_t i = 0; i < verticesCount; i++)
+		{
+			sf::Vector2f vectorPreviousVertex{ vertices[(i - 1 + verticesCount) % verticesCount] - vertices[i] };
+			sf::Vector2f vectorNextVertex{ vertices[(i + 1 + verticesCount) % verticesCount] - vertices[i] };
+			float currentRotateDirection = cross(vectorPreviousVertex, vectorNextVertex);
+
+			if (currentRotateDirection * previousRotateDirection < 0)
+			{
+				return true;
+			}
+
+			previousRotateDirection = currentRotateDirection;
+		}
+
+		return false;
+	}
+} // namespace Engine
\ No newline at end of file
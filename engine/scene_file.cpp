@@ -0,0 +1,175 @@
+#include <scene_file.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER size{};
+		HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+		CloseHandle(file);
+
+		if (mapping == nullptr)
+		{
+			return false;
+		}
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+
+		if (data == nullptr)
+		{
+			return false;
+		}
+
+		_data = static_cast<const uint8_t*>(data);
+		_size = static_cast<size_t>(size.QuadPart);
+#else
+		int file = open(path.c_str(), O_RDONLY);
+
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat status{};
+		void* data = fstat(file, &status) == 0 && status.st_size > 0
+			? mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+		close(file);
+
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+
+		_data = static_cast<const uint8_t*>(data);
+		_size = static_cast<size_t>(status.st_size);
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Close() noexcept
+	{
+		if (_data == nullptr)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		UnmapViewOfFile(_data);
+#else
+		munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+		_data = nullptr;
+		_size = 0;
+	}
+
+	void writeScene(std::ostream& stream, std::span<const std::vector<sf::Vector2f>> polygons, float chunkSize)
+	{
+		std::vector<std::vector<sf::Vector2f>> pieces;
+		SceneHeader header;
+		header.ChunkSize = chunkSize;
+		header.Bounds = Aabb{ { 0.f, 0.f }, { 0.f, 0.f } };
+
+		for (const auto& polygon : polygons)
+		{
+			for (auto& piece : decomposeConvex(polygon))
+			{
+				pieces.push_back(std::move(piece));
+			}
+		}
+
+		std::vector<Aabb> bounds(pieces.size());
+
+		for (size_t i = 0; i < pieces.size(); i++)
+		{
+			bounds[i] = Aabb{ pieces[i][0], pieces[i][0] };
+
+			for (const sf::Vector2f& vertex : pieces[i])
+			{
+				bounds[i] = Aabb::Union(bounds[i], Aabb{ vertex, vertex });
+			}
+
+			header.Bounds = i == 0 ? bounds[i] : Aabb::Union(header.Bounds, bounds[i]);
+		}
+
+		sf::Vector2f extent = header.Bounds.Upper - header.Bounds.Lower;
+		header.ChunksX = std::max(1u, static_cast<uint32_t>(std::ceil(extent.x / chunkSize)));
+		header.ChunksY = std::max(1u, static_cast<uint32_t>(std::ceil(extent.y / chunkSize)));
+
+		std::vector<std::vector<StaticBvh<uint32_t>::Item>> chunkItems(static_cast<size_t>(header.ChunksX) * header.ChunksY);
+
+		for (uint32_t i = 0; i < pieces.size(); i++)
+		{
+			sf::Vector2f cell = (bounds[i].Center() - header.Bounds.Lower) / chunkSize;
+			uint32_t x = std::min(header.ChunksX - 1, static_cast<uint32_t>(std::max(0.f, cell.x)));
+			uint32_t y = std::min(header.ChunksY - 1, static_cast<uint32_t>(std::max(0.f, cell.y)));
+			chunkItems[static_cast<size_t>(y) * header.ChunksX + x].push_back({ bounds[i], i });
+		}
+
+		std::vector<SceneChunk> chunks(chunkItems.size());
+		std::vector<SceneShape> shapes;
+		std::vector<SceneNode> nodes;
+		std::vector<sf::Vector2f> vertices;
+		StaticBvh<uint32_t> bvh;
+
+		for (size_t chunk = 0; chunk < chunkItems.size(); chunk++)
+		{
+			SceneChunk& sceneChunk = chunks[chunk];
+			sceneChunk.Bounds = Aabb{ { 1.f, 1.f }, { 0.f, 0.f } };
+			sceneChunk.ShapeBegin = static_cast<uint32_t>(shapes.size());
+			sceneChunk.ShapeCount = static_cast<uint32_t>(chunkItems[chunk].size());
+			sceneChunk.NodeBegin = static_cast<uint32_t>(nodes.size());
+
+			if (chunkItems[chunk].empty())
+			{
+				continue;
+			}
+
+			bvh.Build(std::move(chunkItems[chunk]));
+			nodes.insert(nodes.end(), bvh.GetNodes().begin(), bvh.GetNodes().end());
+			sceneChunk.NodeCount = static_cast<uint32_t>(bvh.GetNodeCount());
+			sceneChunk.Bounds = bvh.GetNodes()[0].Bounds;
+
+			for (const auto& item : bvh.GetItems())
+			{
+				const auto& piece = pieces[item.UserData];
+				shapes.push_back(SceneShape{ item.Bounds, static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(piece.size()) });
+				vertices.insert(vertices.end(), piece.begin(), piece.end());
+			}
+		}
+
+		header.ShapeCount = static_cast<uint32_t>(shapes.size());
+		header.NodeCount = static_cast<uint32_t>(nodes.size());
+		header.VertexCount = static_cast<uint32_t>(vertices.size());
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(chunks.data()), static_cast<std::streamsize>(chunks.size() * sizeof(SceneChunk)));
+		stream.write(reinterpret_cast<const char*>(shapes.data()), static_cast<std::streamsize>(shapes.size() * sizeof(SceneShape)));
+		stream.write(reinterpret_cast<const char*>(nodes.data()), static_cast<std::streamsize>(nodes.size() * sizeof(SceneNode)));
+		stream.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size() * sizeof(sf::Vector2f)));
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include <tile_layer.hpp>
+
+namespace Engine
+{
+	std::vector<TileRect> mergeTiles(std::span<const uint8_t> solid, uint32_t width, const TileRect& region)
+	{
+		std::vector<TileRect> rectangles;
+		std::vector<uint8_t> isCovered(static_cast<size_t>(region.Width) * region.Height, 0);
+
+		auto isFree = [&](uint32_t x, uint32_t y)
+		{
+			return solid[static_cast<size_t>(y) * width + x] != 0
+				&& isCovered[static_cast<size_t>(y - region.Y) * region.Width + (x - region.X)] == 0;
+		};
+
+		for (uint32_t y = region.Y; y < region.Y + region.Height; y++)
+		{
+			for (uint32_t x = region.X; x < region.X + region.Width; x++)
+			{
+				if (!isFree(x, y))
+				{
+					continue;
+				}
+
+				TileRect rectangle{ x, y, 1, 1 };
+
+				while (rectangle.X + rectangle.Width < region.X + region.Width && isFree(rectangle.X + rectangle.Width, y))
+				{
+					rectangle.Width++;
+				}
+
+				for (uint32_t below = y + 1; below < region.Y + region.Height; below++)
+				{
+					bool isRunFree = true;
+
+					for (uint32_t runX = x; runX < x + rectangle.Width && isRunFree; runX++)
+					{
+						isRunFree = isFree(runX, below);
+					}
+
+					if (!isRunFree)
+					{
+						break;
+					}
+
+					rectangle.Height++;
+				}
+
+				for (uint32_t coveredY = y; coveredY < y + rectangle.Height; coveredY++)
+				{
+					std::fill_n(isCovered.begin() + static_cast<ptrdiff_t>((coveredY - region.Y) * region.Width + (x - region.X)), rectangle.Width, 1);
+				}
+
+				rectangles.push_back(rectangle);
+			}
+		}
+
+		return rectangles;
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Axis-aligned bounding box described by its lower (top-left) and upper (bottom-right) corners
+	*/
+	struct Aabb
+	{
+		sf::Vector2f Lower;
+		sf::Vector2f Upper;
+
+		/**
+		* @brief Creates a box from SFML rectangle (e.g. shape's global bounds)
+		* @param rect: rectangle with left, top, width and height
+		*/
+		static Aabb FromRect(const sf::FloatRect& rect)
+		{
+			return Aabb{ { rect.left, rect.top }, { rect.left + rect.width, rect.top + rect.height } };
+		}
+
+		/**
+		* @brief Creates the smallest box that contains both boxes
+		*/
+		static Aabb Union(const Aabb& a, const Aabb& b)
+		{
+			return Aabb{
+				{ std::min(a.Lower.x, b.Lower.x), std::min(a.Lower.y, b.Lower.y) },
+				{ std::max(a.Upper.x, b.Upper.x), std::max(a.Upper.y, b.Upper.y) }
+			};
+		}
+
+		bool Overlaps(const Aabb& other) const noexcept
+		{
+			return Lower.x <= other.Upper.x && other.Lower.x <= Upper.x
+				&& Lower.y <= other.Upper.y && other.Lower.y <= Upper.y;
+		}
+
+		/**
+		* @brief Checks if the other box lies completely inside this one
+		*/
+		bool Contains(const Aabb& other) const noexcept
+		{
+			return Lower.x <= other.Lower.x && Lower.y <= other.Lower.y
+				&& other.Upper.x <= Upper.x && other.Upper.y <= Upper.y;
+		}
+
+		sf::Vector2f Center() const noexcept
+		{
+			return (Lower + Upper) / 2.f;
+		}
+
+		/**
+		* @brief Perimeter is used as the insertion cost (2D analogue of surface area heuristic)
+		*/
+		float Perimeter() const noexcept
+		{
+			return 2.f * ((Upper.x - Lower.x) + (Upper.y - Lower.y));
+		}
+
+		/**
+		* @brief Returns the box grown by margin on every side
+		*/
+		Aabb Fattened(float margin) const noexcept
+		{
+			return Aabb{ { Lower.x - margin, Lower.y - margin }, { Upper.x + margin, Upper.y + margin } };
+		}
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,736 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Shape.hpp>
+
+#include <math.hpp>
+#include <aabb.hpp>
+#include <collision_hull.hpp>
+#include <collision_lod.hpp>
+#include <colliders.hpp>
+#include <convex_decomposition.hpp>
+#include <profiler.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Handle of a body: slot index in the low INDEX_BITS bits, generation of the slot in the rest.
+	* A handle of a destroyed body never matches the slot's next body
+	*/
+	using BodyId = uint32_t;
+
+	// handle no body ever gets, e.g. for a ray that hits nothing
+	inline constexpr BodyId INVALID_BODY = std::numeric_limits<BodyId>::max();
+
+	/**
+	* @brief Part of a shared pool owned by one body
+	*/
+	struct PoolRange
+	{
+		uint32_t Begin = 0;
+		uint32_t Count = 0;
+	};
+
+	/**
+	* @brief Convex part of a concave body, its ranges are relative to the ranges of the body
+	*/
+	struct BodyPiece
+	{
+		PoolRange Vertices;
+		PoolRange Axes;
+		sf::Vector2f LocalCentroid;
+		float Area = 0.f;
+	};
+
+	/**
+	* @brief Shape type the narrowphase can test with a routine written for it instead of SAT over the hull
+	*/
+	enum class ColliderKind : uint8_t
+	{
+		Polygon,
+		// sf::CircleShape that approximates its circle (see asRoundCircle), tested as a true circle
+		Circle,
+		// sf::RectangleShape, tested through its 2 axes
+		Box
+	};
+
+	/**
+	* @brief Bodies stored as parallel arrays (structure of arrays). Arrays are indexed by a dense index:
+	* static bodies take [0, GetStaticCount()), dynamic ones follow, so passes over one kind are linear.
+	* Vertices and axes of all bodies live in shared pools, local ones are transformed into world ones
+	* without touching the SFML shapes, which are only read on creation and sync.
+	* A concave shape is decomposed into convex pieces once per geometry read, the body's vertex and axis ranges
+	* hold the pieces one after another and the pieces are transformed with the body
+	*/
+	struct BodyStorage
+	{
+		static constexpr uint32_t INDEX_BITS = 20;
+		static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+		// generations wrap at the bits a handle has for them, so a slot can be reused forever
+		static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+		/**
+		* @brief Adds a body and reads its geometry and transform from the shape
+		* @param shape: simple polygon, kept for sync
+		* @returns handle of the body
+		*/
+		BodyId Create(sf::Shape* shape, bool isStatic)
+		{
+			return Create(shape, {}, shape->getPosition(), shape->getRotation(), shape->getOrigin(), shape->getScale(), isStatic);
+		}
+
+		/**
+		* @brief Adds a body without a shape at the origin, e.g. map geometry loaded from a file
+		* @param polygon: simple polygon in world space, read again when the geometry changes, must outlive the body
+		* @returns handle of the body
+		*/
+		BodyId Create(std::span<const sf::Vector2f> polygon, bool isStatic)
+		{
+			return Create(nullptr, polygon, {}, 0.f, {}, { 1.f, 1.f }, isStatic);
+		}
+
+		/**
+		* @brief Removes the body, its pool ranges are reused after the next compaction
+		*/
+		void Destroy(BodyId id)
+		{
+			uint32_t index = IndexOf(id);
+			uint32_t last = static_cast<uint32_t>(Handles.size() - 1);
+			_wastedVertices += VertexRanges[index].Count;
+			_wastedAxes += AxisRanges[index].Count;
+			_wastedPieces += PieceRanges[index].Count;
+
+			// the partition is kept: a static body is swapped with the last static one first
+			if (index < _staticCount)
+			{
+				Swap(index, _staticCount - 1);
+				index = _staticCount - 1;
+				_staticCount--;
+			}
+
+			Swap(index, last);
+			ForEachArray([](auto& array) { array.pop_back(); });
+
+			uint32_t slot = id & INDEX_MASK;
+			_slots[slot].Generation = (_slots[slot].Generation + 1) & GENERATION_MASK;
+
+			// the last generation of the last slot would give INVALID_BODY
+			if ((_slots[slot].Generation << INDEX_BITS | slot) == INVALID_BODY)
+			{
+				_slots[slot].Generation = 0;
+			}
+
+			_slots[slot].Index = INVALID_INDEX;
+			_freeSlots.push_back(slot);
+			CompactWastedPools();
+		}
+
+		bool IsValid(BodyId id) const noexcept
+		{
+			uint32_t slot = id & INDEX_MASK;
+			return slot < _slots.size() && _slots[slot].Index != INVALID_INDEX && _slots[slot].Generation == (id >> INDEX_BITS & GENERATION_MASK);
+		}
+
+		/**
+		* @returns dense index of a valid handle, it changes when other bodies are created or destroyed
+		*/
+		uint32_t IndexOf(BodyId id) const noexcept
+		{
+			return _slots[id & INDEX_MASK].Index;
+		}
+
+		size_t size() const noexcept
+		{
+			return Handles.size();
+		}
+
+		uint32_t GetStaticCount() const noexcept
+		{
+			return _staticCount;
+		}
+
+		/**
+		* @brief Reads the transform from the shape, the geometry too if origin, scale or point count have changed
+		* @returns false if the shape hasn't moved or the body has no shape
+		*/
+		bool ReadShape(uint32_t index)
+		{
+			const sf::Shape* shape = Shapes[index];
+
+			if (shape == nullptr)
+			{
+				return false;
+			}
+
+			if (shape->getOrigin() != Origins[index] || shape->getScale() != Scales[index] || shape->getPointCount() != PointCounts[index])
+			{
+				Origins[index] = shape->getOrigin();
+				Scales[index] = shape->getScale();
+				ReadGeometry(index);
+			}
+			else if (shape->getPosition() == Positions[index] && shape->getRotation() == Rotations[index])
+			{
+				return false;
+			}
+
+			Positions[index] = shape->getPosition();
+			Rotations[index] = shape->getRotation();
+			Transform(index);
+			return true;
+		}
+
+		/**
+		* @brief Sets the collision proxy of the body and reads its geometry again
+		* @param lod: std::nullopt tests the shape's own vertices
+		*/
+		void SetLod(uint32_t index, const std::optional<CollisionLod>& lod)
+		{
+			Lods[index] = lod;
+			ReadGeometry(index);
+			Transform(index);
+		}
+
+		/**
+		* @brief Writes position and rotation of the body to its shape, if it has one
+		*/
+		void WriteShape(uint32_t index) const
+		{
+			if (Shapes[index] != nullptr)
+			{
+				Shapes[index]->setPosition(Positions[index]);
+				Shapes[index]->setRotation(Rotations[index]);
+			}
+		}
+
+		/**
+		* @brief Computes world-space vertices, axes, centroid and bounds from position and rotation
+		* the same way sf::Transformable::getTransform does
+		*/
+		void Transform(uint32_t index)
+		{
+			ENGINE_PROFILE_SCOPE(HullUpdate);
+
+			float angle = -Rotations[index] * 3.141592654f / 180.f;
+			float cosine = std::cos(angle);
+			float sine = std::sin(angle);
+			const sf::Vector2f& position = Positions[index];
+
+			auto rotate = [cosine, sine](const sf::Vector2f& v)
+			{
+				return sf::Vector2f{ cosine * v.x + sine * v.y, -sine * v.x + cosine * v.y };
+			};
+
+			const PoolRange& vertices = VertexRanges[index];
+			Aabb bounds{ { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() }, { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() } };
+
+			for (uint32_t i = vertices.Begin; i < vertices.Begin + vertices.Count; i++)
+			{
+				sf::Vector2f vertex = rotate(LocalVertices[i]) + position;
+				Vertices[i] = vertex;
+				bounds = Aabb::Union(bounds, Aabb{ vertex, vertex });
+			}
+
+			const PoolRange& axes = AxisRanges[index];
+
+			for (uint32_t i = axes.Begin; i < axes.Begin + axes.Count; i++)
+			{
+				Axes[i] = rotate(LocalAxes[i]);
+			}
+
+			Centroids[index] = rotate(LocalCentroids[index]) + position;
+			Bounds[index] = bounds;
+
+			// a circle is tested as a circle, its arcs reach out of the polygon
+			if (ColliderKinds[index] == ColliderKind::Circle)
+			{
+				sf::Vector2f radius{ Radii[index], Radii[index] };
+				Bounds[index] = Aabb{ Centroids[index] - radius, Centroids[index] + radius };
+			}
+
+			const PoolRange& pieces = PieceRanges[index];
+
+			for (uint32_t i = pieces.Begin; i < pieces.Begin + pieces.Count; i++)
+			{
+				const PoolRange& pieceVertices = Pieces[i].Vertices;
+				const sf::Vector2f& first = Vertices[vertices.Begin + pieceVertices.Begin];
+				Aabb pieceBounds{ first, first };
+
+				for (uint32_t k = vertices.Begin + pieceVertices.Begin + 1; k < vertices.Begin + pieceVertices.Begin + pieceVertices.Count; k++)
+				{
+					pieceBounds = Aabb::Union(pieceBounds, Aabb{ Vertices[k], Vertices[k] });
+				}
+
+				PieceCentroids[i] = rotate(Pieces[i].LocalCentroid) + position;
+				PieceBounds[i] = pieceBounds;
+			}
+		}
+
+		/**
+		* @returns convex pieces of the body, 1 for a convex body
+		*/
+		uint32_t GetPieceCount(uint32_t index) const noexcept
+		{
+			return std::max(PieceRanges[index].Count, 1u);
+		}
+
+		/**
+		* @returns world-space collision data of a convex piece of the body, the body itself if it's convex
+		*/
+		HullView GetHull(uint32_t index, uint32_t piece) const noexcept
+		{
+			const PoolRange& pieces = PieceRanges[index];
+
+			if (pieces.Count == 0)
+			{
+				return GetHull(index);
+			}
+
+			const BodyPiece& bodyPiece = Pieces[pieces.Begin + piece];
+			const sf::Vector2f* vertices = Vertices.data() + VertexRanges[index].Begin + bodyPiece.Vertices.Begin;
+			const sf::Vector2f* axes = Axes.data() + AxisRanges[index].Begin + bodyPiece.Axes.Begin;
+
+			return HullView{
+				std::span<const sf::Vector2f>{ vertices, bodyPiece.Vertices.Count },
+				std::span<const sf::Vector2f>{ axes, bodyPiece.Axes.Count },
+				PieceCentroids[pieces.Begin + piece],
+				bodyPiece.Area
+			};
+		}
+
+		/**
+		* @returns world-space collider of a circle or box body, polygon bodies are tested through their hull
+		*/
+		Collider GetCollider(uint32_t index) const noexcept
+		{
+			if (ColliderKinds[index] == ColliderKind::Circle)
+			{
+				return Circle{ Centroids[index], Radii[index] };
+			}
+
+			const sf::Vector2f* vertices = Vertices.data() + VertexRanges[index].Begin;
+			return OrientedBox::FromVertices({ vertices[0], vertices[1], vertices[2], vertices[3] });
+		}
+
+		/**
+		* @returns tight world-space bounds of a convex piece of the body
+		*/
+		const Aabb& GetPieceBounds(uint32_t index, uint32_t piece) const noexcept
+		{
+			const PoolRange& pieces = PieceRanges[index];
+			return pieces.Count == 0 ? Bounds[index] : PieceBounds[pieces.Begin + piece];
+		}
+
+		/**
+		* @returns world-space collision data of a convex body, valid until the pools change.
+		* The vertices of a concave body are its pieces one after another
+		*/
+		HullView GetHull(uint32_t index) const noexcept
+		{
+			const PoolRange& vertices = VertexRanges[index];
+			const PoolRange& axes = AxisRanges[index];
+
+			return HullView{
+				std::span<const sf::Vector2f>{ Vertices.data() + vertices.Begin, vertices.Count },
+				std::span<const sf::Vector2f>{ Axes.data() + axes.Begin, axes.Count },
+				Centroids[index],
+				Areas[index]
+			};
+		}
+
+		// per body, by dense index
+		std::vector<BodyId> Handles;
+		// shapes are only read on creation and sync and written for rendering, nullptr for bodies made from a polygon
+		std::vector<sf::Shape*> Shapes;
+		// vertices of bodies without a shape
+		std::vector<std::span<const sf::Vector2f>> Polygons;
+		std::vector<sf::Vector2f> Positions;
+		// position before the last step, the start of render interpolation
+		std::vector<sf::Vector2f> PreviousPositions;
+		// degrees, like sf::Transformable
+		std::vector<float> Rotations;
+		std::vector<sf::Vector2f> Origins;
+		std::vector<sf::Vector2f> Scales;
+		std::vector<sf::Vector2f> Velocities;
+		// 0 for static bodies, dynamic bodies have unit mass
+		std::vector<float> InverseMasses;
+		// tight world-space bounds
+		std::vector<Aabb> Bounds;
+		std::vector<int32_t> Proxies;
+		std::vector<PoolRange> VertexRanges;
+		std::vector<PoolRange> AxisRanges;
+		// convex pieces of a concave body, empty for convex bodies
+		std::vector<PoolRange> PieceRanges;
+		// vertices of the shape, a concave body has more vertices in its pieces and a proxy fewer
+		std::vector<uint32_t> PointCounts;
+		// simplified collision proxy instead of the shape's vertices
+		std::vector<std::optional<CollisionLod>> Lods;
+		// farthest distance of the shape's boundary from its proxy
+		std::vector<float> Deviations;
+		std::vector<sf::Vector2f> LocalCentroids;
+		std::vector<sf::Vector2f> Centroids;
+		std::vector<float> Areas;
+		std::vector<ColliderKind> ColliderKinds;
+		// scaled radius of circle bodies
+		std::vector<float> Radii;
+		// time the body has been resting
+		std::vector<float> SleepTimes;
+		// key of the sleeping island the body belongs to
+		std::vector<BodyId> Islands;
+		std::vector<uint8_t> IsSleeping;
+		std::vector<uint8_t> IsFast;
+
+		// shared pools, local data has origin and scale applied
+		std::vector<sf::Vector2f> LocalVertices;
+		std::vector<sf::Vector2f> Vertices;
+		std::vector<sf::Vector2f> LocalAxes;
+		std::vector<sf::Vector2f> Axes;
+		std::vector<BodyPiece> Pieces;
+		std::vector<sf::Vector2f> PieceCentroids;
+		std::vector<Aabb> PieceBounds;
+
+	private:
+		BodyId Create(sf::Shape* shape, std::span<const sf::Vector2f> polygon, const sf::Vector2f& position, float rotation,
+			const sf::Vector2f& origin, const sf::Vector2f& scale, bool isStatic)
+		{
+			uint32_t slot = 0;
+
+			if (_freeSlots.empty())
+			{
+				slot = static_cast<uint32_t>(_slots.size());
+				_slots.push_back(Slot{});
+			}
+			else
+			{
+				slot = _freeSlots.back();
+				_freeSlots.pop_back();
+			}
+
+			BodyId id = _slots[slot].Generation << INDEX_BITS | slot;
+			uint32_t index = static_cast<uint32_t>(Handles.size());
+			_slots[slot].Index = index;
+
+			Handles.push_back(id);
+			Shapes.push_back(shape);
+			Polygons.push_back(polygon);
+			Positions.push_back(position);
+			PreviousPositions.push_back(position);
+			Rotations.push_back(rotation);
+			Origins.push_back(origin);
+			Scales.push_back(scale);
+			Velocities.push_back({});
+			InverseMasses.push_back(isStatic ? 0.f : 1.f);
+			Bounds.push_back({});
+			Proxies.push_back(-1);
+			VertexRanges.push_back({});
+			AxisRanges.push_back({});
+			PieceRanges.push_back({});
+			PointCounts.push_back(0);
+			Lods.push_back(std::nullopt);
+			Deviations.push_back(0.f);
+			LocalCentroids.push_back({});
+			Centroids.push_back({});
+			Areas.push_back(0.f);
+			ColliderKinds.push_back(ColliderKind::Polygon);
+			Radii.push_back(0.f);
+			SleepTimes.push_back(0.f);
+			Islands.push_back(0);
+			IsSleeping.push_back(0);
+			IsFast.push_back(0);
+
+			ReadGeometry(index);
+			Transform(index);
+
+			// the first dynamic body gives its place to the new static one
+			if (isStatic)
+			{
+				Swap(index, _staticCount);
+				_staticCount++;
+			}
+
+			return id;
+		}
+
+
+		struct Slot
+		{
+			uint32_t Index = 0;
+			uint32_t Generation = 0;
+		};
+
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		/**
+		* @brief Calls the function with every per-body array
+		*/
+		template <typename Function>
+		void ForEachArray(Function&& function)
+		{
+			function(Handles);
+			function(Shapes);
+			function(Polygons);
+			function(Positions);
+			function(PreviousPositions);
+			function(Rotations);
+			function(Origins);
+			function(Scales);
+			function(Velocities);
+			function(InverseMasses);
+			function(Bounds);
+			function(Proxies);
+			function(VertexRanges);
+			function(AxisRanges);
+			function(PieceRanges);
+			function(PointCounts);
+			function(Lods);
+			function(Deviations);
+			function(LocalCentroids);
+			function(Centroids);
+			function(Areas);
+			function(ColliderKinds);
+			function(Radii);
+			function(SleepTimes);
+			function(Islands);
+			function(IsSleeping);
+			function(IsFast);
+		}
+
+		void Swap(uint32_t first, uint32_t second)
+		{
+			if (first == second)
+			{
+				return;
+			}
+
+			ForEachArray([first, second](auto& array) { std::swap(array[first], array[second]); });
+			_slots[Handles[first] & INDEX_MASK].Index = first;
+			_slots[Handles[second] & INDEX_MASK].Index = second;
+		}
+
+		/**
+		* @brief Reads shape points into the pools and computes local axes, centroid and area.
+		* A concave shape is decomposed into convex pieces. A body keeps its vertex, axis and piece ranges
+		* while their counts stay the same, otherwise the pools are compacted once half of them is unused
+		*/
+		void ReadGeometry(uint32_t index)
+		{
+			ENGINE_PROFILE_SCOPE(HullUpdate);
+
+			const sf::Shape* shape = Shapes[index];
+			const sf::Vector2f& origin = Origins[index];
+			const sf::Vector2f& scale = Scales[index];
+			uint32_t pointCount = static_cast<uint32_t>(shape != nullptr ? shape->getPointCount() : Polygons[index].size());
+			std::vector<sf::Vector2f> points(pointCount);
+
+			for (uint32_t i = 0; i < pointCount; i++)
+			{
+				sf::Vector2f point = shape != nullptr ? shape->getPoint(i) : Polygons[index][i];
+				points[i] = sf::Vector2f{ (point.x - origin.x) * scale.x, (point.y - origin.y) * scale.y };
+			}
+
+			PointCounts[index] = pointCount;
+			Deviations[index] = 0.f;
+			ColliderKinds[index] = ColliderKind::Polygon;
+			Radii[index] = 0.f;
+
+			// a body with a proxy is tested through the proxy, a circle would ignore it
+			if (const sf::CircleShape* circle = shape != nullptr && !Lods[index] ? asRoundCircle(shape) : nullptr)
+			{
+				ColliderKinds[index] = ColliderKind::Circle;
+				Radii[index] = circle->getRadius() * std::abs(scale.x);
+			}
+			else if (dynamic_cast<const sf::RectangleShape*>(shape))
+			{
+				ColliderKinds[index] = ColliderKind::Box;
+			}
+
+			// concave shapes keep their pieces
+			if (Lods[index] && isConvex(points))
+			{
+				SimplifiedPolygon proxy = simplifyConvexPolygon(points, *Lods[index]);
+				points = std::move(proxy.Vertices);
+				Deviations[index] = proxy.MaxDeviation;
+			}
+
+			Areas[index] = orientedArea(points);
+			LocalCentroids[index] = centroid(points);
+
+			std::vector<std::vector<sf::Vector2f>> pieces;
+
+			if (isConvex(points))
+			{
+				pieces.push_back(std::move(points));
+			}
+			else
+			{
+				pieces = decomposeConvex(points);
+			}
+
+			uint32_t vertexCount = 0;
+
+			for (const auto& piece : pieces)
+			{
+				vertexCount += static_cast<uint32_t>(piece.size());
+			}
+
+			PoolRange& vertices = VertexRanges[index];
+
+			if (vertices.Count != vertexCount)
+			{
+				_wastedVertices += vertices.Count;
+				vertices = PoolRange{ static_cast<uint32_t>(LocalVertices.size()), vertexCount };
+				LocalVertices.resize(LocalVertices.size() + vertexCount);
+				Vertices.resize(LocalVertices.size());
+			}
+
+			// new axes are appended first, their count is known only afterwards
+			PoolRange axes{ static_cast<uint32_t>(LocalAxes.size()), 0 };
+			std::vector<BodyPiece> bodyPieces;
+			uint32_t pieceBegin = 0;
+
+			for (const auto& piece : pieces)
+			{
+				uint32_t pieceAxesBegin = axes.Count;
+				std::copy(piece.begin(), piece.end(), LocalVertices.begin() + vertices.Begin + pieceBegin);
+				axes.Count += AppendAxes(piece);
+
+				if (pieces.size() > 1)
+				{
+					uint32_t pieceSize = static_cast<uint32_t>(piece.size());
+					bodyPieces.push_back(BodyPiece{ { pieceBegin, pieceSize }, { pieceAxesBegin, axes.Count - pieceAxesBegin }, centroid(piece), orientedArea(piece) });
+				}
+
+				pieceBegin += static_cast<uint32_t>(piece.size());
+			}
+
+			PoolRange& oldAxes = AxisRanges[index];
+
+			if (oldAxes.Count == axes.Count)
+			{
+				std::copy(LocalAxes.begin() + axes.Begin, LocalAxes.end(), LocalAxes.begin() + oldAxes.Begin);
+				LocalAxes.resize(axes.Begin);
+			}
+			else
+			{
+				_wastedAxes += oldAxes.Count;
+				oldAxes = axes;
+			}
+
+			PoolRange& oldPieces = PieceRanges[index];
+
+			if (oldPieces.Count != bodyPieces.size())
+			{
+				_wastedPieces += oldPieces.Count;
+				oldPieces = PoolRange{ static_cast<uint32_t>(Pieces.size()), static_cast<uint32_t>(bodyPieces.size()) };
+				Pieces.resize(Pieces.size() + bodyPieces.size());
+			}
+
+			std::copy(bodyPieces.begin(), bodyPieces.end(), Pieces.begin() + oldPieces.Begin);
+			Axes.resize(LocalAxes.size());
+			PieceCentroids.resize(Pieces.size());
+			PieceBounds.resize(Pieces.size());
+			CompactWastedPools();
+		}
+
+		/**
+		* @brief Appends the edge normals of a convex polygon to the axis pool
+		* @returns number of appended axes
+		*/
+		uint32_t AppendAxes(const std::vector<sf::Vector2f>& polygon)
+		{
+			// an axis and its opposite give the same overlap, parallel edges share one axis
+			constexpr float PARALLEL_TOLERANCE = 1e-6f;
+			size_t begin = LocalAxes.size();
+
+			for (size_t i = 0; i < polygon.size(); i++)
+			{
+				sf::Vector2f normalVector = normal(polygon[(i + 1) % polygon.size()] - polygon[i]);
+				bool isParallel = false;
+
+				for (size_t k = begin; k < LocalAxes.size(); k++)
+				{
+					isParallel = isParallel || std::abs(cross(LocalAxes[k], normalVector)) < PARALLEL_TOLERANCE;
+				}
+
+				if (!isParallel)
+				{
+					LocalAxes.push_back(normalVector);
+				}
+			}
+
+			return static_cast<uint32_t>(LocalAxes.size() - begin);
+		}
+
+		/**
+		* @brief Compacts the pools once half of any of them belongs to no body
+		*/
+		void CompactWastedPools()
+		{
+			if (_wastedVertices > LocalVertices.size() / 2 || _wastedAxes > LocalAxes.size() / 2 || _wastedPieces > Pieces.size() / 2)
+			{
+				CompactPools();
+			}
+		}
+
+		/**
+		* @brief Copies live ranges into new pools in dense order, so neighbouring bodies have neighbouring vertices
+		*/
+		void CompactPools()
+		{
+			std::vector<sf::Vector2f> localVertices;
+			std::vector<sf::Vector2f> localAxes;
+			std::vector<BodyPiece> pieces;
+			localVertices.reserve(LocalVertices.size() - _wastedVertices);
+			localAxes.reserve(LocalAxes.size() - _wastedAxes);
+			pieces.reserve(Pieces.size() - _wastedPieces);
+
+			for (size_t index = 0; index < Handles.size(); index++)
+			{
+				PoolRange& vertices = VertexRanges[index];
+				PoolRange& axes = AxisRanges[index];
+				PoolRange& bodyPieces = PieceRanges[index];
+				uint32_t verticesBegin = static_cast<uint32_t>(localVertices.size());
+				uint32_t axesBegin = static_cast<uint32_t>(localAxes.size());
+				uint32_t piecesBegin = static_cast<uint32_t>(pieces.size());
+
+				localVertices.insert(localVertices.end(), LocalVertices.begin() + vertices.Begin, LocalVertices.begin() + vertices.Begin + vertices.Count);
+				localAxes.insert(localAxes.end(), LocalAxes.begin() + axes.Begin, LocalAxes.begin() + axes.Begin + axes.Count);
+				pieces.insert(pieces.end(), Pieces.begin() + bodyPieces.Begin, Pieces.begin() + bodyPieces.Begin + bodyPieces.Count);
+				vertices.Begin = verticesBegin;
+				axes.Begin = axesBegin;
+				bodyPieces.Begin = piecesBegin;
+			}
+
+			LocalVertices = std::move(localVertices);
+			LocalAxes = std::move(localAxes);
+			Pieces = std::move(pieces);
+			Vertices.resize(LocalVertices.size());
+			Axes.resize(LocalAxes.size());
+			PieceCentroids.resize(Pieces.size());
+			PieceBounds.resize(Pieces.size());
+			_wastedVertices = 0;
+			_wastedAxes = 0;
+			_wastedPieces = 0;
+
+			for (uint32_t index = 0; index < Handles.size(); index++)
+			{
+				Transform(index);
+			}
+		}
+
+		std::vector<Slot> _slots;
+		std::vector<uint32_t> _freeSlots;
+		uint32_t _staticCount = 0;
+		size_t _wastedVertices = 0;
+		size_t _wastedAxes = 0;
+		size_t _wastedPieces = 0;
+	};
+} // namespace Engine
\ No newline at end of file
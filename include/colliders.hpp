@@ -0,0 +1,612 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <math.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Circle in world space
+	*/
+	struct Circle
+	{
+		sf::Vector2f Center;
+		float Radius = 0.f;
+	};
+
+	/**
+	* @brief Segment from Start to End swept by a circle (stadium shape) in world space
+	*/
+	struct Capsule
+	{
+		sf::Vector2f Start;
+		sf::Vector2f End;
+		float Radius = 0.f;
+	};
+
+	/**
+	* @brief Rectangle with arbitrary rotation in world space, only its 2 axes are tested
+	*/
+	struct OrientedBox
+	{
+		/**
+		* @brief Creates the box from rectangle vertices in the order of getVertices
+		* @param vertices: corners, each next one is adjacent to the previous
+		*/
+		static OrientedBox FromVertices(const std::array<sf::Vector2f, 4>& vertices)
+		{
+			sf::Vector2f sideX = vertices[1] - vertices[0];
+			sf::Vector2f sideY = vertices[3] - vertices[0];
+			float width = std::sqrt(dot(sideX, sideX));
+			float height = std::sqrt(dot(sideY, sideY));
+
+			OrientedBox box;
+			box.Center = (vertices[0] + vertices[2]) / 2.f;
+			box.AxisX = width == 0.f ? sf::Vector2f{ 1.f, 0.f } : sideX / width;
+			box.AxisY = height == 0.f ? sf::Vector2f{ -box.AxisX.y, box.AxisX.x } : sideY / height;
+			box.HalfSize = sf::Vector2f{ width / 2.f, height / 2.f };
+			box.Vertices = vertices;
+			return box;
+		}
+
+		sf::Vector2f Center;
+		// unit directions of the sides
+		sf::Vector2f AxisX;
+		sf::Vector2f AxisY;
+		sf::Vector2f HalfSize;
+		std::array<sf::Vector2f, 4> Vertices;
+	};
+
+	/**
+	* @brief Any other convex shape, checked with the generic SAT
+	*/
+	struct ConvexPolygon
+	{
+		std::vector<sf::Vector2f> Vertices;
+	};
+
+	/**
+	* @brief Shape description the narrowphase dispatches on
+	*/
+	using Collider = std::variant<Circle, Capsule, OrientedBox, ConvexPolygon>;
+
+	/**
+	* @brief Point count from which an sf::CircleShape approximates its circle: the edges stay within
+	* r * (1 - cos(pi / 16)), about 2% of the radius. With fewer points it's a polygon (3 points make a triangle)
+	*/
+	inline constexpr size_t CIRCLE_MIN_POINTS = 16;
+
+	/**
+	* @returns the shape as a circle if it can be tested as a true circle: an sf::CircleShape
+	* with at least CIRCLE_MIN_POINTS points and uniform scale, nullptr otherwise
+	*/
+	inline const sf::CircleShape* asRoundCircle(const sf::Shape* shape)
+	{
+		const auto* circle = dynamic_cast<const sf::CircleShape*>(shape);
+		const sf::Vector2f& scale = shape->getScale();
+		return circle && circle->getPointCount() >= CIRCLE_MIN_POINTS && std::abs(scale.x) == std::abs(scale.y) ? circle : nullptr;
+	}
+
+	/**
+	* @brief Creates the collider that fits the shape type best: a circle for a round sf::CircleShape (see asRoundCircle),
+	* an oriented box for sf::RectangleShape and a polygon for the rest
+	* @param shape: convex shape
+	*/
+	inline Collider makeCollider(const sf::Shape* shape)
+	{
+		const sf::Vector2f& scale = shape->getScale();
+
+		if (const sf::CircleShape* circle = asRoundCircle(shape))
+		{
+			float radius = circle->getRadius();
+			return Circle{ shape->getTransform().transformPoint(radius, radius), radius * std::abs(scale.x) };
+		}
+
+		std::vector<sf::Vector2f> vertices = getVertices(shape);
+
+		if (dynamic_cast<const sf::RectangleShape*>(shape))
+		{
+			return OrientedBox::FromVertices({ vertices[0], vertices[1], vertices[2], vertices[3] });
+		}
+
+		return ConvexPolygon{ std::move(vertices) };
+	}
+
+	namespace detail
+	{
+		/**
+		* @brief Segment that is inflated by a radius: a circle has Start == End
+		*/
+		struct RoundedCore
+		{
+			sf::Vector2f Start;
+			sf::Vector2f End;
+			float Radius;
+		};
+
+		inline RoundedCore roundedCore(const Circle& circle)
+		{
+			return RoundedCore{ circle.Center, circle.Center, circle.Radius };
+		}
+
+		inline RoundedCore roundedCore(const Capsule& capsule)
+		{
+			return RoundedCore{ capsule.Start, capsule.End, capsule.Radius };
+		}
+
+		inline std::span<const sf::Vector2f> polygonVertices(const OrientedBox& box)
+		{
+			return box.Vertices;
+		}
+
+		inline std::span<const sf::Vector2f> polygonVertices(const ConvexPolygon& polygon)
+		{
+			return polygon.Vertices;
+		}
+
+		/**
+		* @brief Minimum and maximum projection of the box onto a unit axis, computed from the half size
+		*/
+		inline std::pair<float, float> projectionInterval(const OrientedBox& box, const sf::Vector2f& axis)
+		{
+			float center = dot(box.Center, axis);
+			float radius = box.HalfSize.x * std::abs(dot(box.AxisX, axis)) + box.HalfSize.y * std::abs(dot(box.AxisY, axis));
+			return { center - radius, center + radius };
+		}
+
+		inline std::pair<float, float> projectionInterval(const ConvexPolygon& polygon, const sf::Vector2f& axis)
+		{
+			auto [minProjection, maxProjection] = projectionBounds(polygon.Vertices, axis);
+			return { minProjection.GetProjectionValue(), maxProjection.GetProjectionValue() };
+		}
+
+		inline std::pair<float, float> projectionInterval(const RoundedCore& core, const sf::Vector2f& axis)
+		{
+			float start = dot(core.Start, axis);
+			float end = dot(core.End, axis);
+			return { std::min(start, end) - core.Radius, std::max(start, end) + core.Radius };
+		}
+
+		/**
+		* @brief Calls the function with every unit axis the shape contributes to SAT
+		*/
+		template <typename Function>
+		void forEachAxis(const OrientedBox& box, Function&& function)
+		{
+			function(box.AxisX);
+			function(box.AxisY);
+		}
+
+		template <typename Function>
+		void forEachAxis(const ConvexPolygon& polygon, Function&& function)
+		{
+			const size_t VERTICES = polygon.Vertices.size();
+
+			for (size_t i = 0; i < VERTICES; i++)
+			{
+				function(normal(polygon.Vertices[(i + 1) % VERTICES] - polygon.Vertices[i]));
+			}
+		}
+
+		inline sf::Vector2f shapeCenter(const OrientedBox& box)
+		{
+			return box.Center;
+		}
+
+		inline sf::Vector2f shapeCenter(const ConvexPolygon& polygon)
+		{
+			return centroid(polygon.Vertices);
+		}
+
+		/**
+		* @returns the first vertex with the biggest projection onto the direction
+		*/
+		inline sf::Vector2f farthestVertex(std::span<const sf::Vector2f> vertices, const sf::Vector2f& direction)
+		{
+			size_t best = 0;
+
+			for (size_t i = 1; i < vertices.size(); i++)
+			{
+				if (dot(vertices[i], direction) > dot(vertices[best], direction))
+				{
+					best = i;
+				}
+			}
+
+			return vertices[best];
+		}
+
+		/**
+		* @brief SAT for a pair of polygonal colliders, the box contributes 2 axes and projects through its half size
+		*/
+		template <typename PolygonA, typename PolygonB>
+		std::optional<CollisionResponse> polygonalCollision(const PolygonA& a, const PolygonB& b)
+		{
+			SatState state;
+			bool isAxisOfA = true;
+			bool isSeparated = false;
+
+			auto testAxis = [&](const sf::Vector2f& axis, bool isOwnAxis)
+			{
+				if (isSeparated)
+				{
+					return;
+				}
+
+				auto [minA, maxA] = projectionInterval(a, axis);
+				auto [minB, maxB] = projectionInterval(b, axis);
+
+				if (minB > maxA || minA > maxB)
+				{
+					isSeparated = true;
+					return;
+				}
+
+				float overlap = std::min(maxA - minB, maxB - minA);
+
+				if (overlap < state.LengthMTV)
+				{
+					state.LengthMTV = overlap;
+					state.AxisMTV = axis;
+					isAxisOfA = isOwnAxis;
+				}
+			};
+
+			forEachAxis(a, [&](const sf::Vector2f& axis) { testAxis(axis, true); });
+			forEachAxis(b, [&](const sf::Vector2f& axis) { testAxis(axis, false); });
+
+			if (isSeparated)
+			{
+				return std::nullopt;
+			}
+
+			sf::Vector2f centerA = shapeCenter(a);
+			sf::Vector2f centerB = shapeCenter(b);
+
+			// the same orientation rule as orientedResponse, the axis points from B to A
+			sf::Vector2f axis = dot(state.AxisMTV, centerA - centerB) < 0.f ? -state.AxisMTV : state.AxisMTV;
+			state.MinimumTranslationVector = axis * state.LengthMTV;
+
+			// a face of one shape is hit by the deepest vertex of the other one
+			state.PointOfCollision = isAxisOfA ? farthestVertex(polygonVertices(b), axis) : farthestVertex(polygonVertices(a), -axis);
+			return CollisionResponse{ state.PointOfCollision, state.MinimumTranslationVector };
+		}
+
+		/**
+		* @returns the point of the segment closest to the point
+		*/
+		inline sf::Vector2f closestPointOnSegment(const sf::Vector2f& start, const sf::Vector2f& end, const sf::Vector2f& point)
+		{
+			sf::Vector2f segment = end - start;
+			float lengthSquared = dot(segment, segment);
+
+			if (lengthSquared == 0.f)
+			{
+				return start;
+			}
+
+			float t = std::clamp(dot(point - start, segment) / lengthSquared, 0.f, 1.f);
+			return start + segment * t;
+		}
+
+		/**
+		* @brief Finds the closest points of two segments, the segments must not intersect
+		* @param closestP: output, point of the first segment
+		* @param closestQ: output, point of the second segment
+		*/
+		inline void closestPointsOfSegments(const sf::Vector2f& startP, const sf::Vector2f& endP, const sf::Vector2f& startQ, const sf::Vector2f& endQ,
+			sf::Vector2f& closestP, sf::Vector2f& closestQ)
+		{
+			// without an intersection one of the closest points is an endpoint
+			std::array<std::pair<sf::Vector2f, sf::Vector2f>, 4> candidates{ {
+				{ startP, closestPointOnSegment(startQ, endQ, startP) },
+				{ endP, closestPointOnSegment(startQ, endQ, endP) },
+				{ closestPointOnSegment(startP, endP, startQ), startQ },
+				{ closestPointOnSegment(startP, endP, endQ), endQ }
+			} };
+
+			float bestDistance = std::numeric_limits<float>::infinity();
+
+			for (const auto& [p, q] : candidates)
+			{
+				float distance = dot(p - q, p - q);
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					closestP = p;
+					closestQ = q;
+				}
+			}
+		}
+
+		/**
+		* @brief Checks if two segments have a common point, touching and collinear overlapping included
+		*/
+		inline bool segmentsIntersect(const sf::Vector2f& startP, const sf::Vector2f& endP, const sf::Vector2f& startQ, const sf::Vector2f& endQ)
+		{
+			float d1 = cross(endQ - startQ, startP - startQ);
+			float d2 = cross(endQ - startQ, endP - startQ);
+			float d3 = cross(endP - startP, startQ - startP);
+			float d4 = cross(endP - startP, endQ - startP);
+
+			if (((d1 > 0.f && d2 < 0.f) || (d1 < 0.f && d2 > 0.f)) && ((d3 > 0.f && d4 < 0.f) || (d3 < 0.f && d4 > 0.f)))
+			{
+				return true;
+			}
+
+			// an endpoint lying on the other segment
+			auto onSegment = [](const sf::Vector2f& start, const sf::Vector2f& end, const sf::Vector2f& point)
+			{
+				return std::min(start.x, end.x) <= point.x && point.x <= std::max(start.x, end.x)
+					&& std::min(start.y, end.y) <= point.y && point.y <= std::max(start.y, end.y);
+			};
+
+			return (d1 == 0.f && onSegment(startQ, endQ, startP)) || (d2 == 0.f && onSegment(startQ, endQ, endP))
+				|| (d3 == 0.f && onSegment(startP, endP, startQ)) || (d4 == 0.f && onSegment(startP, endP, endQ));
+		}
+
+		/**
+		* @brief Checks if the point lies inside the convex polygon or on its boundary, works for both windings
+		*/
+		inline bool containsPoint(std::span<const sf::Vector2f> vertices, const sf::Vector2f& point)
+		{
+			bool hasPositive = false;
+			bool hasNegative = false;
+
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				float side = cross(vertices[(i + 1) % vertices.size()] - vertices[i], point - vertices[i]);
+				hasPositive = hasPositive || side > 0.f;
+				hasNegative = hasNegative || side < 0.f;
+			}
+
+			return !(hasPositive && hasNegative);
+		}
+
+		/**
+		* @brief Forms the response of two rounded shapes whose cores don't intersect
+		* @param closestA: point of the first core closest to the second core
+		* @param closestB: point of the second core closest to the first core
+		*/
+		inline std::optional<CollisionResponse> roundedResponse(const sf::Vector2f& closestA, float radiusA, const sf::Vector2f& closestB, float radiusB)
+		{
+			sf::Vector2f direction = closestA - closestB;
+			float distanceSquared = dot(direction, direction);
+			float radii = radiusA + radiusB;
+
+			if (distanceSquared > radii * radii)
+			{
+				return std::nullopt;
+			}
+
+			float distance = std::sqrt(distanceSquared);
+
+			// cores touch at a single point, any direction pushes the shapes apart
+			sf::Vector2f axis = distance == 0.f ? sf::Vector2f{ 1.f, 0.f } : direction / distance;
+
+			// the point of A that went deepest into B
+			return CollisionResponse{ closestA - axis * radiusA, axis * (radii - distance) };
+		}
+
+		/**
+		* @brief Deep penetration of a rounded core: the cores intersect, so the MTV lies on one of the tested axes.
+		* Shape A is pushed out the shorter way along the axis, the same way SAT does it
+		*/
+		struct DeepPenetration
+		{
+			template <typename ShapeB>
+			void TestAxis(const RoundedCore& a, const ShapeB& b, const sf::Vector2f& axis)
+			{
+				auto [minA, maxA] = projectionInterval(a, axis);
+				auto [minB, maxB] = projectionInterval(b, axis);
+
+				// A goes along the axis when it is closer to the upper end of B
+				float forward = maxB - minA;
+				float backward = maxA - minB;
+
+				if (std::min(forward, backward) < LengthMTV)
+				{
+					LengthMTV = std::min(forward, backward);
+					AxisMTV = forward <= backward ? axis : -axis;
+				}
+			}
+
+			CollisionResponse Response(const RoundedCore& a) const
+			{
+				sf::Vector2f deepestCorePoint = dot(a.Start, AxisMTV) <= dot(a.End, AxisMTV) ? a.Start : a.End;
+				return CollisionResponse{ deepestCorePoint - AxisMTV * a.Radius, AxisMTV * LengthMTV };
+			}
+
+			float LengthMTV = std::numeric_limits<float>::infinity();
+			sf::Vector2f AxisMTV{ 1.f, 0.f };
+		};
+
+		/**
+		* @brief Checks a circle or a capsule against a box or a polygon, MTV pushes the rounded shape out
+		*/
+		template <typename Polygon>
+		std::optional<CollisionResponse> roundedPolygonCollision(const RoundedCore& core, const Polygon& polygon)
+		{
+			std::span<const sf::Vector2f> vertices = polygonVertices(polygon);
+			const size_t VERTICES = vertices.size();
+
+			bool isDeep = containsPoint(vertices, core.Start);
+
+			for (size_t i = 0; i < VERTICES && !isDeep; i++)
+			{
+				isDeep = segmentsIntersect(core.Start, core.End, vertices[i], vertices[(i + 1) % VERTICES]);
+			}
+
+			if (isDeep)
+			{
+				// the Minkowski difference of a polygon and a segment has the polygon normals and the segment normal
+				DeepPenetration penetration;
+				forEachAxis(polygon, [&](const sf::Vector2f& axis) { penetration.TestAxis(core, polygon, axis); });
+
+				if (core.Start != core.End)
+				{
+					penetration.TestAxis(core, polygon, normal(core.End - core.Start));
+				}
+
+				return penetration.Response(core);
+			}
+
+			sf::Vector2f closestCore;
+			sf::Vector2f closestPolygon;
+			float bestDistance = std::numeric_limits<float>::infinity();
+
+			for (size_t i = 0; i < VERTICES; i++)
+			{
+				sf::Vector2f p;
+				sf::Vector2f q;
+				closestPointsOfSegments(core.Start, core.End, vertices[i], vertices[(i + 1) % VERTICES], p, q);
+				float distance = dot(p - q, p - q);
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					closestCore = p;
+					closestPolygon = q;
+				}
+			}
+
+			std::optional<CollisionResponse> response = roundedResponse(closestCore, core.Radius, closestPolygon, 0.f);
+
+			if (response)
+			{
+				// the polygon surface point is more telling than the deepest point of the circle
+				response->PointOfCollision = closestPolygon;
+			}
+
+			return response;
+		}
+
+		/**
+		* @brief Checks two rounded shapes for a collision, MTV pushes A out of B
+		*/
+		inline std::optional<CollisionResponse> roundedCollision(const RoundedCore& a, const RoundedCore& b)
+		{
+			if (!segmentsIntersect(a.Start, a.End, b.Start, b.End))
+			{
+				sf::Vector2f closestA;
+				sf::Vector2f closestB;
+				closestPointsOfSegments(a.Start, a.End, b.Start, b.End, closestA, closestB);
+				return roundedResponse(closestA, a.Radius, closestB, b.Radius);
+			}
+
+			if (a.Start == a.End && b.Start == b.End)
+			{
+				// coincident centers of two circles
+				return roundedResponse(a.Start, a.Radius, b.Start, b.Radius);
+			}
+
+			// the Minkowski difference of two segments is a parallelogram with their normals
+			DeepPenetration penetration;
+
+			for (const RoundedCore* core : { &a, &b })
+			{
+				if (core->Start != core->End)
+				{
+					penetration.TestAxis(a, b, normal(core->End - core->Start));
+				}
+			}
+
+			return penetration.Response(a);
+		}
+
+		/**
+		* @brief Narrowphase routines for every pair of collider types, the first type goes not later in Collider than the second one
+		*/
+		inline std::optional<CollisionResponse> collide(const Circle& a, const Circle& b, CollisionScratch&)
+		{
+			return roundedResponse(a.Center, a.Radius, b.Center, b.Radius);
+		}
+
+		inline std::optional<CollisionResponse> collide(const Circle& a, const Capsule& b, CollisionScratch&)
+		{
+			return roundedResponse(a.Center, a.Radius, closestPointOnSegment(b.Start, b.End, a.Center), b.Radius);
+		}
+
+		inline std::optional<CollisionResponse> collide(const Capsule& a, const Capsule& b, CollisionScratch&)
+		{
+			return roundedCollision(roundedCore(a), roundedCore(b));
+		}
+
+		template <typename Rounded, typename Polygon>
+			requires (std::is_same_v<Rounded, Circle> || std::is_same_v<Rounded, Capsule>)
+				&& (std::is_same_v<Polygon, OrientedBox> || std::is_same_v<Polygon, ConvexPolygon>)
+		std::optional<CollisionResponse> collide(const Rounded& a, const Polygon& b, CollisionScratch&)
+		{
+			return roundedPolygonCollision(roundedCore(a), b);
+		}
+
+		inline std::optional<CollisionResponse> collide(const OrientedBox& a, const OrientedBox& b, CollisionScratch&)
+		{
+			return polygonalCollision(a, b);
+		}
+
+		inline std::optional<CollisionResponse> collide(const OrientedBox& a, const ConvexPolygon& b, CollisionScratch&)
+		{
+			return polygonalCollision(a, b);
+		}
+
+		inline std::optional<CollisionResponse> collide(const ConvexPolygon& a, const ConvexPolygon& b, CollisionScratch& scratch)
+		{
+			return processCollision(a.Vertices, b.Vertices, scratch);
+		}
+	} // namespace detail
+
+	/**
+	* @brief Checks two colliders for a collision with the routine written for their types
+	* @param a: first collider
+	* @param b: second collider
+	* @param scratch: SAT buffers for a pair of polygons
+	* @return std::nullopt if no collision detected, CollisionResponse with MTV that pushes A out of B otherwise
+	*/
+	inline std::optional<CollisionResponse> processCollision(const Collider& a, const Collider& b, CollisionScratch& scratch)
+	{
+		return std::visit([&scratch](const auto& first, const auto& second) -> std::optional<CollisionResponse>
+		{
+			if constexpr (requires { detail::collide(first, second, scratch); })
+			{
+				return detail::collide(first, second, scratch);
+			}
+			else
+			{
+				// only one order is implemented, the other one pushes B out of A
+				std::optional<CollisionResponse> response = detail::collide(second, first, scratch);
+
+				if (response)
+				{
+					response->MinimumTransitionVector = -response->MinimumTransitionVector;
+				}
+
+				return response;
+			}
+		}, a, b);
+	}
+
+	/**
+	* @brief Checks two colliders for a collision with the routine written for their types
+	*/
+	inline std::optional<CollisionResponse> processCollision(const Collider& a, const Collider& b)
+	{
+		CollisionScratch scratch;
+		return processCollision(a, b, scratch);
+	}
+} // namespace Engine
\ No newline at end of file
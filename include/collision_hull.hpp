@@ -0,0 +1,301 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Shape.hpp>
+
+#include <math.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief World-space collision data of a convex shape that lives elsewhere, e.g. in a CollisionHull
+	* or in the shared pools of BodyStorage
+	*/
+	struct HullView
+	{
+		std::span<const sf::Vector2f> Vertices;
+		// unit edge normals, parallel edges share one
+		std::span<const sf::Vector2f> Axes;
+		sf::Vector2f Centroid;
+		// oriented area, the sign depends on the vertex winding
+		float Area = 0.f;
+	};
+
+	/**
+	* @brief Collision data of a convex shape cached between frames.
+	* Local data (points, edge normals, centroid and area) is computed once,
+	* world-space vertices are retransformed only when the shape moves or rotates,
+	* normals are rotated only when the rotation changes
+	*/
+	class CollisionHull
+	{
+	public:
+		/**
+		* @brief Creates the hull and synchronizes it with the shape
+		* @param shape: convex shape
+		*/
+		explicit CollisionHull(const sf::Shape* shape)
+		{
+			Rebuild(shape);
+		}
+
+		/**
+		* @brief Reads shape points again, call when the geometry changes (size, radius, point count, points)
+		* @param shape: convex shape
+		*/
+		void Rebuild(const sf::Shape* shape)
+		{
+			size_t pointsAmount = shape->getPointCount();
+			_points.resize(pointsAmount);
+
+			for (size_t i = 0; i < pointsAmount; i++)
+			{
+				_points[i] = shape->getPoint(i);
+			}
+
+			_vertices.resize(pointsAmount);
+			ComputeLocalData(shape->getOrigin(), shape->getScale());
+			Transform(shape->getPosition(), shape->getRotation());
+		}
+
+		/**
+		* @brief Synchronizes world-space data with the shape's transform
+		* @param shape: the shape the hull was built from
+		* @returns false if the shape hasn't moved and nothing was recomputed
+		*/
+		bool Update(const sf::Shape* shape)
+		{
+			const sf::Vector2f& origin = shape->getOrigin();
+			const sf::Vector2f& scale = shape->getScale();
+
+			// origin and scale change the local geometry itself
+			if (origin != _origin || scale != _scale)
+			{
+				ComputeLocalData(origin, scale);
+				Transform(shape->getPosition(), shape->getRotation());
+				return true;
+			}
+
+			float rotation = shape->getRotation();
+			const sf::Vector2f& position = shape->getPosition();
+
+			if (rotation == _rotation && position == _position)
+			{
+				return false;
+			}
+
+			Transform(position, rotation);
+			return true;
+		}
+
+		/**
+		* @returns world-space vertices, the same as getVertices for the shape
+		*/
+		const std::vector<sf::Vector2f>& GetVertices() const noexcept
+		{
+			return _vertices;
+		}
+
+		/**
+		* @returns world-space unit normals of the edges, an edge parallel to an already listed one is skipped
+		*/
+		const std::vector<sf::Vector2f>& GetAxes() const noexcept
+		{
+			return _axes;
+		}
+
+		const sf::Vector2f& GetCentroid() const noexcept
+		{
+			return _centroid;
+		}
+
+		/**
+		* @returns oriented area of the shape, the sign depends on the vertex winding
+		*/
+		float GetArea() const noexcept
+		{
+			return _area;
+		}
+
+		/**
+		* @returns view of the world-space data, valid until the next Update or Rebuild
+		*/
+		HullView GetView() const noexcept
+		{
+			return HullView{ _vertices, _axes, _centroid, _area };
+		}
+
+	private:
+		/**
+		* @brief Computes axes, centroid and area in local space with origin and scale applied,
+		* the rest of the transform is a rotation and a translation
+		*/
+		void ComputeLocalData(const sf::Vector2f& origin, const sf::Vector2f& scale)
+		{
+			ENGINE_PROFILE_SCOPE(HullUpdate);
+			_origin = origin;
+			_scale = scale;
+
+			std::vector<sf::Vector2f> scaledPoints(_points.size());
+
+			for (size_t i = 0; i < _points.size(); i++)
+			{
+				scaledPoints[i] = sf::Vector2f{ (_points[i].x - origin.x) * scale.x, (_points[i].y - origin.y) * scale.y };
+			}
+
+			// an axis and its opposite give the same overlap, parallel edges share one axis
+			constexpr float PARALLEL_TOLERANCE = 1e-6f;
+			_localAxes.clear();
+
+			for (size_t i = 0; i < scaledPoints.size(); i++)
+			{
+				sf::Vector2f normalVector = normal(scaledPoints[(i + 1) % scaledPoints.size()] - scaledPoints[i]);
+				bool isParallel = false;
+
+				for (const auto& axis : _localAxes)
+				{
+					isParallel = isParallel || std::abs(cross(axis, normalVector)) < PARALLEL_TOLERANCE;
+				}
+
+				if (!isParallel)
+				{
+					_localAxes.push_back(normalVector);
+				}
+			}
+
+			_axes.resize(_localAxes.size());
+			_area = orientedArea(scaledPoints);
+			_localCentroid = centroid(scaledPoints);
+
+			// force the rotation to be applied to the new axes
+			_rotation = std::numeric_limits<float>::quiet_NaN();
+		}
+
+		/**
+		* @brief Transforms vertices the same way sf::Transformable::getTransform does,
+		* rotates axes only if the rotation has changed
+		*/
+		void Transform(const sf::Vector2f& position, float rotation)
+		{
+			ENGINE_PROFILE_SCOPE(HullUpdate);
+
+			if (rotation != _rotation)
+			{
+				float angle = -rotation * 3.141592654f / 180.f;
+				_cosine = std::cos(angle);
+				_sine = std::sin(angle);
+				_rotation = rotation;
+
+				for (size_t i = 0; i < _localAxes.size(); i++)
+				{
+					_axes[i] = Rotate(_localAxes[i]);
+				}
+			}
+
+			_position = position;
+
+			float sxc = _scale.x * _cosine;
+			float syc = _scale.y * _cosine;
+			float sxs = _scale.x * _sine;
+			float sys = _scale.y * _sine;
+			float tx = -_origin.x * sxc - _origin.y * sys + position.x;
+			float ty = _origin.x * sxs - _origin.y * syc + position.y;
+
+			for (size_t i = 0; i < _points.size(); i++)
+			{
+				_vertices[i] = sf::Vector2f{ sxc * _points[i].x + sys * _points[i].y + tx, -sxs * _points[i].x + syc * _points[i].y + ty };
+			}
+
+			_centroid = Rotate(_localCentroid) + position;
+		}
+
+		sf::Vector2f Rotate(const sf::Vector2f& v) const noexcept
+		{
+			return sf::Vector2f{ _cosine * v.x + _sine * v.y, -_sine * v.x + _cosine * v.y };
+		}
+
+		// shape points as returned by getPoint
+		std::vector<sf::Vector2f> _points;
+		std::vector<sf::Vector2f> _localAxes;
+		sf::Vector2f _localCentroid;
+		float _area = 0.f;
+
+		std::vector<sf::Vector2f> _vertices;
+		std::vector<sf::Vector2f> _axes;
+		sf::Vector2f _centroid;
+
+		sf::Vector2f _origin;
+		sf::Vector2f _scale;
+		sf::Vector2f _position;
+		float _rotation = 0.f;
+		float _cosine = 1.f;
+		float _sine = 0.f;
+	};
+
+	namespace detail
+	{
+		/**
+		* @brief SAT over cached axes and centroids
+		* @param aVertices: vertices of hull A, a span of static extent unrolls the projections
+		* @param bVertices: vertices of hull B
+		*/
+		template <typename VerticesA, typename VerticesB>
+		std::optional<CollisionResponse> hullSeparatingAxisTest(const HullView& a, const HullView& b, VerticesA aVertices, VerticesB bVertices)
+		{
+			ENGINE_PROFILE_SCOPE(Sat);
+			ENGINE_PROFILE_COUNT(PairsTested, 1);
+			SatState state;
+
+			for (const HullView* hull : { &a, &b })
+			{
+				for (const auto& axis : hull->Axes)
+				{
+					if (!overlapOnAxis(aVertices, bVertices, axis, state))
+					{
+						ENGINE_PROFILE_COUNT(EarlySeparations, 1);
+						return std::nullopt;
+					}
+				}
+			}
+
+			return orientedResponse(state, a.Centroid, b.Centroid);
+		}
+	} // namespace detail
+
+	/**
+	* @brief Checks two hulls for a collision with SAT. Uses cached axes and centroids,
+	* so no normals or centroids are computed and nothing is allocated. Triangles and quads
+	* are projected by code for their vertex counts
+	* @param a: first shape hull
+	* @param b: second shape hull
+	* @return std::nullopt if no collision detected, CollisionResponse in std::optional when there is collision
+	*/
+	inline std::optional<CollisionResponse> processCollision(const HullView& a, const HullView& b)
+	{
+		return detail::dispatchVertexCounts(a.Vertices.size(), b.Vertices.size(), [&](auto aVertices, auto bVertices)
+		{
+			return detail::hullSeparatingAxisTest(a, b, a.Vertices.first<decltype(aVertices)::value>(), b.Vertices.first<decltype(bVertices)::value>());
+		},
+		[&]()
+		{
+			return detail::hullSeparatingAxisTest(a, b, a.Vertices, b.Vertices);
+		});
+	}
+
+	/**
+	* @brief Checks two cached hulls for a collision with SAT
+	* @param a: first shape hull
+	* @param b: second shape hull
+	* @return std::nullopt if no collision detected, CollisionResponse in std::optional when there is collision
+	*/
+	inline std::optional<CollisionResponse> processCollision(const CollisionHull& a, const CollisionHull& b)
+	{
+		return processCollision(a.GetView(), b.GetView());
+	}
+} // namespace Engine
\ No newline at end of file
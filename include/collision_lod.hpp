@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Level of detail of a collision proxy: a coarser convex hull tested instead of the render geometry
+	*/
+	struct CollisionLod
+	{
+		// most vertices the proxy keeps, at least 3
+		size_t MaxVertices = 8;
+		// pixels the proxy may deviate from the shape, vertices are removed below it even within the budget
+		float Tolerance = 0.5f;
+	};
+
+	struct SimplifiedPolygon
+	{
+		std::vector<sf::Vector2f> Vertices;
+		// farthest distance of the original boundary from the simplified one, in pixels
+		float MaxDeviation = 0.f;
+	};
+
+	/**
+	* @brief Removes vertices of a convex polygon one at a time, always the one whose chord passes closest
+	* to the original vertices it cuts off, until the budget is met and the next removal would exceed the tolerance.
+	* The result lies inside the polygon, its boundary is at most MaxDeviation from the original one
+	* @param polygon: convex polygon in either winding
+	*/
+	SimplifiedPolygon simplifyConvexPolygon(std::span<const sf::Vector2f> polygon, const CollisionLod& lod);
+} // namespace Engine
\ No newline at end of file
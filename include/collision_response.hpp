@@ -1,3 +1,5 @@
+#pragma once
+
 #include <SFML/System/Vector2.hpp>
 
 namespace Engine
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+#include <collision_hull.hpp>
+#include <collision_response.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Features a contact point was made from. It stays the same while the bodies touch
+	* with the same edges, so the point can be matched with the one of the previous step
+	*/
+	struct ContactId
+	{
+		// edge of the reference shape the incident edge is clipped to
+		uint16_t ReferenceEdge = 0;
+		// vertex of the incident shape, or the incident edge when the point was clipped
+		uint16_t IncidentFeature = 0;
+		// 0 when the point is an incident vertex, 1 or 2 for the side plane that clipped it
+		uint8_t ClipSide = 0;
+		// true when shape B holds the reference edge
+		bool IsFlipped = false;
+
+		bool operator==(const ContactId&) const = default;
+	};
+
+	struct ContactPoint
+	{
+		// point of the incident shape
+		sf::Vector2f Position;
+		// depth of the point behind the reference edge
+		float Penetration = 0.f;
+		ContactId Id;
+		// impulse accumulated by the solver along the normal, carried over to the next step
+		float NormalImpulse = 0.f;
+	};
+
+	/**
+	* @brief Up to two contact points of a colliding pair sharing one normal
+	*/
+	struct ContactManifold
+	{
+		// unit normal pointing from shape B to shape A, the same way as the MTV
+		sf::Vector2f Normal;
+		std::array<ContactPoint, 2> Points{};
+		uint8_t PointCount = 0;
+	};
+
+	namespace detail
+	{
+		/**
+		* @returns outward unit normal of the edge starting at the vertex
+		* @param isCounterClockwise: positive oriented area of the polygon
+		*/
+		inline sf::Vector2f outwardNormal(std::span<const sf::Vector2f> vertices, size_t edge, bool isCounterClockwise)
+		{
+			sf::Vector2f normalVector = normal(vertices[(edge + 1) % vertices.size()] - vertices[edge]);
+			return isCounterClockwise ? -normalVector : normalVector;
+		}
+
+		/**
+		* @returns edge whose outward normal is the closest to the direction
+		*/
+		inline size_t bestEdge(std::span<const sf::Vector2f> vertices, bool isCounterClockwise, const sf::Vector2f& direction, float& alignment)
+		{
+			size_t best = 0;
+			alignment = -std::numeric_limits<float>::infinity();
+
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				float edgeAlignment = dot(outwardNormal(vertices, i, isCounterClockwise), direction);
+
+				if (edgeAlignment > alignment)
+				{
+					alignment = edgeAlignment;
+					best = i;
+				}
+			}
+
+			return best;
+		}
+
+		/**
+		* @brief Reference/incident edge clipping
+		* @param normalVector: unit direction from B to A, the reference edge is the one facing it the most
+		*/
+		inline ContactManifold clipContactManifold(std::span<const sf::Vector2f> a, bool isCounterClockwiseA,
+			std::span<const sf::Vector2f> b, bool isCounterClockwiseB, const sf::Vector2f& normalVector)
+		{
+			ContactManifold manifold;
+
+			float alignmentA = 0.f;
+			float alignmentB = 0.f;
+			size_t edgeA = bestEdge(a, isCounterClockwiseA, -normalVector, alignmentA);
+			size_t edgeB = bestEdge(b, isCounterClockwiseB, normalVector, alignmentB);
+
+			// edges of A are preferred unless B's edge is clearly better, so the choice doesn't flicker on ties
+			constexpr float RELATIVE_TOLERANCE = 0.98f;
+			constexpr float ABSOLUTE_TOLERANCE = 0.001f;
+			bool isFlipped = RELATIVE_TOLERANCE * alignmentB > alignmentA + ABSOLUTE_TOLERANCE;
+
+			std::span<const sf::Vector2f> reference = isFlipped ? b : a;
+			std::span<const sf::Vector2f> incident = isFlipped ? a : b;
+			size_t referenceEdge = isFlipped ? edgeB : edgeA;
+			sf::Vector2f referenceNormal = outwardNormal(reference, referenceEdge, isFlipped ? isCounterClockwiseB : isCounterClockwiseA);
+
+			// for polygons the SAT axis is an edge normal, the edge's own normal stays exact when the direction is only a guess
+			manifold.Normal = isFlipped ? referenceNormal : -referenceNormal;
+
+			float incidentAlignment = 0.f;
+			size_t incidentEdge = bestEdge(incident, isFlipped ? isCounterClockwiseA : isCounterClockwiseB, -referenceNormal, incidentAlignment);
+
+			sf::Vector2f referenceStart = reference[referenceEdge];
+			sf::Vector2f referenceEnd = reference[(referenceEdge + 1) % reference.size()];
+			sf::Vector2f tangent = unit(referenceEnd - referenceStart);
+
+			size_t incidentNext = (incidentEdge + 1) % incident.size();
+			std::array<ContactPoint, 2> clipped{};
+			clipped[0].Position = incident[incidentEdge];
+			clipped[0].Id = ContactId{ static_cast<uint16_t>(referenceEdge), static_cast<uint16_t>(incidentEdge), 0, isFlipped };
+			clipped[1].Position = incident[incidentNext];
+			clipped[1].Id = ContactId{ static_cast<uint16_t>(referenceEdge), static_cast<uint16_t>(incidentNext), 0, isFlipped };
+
+			// the incident segment is clipped by the side planes through the ends of the reference edge
+			const std::array<float, 2> SIDE_OFFSETS{ -dot(tangent, referenceStart), dot(tangent, referenceEnd) };
+			const std::array<sf::Vector2f, 2> SIDE_NORMALS{ -tangent, tangent };
+
+			for (uint8_t side = 0; side < 2; side++)
+			{
+				float distance0 = dot(SIDE_NORMALS[side], clipped[0].Position) - SIDE_OFFSETS[side];
+				float distance1 = dot(SIDE_NORMALS[side], clipped[1].Position) - SIDE_OFFSETS[side];
+
+				if (distance0 > 0.f && distance1 > 0.f)
+				{
+					return manifold;
+				}
+
+				if (distance0 > 0.f || distance1 > 0.f)
+				{
+					// the point outside the plane is moved onto it
+					ContactPoint& outside = distance0 > 0.f ? clipped[0] : clipped[1];
+					float t = distance0 / (distance0 - distance1);
+					outside.Position = clipped[0].Position + (clipped[1].Position - clipped[0].Position) * t;
+					outside.Id.IncidentFeature = static_cast<uint16_t>(incidentEdge);
+					outside.Id.ClipSide = static_cast<uint8_t>(side + 1);
+				}
+			}
+
+			for (ContactPoint& point : clipped)
+			{
+				float separation = dot(referenceNormal, point.Position - referenceStart);
+
+				// points in front of the reference edge don't touch it
+				if (separation <= 0.f)
+				{
+					point.Penetration = -separation;
+					manifold.Points[manifold.PointCount++] = point;
+				}
+			}
+
+			return manifold;
+		}
+
+		inline sf::Vector2f manifoldNormal(const CollisionResponse& response, const sf::Vector2f& Acentroid, const sf::Vector2f& Bcentroid)
+		{
+			const sf::Vector2f& MTV = response.MinimumTransitionVector;
+
+			// touching shapes have a zero MTV, the centroids give the direction then
+			return dot(MTV, MTV) > 0.f ? unit(MTV) : unit(Acentroid - Bcentroid);
+		}
+	} // namespace detail
+
+	/**
+	* @brief Builds the contact manifold of a collision by clipping the incident edge to the reference edge
+	* @param aShapeVertices: first shape vertices
+	* @param bShapeVertices: second shape vertices
+	* @param response: collision of the shapes, its MTV gives the normal
+	* @returns manifold with up to 2 points, points are in incident edge order
+	*/
+	inline ContactManifold findContactManifold(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices, const CollisionResponse& response)
+	{
+		sf::Vector2f normalVector = detail::manifoldNormal(response, centroid(aShapeVertices), centroid(bShapeVertices));
+		return detail::clipContactManifold(aShapeVertices, orientedArea(aShapeVertices) > 0.f, bShapeVertices, orientedArea(bShapeVertices) > 0.f, normalVector);
+	}
+
+	/**
+	* @brief Builds the contact manifold from hulls, nothing is allocated
+	* @param a: first shape hull
+	* @param b: second shape hull
+	* @param response: collision of the hulls
+	*/
+	inline ContactManifold findContactManifold(const HullView& a, const HullView& b, const CollisionResponse& response)
+	{
+		sf::Vector2f normalVector = detail::manifoldNormal(response, a.Centroid, b.Centroid);
+		return detail::clipContactManifold(a.Vertices, a.Area > 0.f, b.Vertices, b.Area > 0.f, normalVector);
+	}
+
+	inline ContactManifold findContactManifold(const CollisionHull& a, const CollisionHull& b, const CollisionResponse& response)
+	{
+		return findContactManifold(a.GetView(), b.GetView(), response);
+	}
+
+	/**
+	* @brief Manifolds of the previous step by body pair. Points matched by ContactId start
+	* with the impulses they had, so the solver begins close to the solution (warm starting)
+	*/
+	class ContactManifoldCache
+	{
+	public:
+		/**
+		* @brief Copies accumulated impulses of the pair's previous manifold into points with the same id
+		* @param pieceA, pieceB: convex pieces of concave bodies, every pair of pieces has its own manifold
+		* @returns number of matched points
+		*/
+		size_t WarmStart(uint32_t idA, uint32_t idB, ContactManifold& manifold, uint16_t pieceA = 0, uint16_t pieceB = 0) const
+		{
+			auto found = _entries.find(Key{ idA, idB, pieceA, pieceB });
+
+			if (found == _entries.end())
+			{
+				return 0;
+			}
+
+			const ContactManifold& previous = found->second.Manifold;
+			size_t matched = 0;
+
+			for (uint8_t i = 0; i < manifold.PointCount; i++)
+			{
+				for (uint8_t j = 0; j < previous.PointCount; j++)
+				{
+					if (manifold.Points[i].Id == previous.Points[j].Id)
+					{
+						manifold.Points[i].NormalImpulse = previous.Points[j].NormalImpulse;
+						matched++;
+						break;
+					}
+				}
+			}
+
+			return matched;
+		}
+
+		/**
+		* @brief Keeps the solved manifold for the next step
+		*/
+		void Store(uint32_t idA, uint32_t idB, const ContactManifold& manifold, uint16_t pieceA = 0, uint16_t pieceB = 0)
+		{
+			_entries[Key{ idA, idB, pieceA, pieceB }] = Entry{ manifold, _step };
+		}
+
+		/**
+		* @brief Forgets pairs that weren't stored during the step
+		*/
+		void EndStep()
+		{
+			std::erase_if(_entries, [this](const auto& entry) { return entry.second.Step != _step; });
+			_step++;
+		}
+
+		size_t size() const noexcept
+		{
+			return _entries.size();
+		}
+
+	private:
+		struct Entry
+		{
+			ContactManifold Manifold;
+			uint64_t Step;
+		};
+
+		struct Key
+		{
+			uint32_t IdA;
+			uint32_t IdB;
+			uint16_t PieceA;
+			uint16_t PieceB;
+
+			bool operator==(const Key&) const = default;
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const noexcept
+			{
+				uint64_t bodies = static_cast<uint64_t>(key.IdA) << 32 | key.IdB;
+				uint64_t pieces = static_cast<uint64_t>(key.PieceA) << 16 | key.PieceB;
+				return std::hash<uint64_t>{}(bodies ^ pieces * 0x9E3779B97F4A7C15ull);
+			}
+		};
+
+		std::unordered_map<Key, Entry, KeyHash> _entries;
+		uint64_t _step = 0;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+
+namespace Engine
+{
+	namespace detail
+	{
+		/**
+		* @returns turn at vertex b scaled by the winding, positive for a convex corner
+		* @param winding: 1 for a positive oriented area, -1 otherwise
+		*/
+		inline float turn(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c, float winding)
+		{
+			return winding * cross(b - a, c - b);
+		}
+
+		/**
+		* @returns true if the point lies inside the triangle or on its edges
+		*/
+		inline bool isInTriangle(const sf::Vector2f& point, const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c, float winding)
+		{
+			return turn(a, b, point, winding) >= 0.f && turn(b, c, point, winding) >= 0.f && turn(c, a, point, winding) >= 0.f;
+		}
+
+		/**
+		* @returns true if the polygon given by indices into the points has no reflex corner
+		*/
+		inline bool isConvex(std::span<const sf::Vector2f> points, const std::vector<size_t>& polygon, float winding)
+		{
+			for (size_t i = 0; i < polygon.size(); i++)
+			{
+				const sf::Vector2f& previous = points[polygon[(i + polygon.size() - 1) % polygon.size()]];
+				const sf::Vector2f& next = points[polygon[(i + 1) % polygon.size()]];
+
+				if (turn(previous, points[polygon[i]], next, winding) < 0.f)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	} // namespace detail
+
+	/**
+	* @returns true if the polygon has no reflex corner, collinear vertices are allowed
+	*/
+	inline bool isConvex(std::span<const sf::Vector2f> polygon)
+	{
+		std::vector<size_t> indices(polygon.size());
+
+		for (size_t i = 0; i < polygon.size(); i++)
+		{
+			indices[i] = i;
+		}
+
+		std::vector<sf::Vector2f> vertices{ polygon.begin(), polygon.end() };
+		return detail::isConvex(polygon, indices, orientedArea(vertices) > 0.f ? 1.f : -1.f);
+	}
+
+	/**
+	* @brief Splits a simple polygon into convex pieces (Hertel-Mehlhorn): the polygon is triangulated by ear clipping,
+	* then pieces sharing a diagonal are merged while the result stays convex. That gives at most 4 times the minimal count
+	* @param polygon: vertices of a simple polygon in either winding
+	* @returns pieces in the winding of the polygon, a convex polygon comes back as the only piece
+	*/
+	std::vector<std::vector<sf::Vector2f>> decomposeConvex(std::span<const sf::Vector2f> polygon);
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,525 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <aabb.hpp>
+
+namespace Engine
+{
+	namespace detail
+	{
+		/**
+		* @brief Traversal stack that lives on the call stack for typical tree heights
+		* and spills into the heap only for degenerate trees
+		*/
+		class NodeStack
+		{
+		public:
+			void Push(int32_t node)
+			{
+				if (_size < _local.size())
+				{
+					_local[_size] = node;
+				}
+				else
+				{
+					_overflow.push_back(node);
+				}
+
+				_size++;
+			}
+
+			int32_t Pop()
+			{
+				_size--;
+
+				if (_size < _local.size())
+				{
+					return _local[_size];
+				}
+
+				int32_t node = _overflow.back();
+				_overflow.pop_back();
+				return node;
+			}
+
+			bool Empty() const noexcept
+			{
+				return _size == 0;
+			}
+
+		private:
+			std::array<int32_t, 256> _local{};
+			std::vector<int32_t> _overflow;
+			size_t _size = 0;
+		};
+	} // namespace detail
+
+	/**
+	* @brief Dynamic bounding volume hierarchy used as collision broadphase.
+	* Leaves store fattened AABBs of the shapes, so a shape that moves a little
+	* doesn't have to be reinserted. The tree is kept balanced with AVL-like rotations
+	* @tparam T: user data stored in each proxy (e.g. sf::Shape*)
+	*/
+	template <typename T>
+	class DynamicAabbTree
+	{
+	public:
+		using ProxyPair = std::pair<int32_t, int32_t>;
+
+		static constexpr int32_t NULL_NODE = -1;
+
+		/**
+		* @brief Creates an empty tree
+		* @param margin: how much a proxy AABB is enlarged on every side
+		* @param displacementMultiplier: how far ahead a moving proxy AABB is extended in the direction of motion
+		*/
+		explicit DynamicAabbTree(float margin = 4.f, float displacementMultiplier = 4.f)
+			: _root(NULL_NODE), _freeList(NULL_NODE), _proxyCount(0), _margin(margin), _displacementMultiplier(displacementMultiplier) {}
+
+		/**
+		* @brief Inserts a proxy for the object into the tree
+		* @param aabb: tight bounds of the object
+		* @param userData: value that is returned for the proxy by queries
+		* @returns proxy id, stays valid until the proxy is destroyed
+		*/
+		int32_t CreateProxy(const Aabb& aabb, const T& userData)
+		{
+			int32_t proxyId = AllocateNode();
+			_nodes[proxyId].Box = aabb.Fattened(_margin);
+			_nodes[proxyId].UserData = userData;
+			_nodes[proxyId].Height = 0;
+			InsertLeaf(proxyId);
+			_proxyCount++;
+			return proxyId;
+		}
+
+		/**
+		* @brief Removes the proxy from the tree
+		* @param proxyId: id returned by CreateProxy
+		*/
+		void DestroyProxy(int32_t proxyId)
+		{
+			RemoveLeaf(proxyId);
+			FreeNode(proxyId);
+			_proxyCount--;
+		}
+
+		/**
+		* @brief Updates the proxy after its object has moved
+		* @param proxyId: id returned by CreateProxy
+		* @param aabb: new tight bounds of the object
+		* @param displacement: how far the object has moved since the last update
+		* @returns true if the proxy was reinserted, false if the fattened AABB still contains the object
+		*/
+		bool MoveProxy(int32_t proxyId, const Aabb& aabb, const sf::Vector2f& displacement)
+		{
+			Aabb fatAabb = aabb.Fattened(_margin);
+			sf::Vector2f predicted = _displacementMultiplier * displacement;
+
+			if (predicted.x < 0.f)
+			{
+				fatAabb.Lower.x += predicted.x;
+			}
+			else
+			{
+				fatAabb.Upper.x += predicted.x;
+			}
+
+			if (predicted.y < 0.f)
+			{
+				fatAabb.Lower.y += predicted.y;
+			}
+			else
+			{
+				fatAabb.Upper.y += predicted.y;
+			}
+
+			const Aabb& treeAabb = _nodes[proxyId].Box;
+
+			if (treeAabb.Contains(aabb))
+			{
+				// the stored box may have become too large (object moved fast and then stopped),
+				// reinsert it only in that case to keep queries tight
+				Aabb hugeAabb = fatAabb.Fattened(4.f * _margin);
+
+				if (hugeAabb.Contains(treeAabb))
+				{
+					return false;
+				}
+			}
+
+			RemoveLeaf(proxyId);
+			_nodes[proxyId].Box = fatAabb;
+			InsertLeaf(proxyId);
+			return true;
+		}
+
+		const T& GetUserData(int32_t proxyId) const
+		{
+			return _nodes[proxyId].UserData;
+		}
+
+		const Aabb& GetFatAabb(int32_t proxyId) const
+		{
+			return _nodes[proxyId].Box;
+		}
+
+		size_t GetProxyCount() const noexcept
+		{
+			return _proxyCount;
+		}
+
+		/**
+		* @returns height of the tree, 0 for a single leaf and -1 for an empty tree
+		*/
+		int32_t GetHeight() const noexcept
+		{
+			return _root == NULL_NODE ? -1 : _nodes[_root].Height;
+		}
+
+		/**
+		* @brief Calls callback(proxyId) for each proxy whose fattened AABB overlaps the box
+		* @param aabb: query box
+		* @param callback: returns false to stop the query
+		*/
+		template <typename Callback>
+		void Query(const Aabb& aabb, Callback&& callback) const
+		{
+			Traverse([&aabb](const Aabb& box) { return box.Overlaps(aabb); }, callback);
+		}
+
+		/**
+		* @brief Walks the subtrees whose boxes pass the test and calls callback(proxyId) for each leaf that passes it,
+		* e.g. for ray queries. The test may change between calls, a shrinking ray skips more nodes
+		* @param test: callable with (const Aabb& fattenedBox) returning false to skip the node
+		* @param callback: returns false to stop the traversal
+		*/
+		template <typename Test, typename Callback>
+		void Traverse(Test&& test, Callback&& callback) const
+		{
+			if (_root == NULL_NODE)
+			{
+				return;
+			}
+
+			detail::NodeStack stack;
+			stack.Push(_root);
+
+			while (!stack.Empty())
+			{
+				int32_t nodeId = stack.Pop();
+				const TreeNode& node = _nodes[nodeId];
+
+				if (!test(node.Box))
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					if (!callback(nodeId))
+					{
+						return;
+					}
+				}
+				else
+				{
+					stack.Push(node.Child1);
+					stack.Push(node.Child2);
+				}
+			}
+		}
+
+		/**
+		* @brief Finds all pairs of proxies with overlapping fattened AABBs
+		* @param pairs: output, cleared first; each pair is stored as (smaller id, bigger id) and pairs are sorted
+		*/
+		void QueryOverlappingPairs(std::vector<ProxyPair>& pairs) const
+		{
+			pairs.clear();
+
+			for (int32_t proxyId = 0; proxyId < static_cast<int32_t>(_nodes.size()); proxyId++)
+			{
+				if (!_nodes[proxyId].IsLeaf())
+				{
+					continue;
+				}
+
+				Query(_nodes[proxyId].Box, [&](int32_t otherId)
+				{
+					// every pair is met twice, keep only one of them
+					if (proxyId < otherId)
+					{
+						pairs.emplace_back(proxyId, otherId);
+					}
+
+					return true;
+				});
+			}
+
+			std::ranges::sort(pairs);
+		}
+
+	private:
+		struct TreeNode
+		{
+			bool IsLeaf() const noexcept
+			{
+				return Height == 0;
+			}
+
+			Aabb Box;
+			T UserData{};
+			// parent for nodes in the tree, next free node for nodes in the free list
+			int32_t Parent = NULL_NODE;
+			int32_t Child1 = NULL_NODE;
+			int32_t Child2 = NULL_NODE;
+			// -1 for free nodes, 0 for leaves
+			int32_t Height = -1;
+		};
+
+		int32_t AllocateNode()
+		{
+			if (_freeList == NULL_NODE)
+			{
+				_nodes.emplace_back();
+				return static_cast<int32_t>(_nodes.size() - 1);
+			}
+
+			int32_t nodeId = _freeList;
+			_freeList = _nodes[nodeId].Parent;
+			_nodes[nodeId] = TreeNode{};
+			return nodeId;
+		}
+
+		void FreeNode(int32_t nodeId)
+		{
+			_nodes[nodeId].Parent = _freeList;
+			_nodes[nodeId].Height = -1;
+			_freeList = nodeId;
+		}
+
+		void InsertLeaf(int32_t leaf)
+		{
+			if (_root == NULL_NODE)
+			{
+				_root = leaf;
+				_nodes[_root].Parent = NULL_NODE;
+				return;
+			}
+
+			// find the best sibling by the perimeter cost
+			Aabb leafAabb = _nodes[leaf].Box;
+			int32_t index = _root;
+
+			while (!_nodes[index].IsLeaf())
+			{
+				int32_t child1 = _nodes[index].Child1;
+				int32_t child2 = _nodes[index].Child2;
+
+				float perimeter = _nodes[index].Box.Perimeter();
+				float combinedPerimeter = Aabb::Union(_nodes[index].Box, leafAabb).Perimeter();
+
+				// cost of creating a new parent for this node and the new leaf
+				float cost = 2.f * combinedPerimeter;
+
+				// minimum cost of pushing the leaf further down the tree
+				float inheritanceCost = 2.f * (combinedPerimeter - perimeter);
+
+				float cost1 = DescendCost(child1, leafAabb) + inheritanceCost;
+				float cost2 = DescendCost(child2, leafAabb) + inheritanceCost;
+
+				if (cost < cost1 && cost < cost2)
+				{
+					break;
+				}
+
+				index = cost1 < cost2 ? child1 : child2;
+			}
+
+			int32_t sibling = index;
+			int32_t oldParent = _nodes[sibling].Parent;
+			int32_t newParent = AllocateNode();
+			_nodes[newParent].Parent = oldParent;
+			_nodes[newParent].Box = Aabb::Union(leafAabb, _nodes[sibling].Box);
+			_nodes[newParent].Height = _nodes[sibling].Height + 1;
+			_nodes[newParent].Child1 = sibling;
+			_nodes[newParent].Child2 = leaf;
+			_nodes[sibling].Parent = newParent;
+			_nodes[leaf].Parent = newParent;
+
+			if (oldParent != NULL_NODE)
+			{
+				ReplaceChild(oldParent, sibling, newParent);
+			}
+			else
+			{
+				_root = newParent;
+			}
+
+			FixUpwards(_nodes[leaf].Parent);
+		}
+
+		void RemoveLeaf(int32_t leaf)
+		{
+			if (leaf == _root)
+			{
+				_root = NULL_NODE;
+				return;
+			}
+
+			int32_t parent = _nodes[leaf].Parent;
+			int32_t grandParent = _nodes[parent].Parent;
+			int32_t sibling = _nodes[parent].Child1 == leaf ? _nodes[parent].Child2 : _nodes[parent].Child1;
+
+			if (grandParent != NULL_NODE)
+			{
+				// connect sibling to grand parent and destroy the parent
+				ReplaceChild(grandParent, parent, sibling);
+				_nodes[sibling].Parent = grandParent;
+				FreeNode(parent);
+				FixUpwards(grandParent);
+			}
+			else
+			{
+				_root = sibling;
+				_nodes[sibling].Parent = NULL_NODE;
+				FreeNode(parent);
+			}
+		}
+
+		float DescendCost(int32_t child, const Aabb& leafAabb) const
+		{
+			float combinedPerimeter = Aabb::Union(leafAabb, _nodes[child].Box).Perimeter();
+
+			if (_nodes[child].IsLeaf())
+			{
+				return combinedPerimeter;
+			}
+
+			return combinedPerimeter - _nodes[child].Box.Perimeter();
+		}
+
+		void ReplaceChild(int32_t parent, int32_t oldChild, int32_t newChild)
+		{
+			if (_nodes[parent].Child1 == oldChild)
+			{
+				_nodes[parent].Child1 = newChild;
+			}
+			else
+			{
+				_nodes[parent].Child2 = newChild;
+			}
+		}
+
+		/**
+		* @brief Rebalances the branch and refits heights and boxes from the node up to the root
+		*/
+		void FixUpwards(int32_t index)
+		{
+			while (index != NULL_NODE)
+			{
+				index = Balance(index);
+
+				int32_t child1 = _nodes[index].Child1;
+				int32_t child2 = _nodes[index].Child2;
+
+				_nodes[index].Height = 1 + std::max(_nodes[child1].Height, _nodes[child2].Height);
+				_nodes[index].Box = Aabb::Union(_nodes[child1].Box, _nodes[child2].Box);
+
+				index = _nodes[index].Parent;
+			}
+		}
+
+		/**
+		* @brief Performs a left or right rotation if node A is imbalanced
+		* @returns index of the node that took A's place
+		*/
+		int32_t Balance(int32_t iA)
+		{
+			TreeNode& A = _nodes[iA];
+
+			if (A.IsLeaf() || A.Height < 2)
+			{
+				return iA;
+			}
+
+			int32_t iB = A.Child1;
+			int32_t iC = A.Child2;
+			int32_t balance = _nodes[iC].Height - _nodes[iB].Height;
+
+			if (balance > 1)
+			{
+				return Rotate(iA, iC, iB, false);
+			}
+
+			if (balance < -1)
+			{
+				return Rotate(iA, iB, iC, true);
+			}
+
+			return iA;
+		}
+
+		/**
+		* @brief Lifts the higher child of A up and places A under it
+		* @param iA: imbalanced node
+		* @param iUp: A's child to rotate up
+		* @param iStay: A's other child
+		* @param upIsChild1: true if iUp is A's first child
+		* @returns index of the lifted node
+		*/
+		int32_t Rotate(int32_t iA, int32_t iUp, int32_t iStay, bool upIsChild1)
+		{
+			TreeNode& A = _nodes[iA];
+			TreeNode& up = _nodes[iUp];
+
+			int32_t iF = up.Child1;
+			int32_t iG = up.Child2;
+
+			// swap A and its child
+			up.Child1 = iA;
+			up.Parent = A.Parent;
+			A.Parent = iUp;
+
+			if (up.Parent != NULL_NODE)
+			{
+				ReplaceChild(up.Parent, iA, iUp);
+			}
+			else
+			{
+				_root = iUp;
+			}
+
+			// the higher grandchild stays under the lifted node, the lower one goes to A
+			int32_t iHigh = _nodes[iF].Height > _nodes[iG].Height ? iF : iG;
+			int32_t iLow = iHigh == iF ? iG : iF;
+
+			up.Child2 = iHigh;
+			(upIsChild1 ? A.Child1 : A.Child2) = iLow;
+			_nodes[iLow].Parent = iA;
+
+			A.Box = Aabb::Union(_nodes[iStay].Box, _nodes[iLow].Box);
+			up.Box = Aabb::Union(A.Box, _nodes[iHigh].Box);
+
+			A.Height = 1 + std::max(_nodes[iStay].Height, _nodes[iLow].Height);
+			up.Height = 1 + std::max(A.Height, _nodes[iHigh].Height);
+
+			return iUp;
+		}
+
+		std::vector<TreeNode> _nodes;
+		int32_t _root;
+		int32_t _freeList;
+		size_t _proxyCount;
+		float _margin;
+		float _displacementMultiplier;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+#include <collision_hull.hpp>
+
+namespace Engine
+{
+	namespace detail
+	{
+		/**
+		* @brief Point of the Minkowski difference A - B with the vertices it was made of
+		*/
+		struct MinkowskiVertex
+		{
+			sf::Vector2f Point;
+			uint32_t IndexA;
+			uint32_t IndexB;
+		};
+	} // namespace detail
+
+	/**
+	* @brief State kept between GJK queries of the same shape pair. Support searches start
+	* from the vertices found last time, so a slowly moving pair needs just a few steps per search
+	*/
+	struct GjkCache
+	{
+		uint32_t SupportA = 0;
+		uint32_t SupportB = 0;
+		// last search direction, the first direction of the next query
+		sf::Vector2f Direction;
+		// EPA polytope, kept to reuse its memory
+		std::vector<detail::MinkowskiVertex> Polytope;
+	};
+
+	namespace detail
+	{
+		/**
+		* @brief Finds the vertex with the biggest projection onto the direction by hill climbing.
+		* On a convex polygon projections along the boundary have a single maximum,
+		* so the walk goes to the better neighbour until neither neighbour is better
+		* @param vertices: strictly convex polygon
+		* @param direction: search direction, doesn't have to be unit
+		* @param start: vertex to start from
+		*/
+		inline uint32_t supportIndex(const std::vector<sf::Vector2f>& vertices, const sf::Vector2f& direction, uint32_t start)
+		{
+			const size_t VERTICES = vertices.size();
+			size_t index = start < VERTICES ? start : 0;
+			float best = dot(vertices[index], direction);
+
+			size_t next = index + 1 == VERTICES ? 0 : index + 1;
+			bool forward = dot(vertices[next], direction) > best;
+
+			// a full turn means every vertex has the same projection (degenerate polygon)
+			for (size_t steps = 0; steps < VERTICES; steps++)
+			{
+				size_t candidate = forward ? (index + 1 == VERTICES ? 0 : index + 1) : (index == 0 ? VERTICES - 1 : index - 1);
+				float projection = dot(vertices[candidate], direction);
+
+				if (projection <= best)
+				{
+					break;
+				}
+
+				best = projection;
+				index = candidate;
+			}
+
+			return static_cast<uint32_t>(index);
+		}
+
+		/**
+		* @brief Support point of A - B: the farthest point of A along the direction minus the farthest point of B against it
+		*/
+		inline MinkowskiVertex minkowskiSupport(const std::vector<sf::Vector2f>& a, const std::vector<sf::Vector2f>& b, const sf::Vector2f& direction, GjkCache& cache)
+		{
+			cache.SupportA = supportIndex(a, direction, cache.SupportA);
+			cache.SupportB = supportIndex(b, -direction, cache.SupportB);
+			return MinkowskiVertex{ a[cache.SupportA] - b[cache.SupportB], cache.SupportA, cache.SupportB };
+		}
+
+		/**
+		* @brief Perpendicular to the edge that points to the same side as the reference vector
+		*/
+		inline sf::Vector2f perpendicularTowards(const sf::Vector2f& edge, const sf::Vector2f& reference)
+		{
+			sf::Vector2f perpendicular{ -edge.y, edge.x };
+			return dot(perpendicular, reference) < 0.f ? -perpendicular : perpendicular;
+		}
+
+		/**
+		* @brief GJK simplex, the newest vertex is the last one
+		*/
+		struct Simplex
+		{
+			std::array<MinkowskiVertex, 3> Vertices;
+			size_t Count = 0;
+		};
+
+		/**
+		* @brief Reduces the simplex to the feature closest to the origin and picks the next search direction
+		* @returns true if the simplex contains the origin
+		*/
+		inline bool updateSimplex(Simplex& simplex, sf::Vector2f& direction)
+		{
+			const MinkowskiVertex newest = simplex.Vertices[simplex.Count - 1];
+			sf::Vector2f toOrigin = -newest.Point;
+
+			if (simplex.Count == 2)
+			{
+				sf::Vector2f ab = simplex.Vertices[0].Point - newest.Point;
+
+				if (dot(ab, toOrigin) <= 0.f)
+				{
+					simplex.Vertices[0] = newest;
+					simplex.Count = 1;
+					direction = toOrigin;
+					return false;
+				}
+
+				direction = perpendicularTowards(ab, toOrigin);
+
+				// the origin lies on the segment
+				return dot(direction, toOrigin) == 0.f;
+			}
+
+			sf::Vector2f ab = simplex.Vertices[1].Point - newest.Point;
+			sf::Vector2f ac = simplex.Vertices[0].Point - newest.Point;
+			sf::Vector2f abOutside = -perpendicularTowards(ab, ac);
+			sf::Vector2f acOutside = -perpendicularTowards(ac, ab);
+
+			if (dot(abOutside, toOrigin) > 0.f)
+			{
+				simplex.Vertices = { simplex.Vertices[1], newest, newest };
+				simplex.Count = 2;
+				direction = abOutside;
+				return false;
+			}
+
+			if (dot(acOutside, toOrigin) > 0.f)
+			{
+				simplex.Vertices = { simplex.Vertices[0], newest, newest };
+				simplex.Count = 2;
+				direction = acOutside;
+				return false;
+			}
+
+			return true;
+		}
+
+		/**
+		* @brief Checks if the origin lies in A - B
+		* @param simplex: output, the last simplex
+		* @returns false if the shapes are separated
+		*/
+		inline bool gjkIntersection(const std::vector<sf::Vector2f>& a, const std::vector<sf::Vector2f>& b, GjkCache& cache, Simplex& simplex)
+		{
+			sf::Vector2f direction = cache.Direction;
+
+			if (direction == sf::Vector2f{})
+			{
+				direction = a[0] - b[0];
+			}
+
+			if (direction == sf::Vector2f{})
+			{
+				direction = sf::Vector2f{ 1.f, 0.f };
+			}
+
+			simplex.Vertices[0] = minkowskiSupport(a, b, direction, cache);
+			simplex.Count = 1;
+			direction = -simplex.Vertices[0].Point;
+
+			// every iteration reaches a new support point, so a polygon pair can't need more.
+			// Running out of iterations happens only when the origin lies on the boundary
+			const size_t MAX_ITERATIONS = a.size() + b.size() + 4;
+
+			for (size_t i = 0; i < MAX_ITERATIONS; i++)
+			{
+				if (direction == sf::Vector2f{})
+				{
+					// the origin is one of the simplex vertices, shapes touch
+					return true;
+				}
+
+				MinkowskiVertex vertex = minkowskiSupport(a, b, direction, cache);
+
+				if (dot(vertex.Point, direction) < 0.f)
+				{
+					cache.Direction = direction;
+					return false;
+				}
+
+				simplex.Vertices[simplex.Count++] = vertex;
+
+				if (updateSimplex(simplex, direction))
+				{
+					cache.Direction = direction;
+					return true;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		* @brief Expands the GJK simplex into the polytope edge closest to the origin (EPA)
+		* @param state: output, MTV of A along the edge normal and the penetrating vertex
+		*/
+		inline void expandPolytope(const std::vector<sf::Vector2f>& a, const std::vector<sf::Vector2f>& b, const Simplex& simplex, GjkCache& cache, SatState& state)
+		{
+			std::vector<MinkowskiVertex>& polytope = cache.Polytope;
+			polytope.assign(simplex.Vertices.begin(), simplex.Vertices.begin() + simplex.Count);
+
+			// the origin is on a vertex or an edge of the simplex, the shapes only touch
+			if (polytope.size() < 3 || cross(polytope[1].Point - polytope[0].Point, polytope[2].Point - polytope[0].Point) == 0.f)
+			{
+				state.LengthMTV = 0.f;
+				state.MinimumTranslationVector = sf::Vector2f{};
+				state.AxisMTV = sf::Vector2f{};
+				state.PointOfCollision = a[polytope[0].IndexA];
+				return;
+			}
+
+			// keep counterclockwise winding, so (edge.y, -edge.x) points outwards
+			if (cross(polytope[1].Point - polytope[0].Point, polytope[2].Point - polytope[0].Point) < 0.f)
+			{
+				std::swap(polytope[1], polytope[2]);
+			}
+
+			const size_t MAX_ITERATIONS = a.size() + b.size() + 4;
+			size_t closestEdge = 0;
+			sf::Vector2f closestNormal;
+			float closestDistance = 0.f;
+
+			for (size_t iteration = 0; iteration < MAX_ITERATIONS; iteration++)
+			{
+				closestDistance = std::numeric_limits<float>::infinity();
+
+				for (size_t i = 0; i < polytope.size(); i++)
+				{
+					sf::Vector2f edge = polytope[(i + 1) % polytope.size()].Point - polytope[i].Point;
+					sf::Vector2f edgeNormal = unit(sf::Vector2f{ edge.y, -edge.x });
+					float distance = dot(edgeNormal, polytope[i].Point);
+
+					if (distance < closestDistance)
+					{
+						closestDistance = distance;
+						closestNormal = edgeNormal;
+						closestEdge = i;
+					}
+				}
+
+				MinkowskiVertex vertex = minkowskiSupport(a, b, closestNormal, cache);
+				float supportDistance = dot(vertex.Point, closestNormal);
+
+				bool isKnown = false;
+
+				for (const auto& polytopeVertex : polytope)
+				{
+					isKnown = isKnown || (polytopeVertex.IndexA == vertex.IndexA && polytopeVertex.IndexB == vertex.IndexB);
+				}
+
+				// the polytope boundary has reached the boundary of A - B
+				if (isKnown || supportDistance - closestDistance <= 1e-5f * std::max(1.f, std::abs(supportDistance)))
+				{
+					break;
+				}
+
+				polytope.insert(polytope.begin() + closestEdge + 1, vertex);
+			}
+
+			const MinkowskiVertex& first = polytope[closestEdge];
+			const MinkowskiVertex& second = polytope[(closestEdge + 1) % polytope.size()];
+
+			// an edge made of one vertex of A is an edge of B with A's vertex pushed into it, and vice versa
+			if (first.IndexA == second.IndexA || first.IndexB != second.IndexB)
+			{
+				state.PointOfCollision = a[first.IndexA];
+			}
+			else
+			{
+				state.PointOfCollision = b[first.IndexB];
+			}
+
+			state.LengthMTV = std::max(closestDistance, 0.f);
+			state.MinimumTranslationVector = closestNormal * state.LengthMTV;
+			state.AxisMTV = closestNormal;
+		}
+	} // namespace detail
+
+	/**
+	* @brief Vertex count of both shapes together from which GJK/EPA is used instead of SAT over vertex vectors.
+	* This isn't a speed crossover: bench/gjk_bench has GJK ahead from triangles on. The limit keeps boxes,
+	* triangles and other simple pairs on SAT, so their point of collision stays where the resolution expects it,
+	* and leaves GJK to detailed shapes where it saves the most
+	*/
+	inline constexpr size_t GJK_MIN_VERTICES = 12;
+
+	/**
+	* @brief Vertex count of both hulls together from which GJK/EPA is used instead of SAT over cached hull axes,
+	* chosen for the point of collision like GJK_MIN_VERTICES
+	*/
+	inline constexpr size_t GJK_MIN_HULL_VERTICES = 12;
+
+	/**
+	* @brief Checks two convex shapes for a collision with GJK and finds the MTV with EPA.
+	* Support points are found by hill climbing, so the cost grows slower than the vertex count
+	* @param aShapeVertices: first shape vertices, strictly convex
+	* @param bShapeVertices: second shape vertices, strictly convex
+	* @param cache: state of the pair from the previous query
+	* @return whether the shapes collide and the MTV (length and direction) as processCollision gives them up to rounding.
+	* The point of collision differs: it's the vertex of one shape that is pushed deepest into the other,
+	* not the point SAT picks
+	*/
+	inline std::optional<CollisionResponse> gjkCollision(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices, GjkCache& cache)
+	{
+		detail::Simplex simplex;
+
+		if (!detail::gjkIntersection(aShapeVertices, bShapeVertices, cache, simplex))
+		{
+			return std::nullopt;
+		}
+
+		detail::SatState state;
+		detail::expandPolytope(aShapeVertices, bShapeVertices, simplex, cache, state);
+		return detail::orientedResponse(state, centroid(aShapeVertices), centroid(bShapeVertices));
+	}
+
+	/**
+	* @brief Checks two convex shapes for a collision with GJK/EPA without a cache from previous queries
+	*/
+	inline std::optional<CollisionResponse> gjkCollision(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices)
+	{
+		GjkCache cache;
+		return gjkCollision(aShapeVertices, bShapeVertices, cache);
+	}
+
+	/**
+	* @brief Checks two cached hulls for a collision with GJK/EPA, uses cached centroids
+	*/
+	inline std::optional<CollisionResponse> gjkCollision(const CollisionHull& a, const CollisionHull& b, GjkCache& cache)
+	{
+		detail::Simplex simplex;
+
+		if (!detail::gjkIntersection(a.GetVertices(), b.GetVertices(), cache, simplex))
+		{
+			return std::nullopt;
+		}
+
+		detail::SatState state;
+		detail::expandPolytope(a.GetVertices(), b.GetVertices(), simplex, cache, state);
+		return detail::orientedResponse(state, a.GetCentroid(), b.GetCentroid());
+	}
+
+	/**
+	* @brief Checks two shapes for a collision with SAT for small polygons and GJK/EPA for detailed ones.
+	* Both give the same MTV, only the point of collision depends on the choice
+	* @param aShapeVertices: first shape vertices
+	* @param bShapeVertices: second shape vertices
+	* @param scratch: SAT buffers
+	* @param cache: GJK state of the pair
+	*/
+	inline std::optional<CollisionResponse> processCollisionAdaptive(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices, CollisionScratch& scratch, GjkCache& cache)
+	{
+		if (aShapeVertices.size() + bShapeVertices.size() >= GJK_MIN_VERTICES)
+		{
+			return gjkCollision(aShapeVertices, bShapeVertices, cache);
+		}
+
+		return processCollision(aShapeVertices, bShapeVertices, scratch);
+	}
+
+	/**
+	* @brief Checks two hulls for a collision with SAT for small polygons and GJK/EPA for detailed ones
+	*/
+	inline std::optional<CollisionResponse> processCollisionAdaptive(const CollisionHull& a, const CollisionHull& b, GjkCache& cache)
+	{
+		if (a.GetVertices().size() + b.GetVertices().size() >= GJK_MIN_HULL_VERTICES)
+		{
+			return gjkCollision(a, b, cache);
+		}
+
+		return processCollision(a, b);
+	}
+} // namespace Engine
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <unordered_set>
 #include <SFML/System.hpp>
@@ -9,6 +15,7 @@
 
 #include <projection.hpp>
 #include <collision_response.hpp>
+#include <profiler.hpp>
 
 namespace Engine
 {
@@ -16,7 +23,7 @@ namespace Engine
 	* @brief calculates normal vector from a vector
 	* @param a: vector (or an edge)
 	*/
-	sf::Vector2f normal(const sf::Vector2f& a)
+	inline sf::Vector2f normal(const sf::Vector2f& a)
 	{
 		float x = -a.y;
 		float y = a.x;
@@ -26,7 +33,7 @@ namespace Engine
 		return sf::Vector2f{ x, y };
 	}
 
-	float dot(const sf::Vector2f& a, const sf::Vector2f& b)
+	constexpr float dot(const sf::Vector2f& a, const sf::Vector2f& b)
 	{
 		return a.x * b.x + a.y * b.y;
 	}
@@ -36,7 +43,7 @@ namespace Engine
 	* @param vertices: shape vertices
 	* @returns shape area
 	*/
-	float orientedArea(const std::vector<sf::Vector2f>& vertices)
+	inline float orientedArea(const std::vector<sf::Vector2f>& vertices)
 	{
 		float sum = 0.f;
 
@@ -54,8 +61,9 @@ namespace Engine
 	* @param vertices: shape vertices
 	* @returns coordinates of centroid
 	*/
-	sf::Vector2f centroid(const std::vector<sf::Vector2f>& vertices)
+	inline sf::Vector2f centroid(const std::vector<sf::Vector2f>& vertices)
 	{
+		ENGINE_PROFILE_SCOPE(Centroid);
 		float x = 0.f;
 		float y = 0.f;
 		float sArea = orientedArea(vertices);
@@ -77,7 +85,7 @@ namespace Engine
 	* @param b: shape edge end
 	* @param vertex: point for which to create a projection 
 	*/
-	float projection(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& vertex)
+	inline float projection(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& vertex)
 	{
 		sf::Vector2f line = b - a;
 		sf::Vector2f normalVector = normal(line);
@@ -91,7 +99,7 @@ namespace Engine
 	* @param vertex: point for which to create a projection
 	* @returns point 1D projection onto a normal's axis
 	*/
-	float projectionWithNormal(const sf::Vector2f& normalVector, const sf::Vector2f& vertex)
+	constexpr float projectionWithNormal(const sf::Vector2f& normalVector, const sf::Vector2f& vertex)
 	{
 		float projection = Engine::dot(vertex, normalVector);
 		return projection;
@@ -101,23 +109,9 @@ namespace Engine
 	* @brief calculates shape's edges as sf::Vector2f vectors
 	* @param shapeVertices: shape vertices coordinates
 	*/
-	std::vector<std::pair<sf::Vector2f, sf::Vector2f>> getShapeEdges(const std::vector<sf::Vector2f>& shapeVertices)
-	{
-		const size_t VERTICES = shapeVertices.size();
-		const size_t LAST = VERTICES - 1;
-		std::vector<std::pair<sf::Vector2f, sf::Vector2f>> edges(VERTICES);
-
-		for (size_t i = 1; i < VERTICES; i++)
-		{
-			edges[i - 1] = std::make_pair(shapeVertices[i - 1], shapeVertices[i]);
-		}
-
-		edges[LAST] = std::make_pair(shapeVertices[LAST], shapeVertices[0]);
+	std::vector<std::pair<sf::Vector2f, sf::Vector2f>> getShapeEdges(const std::vector<sf::Vector2f>& shapeVertices);
 
-		return edges;
-	}		
-
-	sf::Vector2f unit(const sf::Vector2f& v)
+	inline sf::Vector2f unit(const sf::Vector2f& v)
 	{
 		float magnitude = std::sqrt(v.x * v.x + v.y * v.y);
 		return v / magnitude;
@@ -129,7 +123,7 @@ namespace Engine
 	* @param b: second vector
 	* @return the direction of vectors rotation
 	*/
-	float cross(const sf::Vector2f& a, const sf::Vector2f& b)
+	constexpr float cross(const sf::Vector2f& a, const sf::Vector2f& b)
 	{
 		return a.x * b.y - b.x * a.y;
 	}
@@ -164,77 +158,139 @@ namespace Engine
 	};
 
 	/**
-	* @brief Checks two shapes for a collision between them. Uses SAT collision method and forms collision response
-	* @param aShapeVertices: first shape vertices
-	* @param bShapeVertices: second shape vertices
-	* @return std::nullopt if no collision detected, CollisionResponse in std::optional when there is collision
+	* @brief Caller-owned buffers reused by processCollision between calls.
+	* Buffers only grow, so once they fit the biggest shapes no heap allocations are made.
+	* Not thread-safe, use one scratch per thread
 	*/
-	std::optional<CollisionResponse> processCollision(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices)
+	struct CollisionScratch
 	{
-		static sf::Vector2f ZERO_VECTOR{ 0.f, 0.f };
+		/**
+		* @brief Preallocates buffers for shapes with given vertex counts
+		* @param aVertices: vertex count of the first shape
+		* @param bVertices: vertex count of the second shape
+		*/
+		void Reserve(size_t aVertices, size_t bVertices)
+		{
+			Axes.reserve(aVertices + bVertices);
+			AxisHashes.reserve(aVertices + bVertices);
+		}
 
-		auto aEdges = getShapeEdges(aShapeVertices);
-		auto bEdges = getShapeEdges(bShapeVertices);
+		void ClearAxes() noexcept
+		{
+			Axes.clear();
+			AxisHashes.clear();
+		}
 
-		std::vector<std::pair<sf::Vector2f, sf::Vector2f>> allEdges = aEdges;
-		std::ranges::copy(bEdges, std::back_inserter(allEdges));
+		/**
+		* @brief Remembers the edge as a tested axis
+		* @param edgeVector: shape edge
+		* @returns false if a collinear edge with the same VectorHash was already tested
+		*/
+		bool InsertAxis(const sf::Vector2f& edgeVector)
+		{
+			ENGINE_PROFILE_SCOPE(Axes);
+			std::size_t hash = VectorHash{}(edgeVector);
 
-		std::vector<Projection> projectionsA(aShapeVertices.size());
-		std::vector<Projection> projectionsB(bShapeVertices.size());
+			for (size_t k = 0; k < Axes.size(); k++)
+			{
+				if (AxisHashes[k] == hash && VectorCollinear{}(Axes[k], edgeVector))
+				{
+					ENGINE_PROFILE_COUNT(AxesSkipped, 1);
+					return false;
+				}
+			}
 
-		float lengthMTV = std::numeric_limits<float>::infinity();
-		sf::Vector2f pointOfCollision;
-		sf::Vector2f minimumTranslationVector;		
+			// both buffers grow together
+			ENGINE_PROFILE_COUNT(Allocations, Axes.size() == Axes.capacity() ? 2 : 0);
+			Axes.push_back(edgeVector);
+			AxisHashes.push_back(hash);
+			return true;
+		}
 
-		std::unordered_set<sf::Vector2f, VectorHash, VectorCollinear> axes;
+		// edge vectors of already tested axes and their VectorHash values
+		std::vector<sf::Vector2f> Axes;
+		std::vector<std::size_t> AxisHashes;
+	};
 
-		for (const auto& edge : allEdges)
-		{
-			sf::Vector2f edgeVector = edge.second - edge.first;
+	/**
+	* @brief Finds minimum and maximum projections of shape vertices onto an axis
+	* @param vertices: shape vertices
+	* @param normalVector: axis to project onto
+	* @returns pair of minimum and maximum projection, on ties the first vertex is kept
+	*/
+	inline std::pair<Projection, Projection> projectionBounds(std::span<const sf::Vector2f> vertices, const sf::Vector2f& normalVector)
+	{
+		Projection minProjection{ projectionWithNormal(normalVector, vertices[0]), 0 };
+		Projection maxProjection = minProjection;
 
-			if (axes.contains(edgeVector))
-			{
-				continue;
-			}
+		for (size_t j = 1; j < vertices.size(); j++)
+		{
+			Projection projection{ projectionWithNormal(normalVector, vertices[j]), j };
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
 
-			axes.insert(edgeVector);
-			sf::Vector2f normalVector = normal(edgeVector);
-			float edgeMagnitude = std::sqrt(edgeVector.x * edgeVector.x + edgeVector.y * edgeVector.y);
-			sf::Vector2f edgeNormalisedVector = edgeVector / edgeMagnitude;
+		return { minProjection, maxProjection };
+	}
 
-			// make each vertex projections
-			for (size_t j = 0; j < aShapeVertices.size(); j++)
-			{
-				float projection = projectionWithNormal(normalVector, aShapeVertices[j]);
-				projectionsA[j] = Projection{ projection, j };
-			}
+	/**
+	* @brief Finds minimum and maximum projections of a vertex count known at compile time,
+	* so the loop is unrolled. Same result as the overload for any vertex count
+	* @param vertices: shape vertices
+	* @param normalVector: axis to project onto
+	*/
+	template <size_t N>
+	std::pair<Projection, Projection> projectionBounds(std::span<const sf::Vector2f, N> vertices, const sf::Vector2f& normalVector)
+	{
+		Projection minProjection{ projectionWithNormal(normalVector, vertices[0]), 0 };
+		Projection maxProjection = minProjection;
 
-			for (size_t j = 0; j < bShapeVertices.size(); j++)
-			{
-				float projection = projectionWithNormal(normalVector, bShapeVertices[j]);
-				projectionsB[j] = Projection{ projection, j };
-			}
+		for (size_t j = 1; j < N; j++)
+		{
+			Projection projection{ projectionWithNormal(normalVector, vertices[j]), j };
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
 
-			// find minimum and maximum projections of each shape
-			Projection minProjectionA = projectionsA[0];
-			Projection maxProjectionA = projectionsA[0];
+		return { minProjection, maxProjection };
+	}
 
-			for (size_t j = 1; j < projectionsA.size(); j++)
-			{
-				minProjectionA = std::min(minProjectionA, projectionsA[j]);
-				maxProjectionA = std::max(maxProjectionA, projectionsA[j]);
-			}
+	namespace detail
+	{
+		/**
+		* @brief SAT result accumulated over the tested axes
+		*/
+		struct SatState
+		{
+			float LengthMTV = std::numeric_limits<float>::infinity();
+			sf::Vector2f PointOfCollision;
+			sf::Vector2f MinimumTranslationVector;
+			// unit axis the MTV lies on, stays valid when MTV length is 0
+			sf::Vector2f AxisMTV;
+		};
+
+		/**
+		* @brief Projects both shapes onto the axis and applies collision checking rules
+		* @param aShapeVertices: first shape vertices
+		* @param bShapeVertices: second shape vertices
+		* @param normalVector: unit axis
+		* @param state: updated with the overlap on this axis
+		* @returns false if the axis separates the shapes
+		*/
+		template <typename PolygonA, typename PolygonB>
+		bool overlapOnAxis(const PolygonA& aShapeVertices, const PolygonB& bShapeVertices, const sf::Vector2f& normalVector, SatState& state)
+		{
+			ENGINE_PROFILE_COUNT(AxesTested, 1);
 
-			Projection minProjectionB = projectionsB[0];
-			Projection maxProjectionB = projectionsB[0];
+			// find minimum and maximum projections of each shape
+			auto [minProjectionA, maxProjectionA] = projectionBounds(aShapeVertices, normalVector);
+			auto [minProjectionB, maxProjectionB] = projectionBounds(bShapeVertices, normalVector);
 
-			for (size_t j = 1; j < projectionsB.size(); j++)
+			if (minProjectionB > maxProjectionA || minProjectionA > maxProjectionB)
 			{
-				minProjectionB = std::min(minProjectionB, projectionsB[j]);
-				maxProjectionB = std::max(maxProjectionB, projectionsB[j]);
+				return false;
 			}
 
-			float overlapVectorLength = 0.f;
 			/*
 			* collision checking rules
 			*
@@ -243,49 +299,251 @@ namespace Engine
 			*
 			* for Amin > Bmin
 			* Bmin--------Amin=====Bmax--------Amax
+			*
+			* when one interval contains the other the shape is pushed out the shorter way,
+			* so an axis and its opposite give the same overlap
 			*/
+			float overlapVectorLength = std::min(maxProjectionA - minProjectionB, maxProjectionB - minProjectionA);
+
 			if (minProjectionA < minProjectionB)
 			{
-				if (minProjectionB > maxProjectionA)
+				state.PointOfCollision = aShapeVertices[maxProjectionA.GetPointIndex()];
+			}
+			else if (minProjectionA > minProjectionB)
+			{
+				state.PointOfCollision = bShapeVertices[maxProjectionB.GetPointIndex()];
+			}
+
+			if (overlapVectorLength < state.LengthMTV)
+			{
+				state.LengthMTV = overlapVectorLength;
+				state.MinimumTranslationVector = normalVector * state.LengthMTV;
+				state.AxisMTV = normalVector;
+			}
+
+			return true;
+		}
+
+		/**
+		* @brief Forms collision response with MTV pointing from shape B to shape A
+		* @param state: SAT result after all axes overlapped
+		* @param Acentroid: first shape centroid
+		* @param Bcentroid: second shape centroid
+		*/
+		inline CollisionResponse orientedResponse(const SatState& state, const sf::Vector2f& Acentroid, const sf::Vector2f& Bcentroid)
+		{
+			sf::Vector2f minimumTranslationVector = state.MinimumTranslationVector;
+			sf::Vector2f directionAB = Acentroid - Bcentroid;
+
+			// if the MTV and the direction from shape A to shape B are opposite, then dot(AB, MTV) < 0
+			// which means you have to rotate MTV by pi (negate it)
+			if (dot(minimumTranslationVector, directionAB) < 0.f)
+			{
+				minimumTranslationVector = -minimumTranslationVector;
+			}
+
+			return CollisionResponse{ state.PointOfCollision, minimumTranslationVector };
+		}
+
+		/**
+		* @brief SAT implementation shared by all vertex layouts.
+		* Polygon has to provide size() and operator[] returning sf::Vector2f,
+		* projectionBounds(polygon, axis) and centroid(polygon) are looked up for it
+		*/
+		template <typename Polygon>
+		std::optional<CollisionResponse> separatingAxisTest(const Polygon& aShapeVertices, const Polygon& bShapeVertices, CollisionScratch& scratch)
+		{
+			ENGINE_PROFILE_SCOPE(Sat);
+			ENGINE_PROFILE_COUNT(PairsTested, 1);
+			SatState state;
+			scratch.ClearAxes();
+
+			const size_t A_EDGES = aShapeVertices.size();
+			const size_t ALL_EDGES = A_EDGES + bShapeVertices.size();
+
+			// edges of shape A go first, then edges of shape B
+			for (size_t i = 0; i < ALL_EDGES; i++)
+			{
+				const Polygon& vertices = i < A_EDGES ? aShapeVertices : bShapeVertices;
+				size_t index = i < A_EDGES ? i : i - A_EDGES;
+				sf::Vector2f edgeVector = vertices[(index + 1) % vertices.size()] - vertices[index];
+
+				if (!scratch.InsertAxis(edgeVector))
 				{
+					continue;
+				}
+
+				if (!overlapOnAxis(aShapeVertices, bShapeVertices, normal(edgeVector), state))
+				{
+					ENGINE_PROFILE_COUNT(EarlySeparations, 1);
 					return std::nullopt;
 				}
+			}
+
+			return orientedResponse(state, centroid(aShapeVertices), centroid(bShapeVertices));
+		}
+
+		/**
+		* @brief centroid with the arithmetic of the std::vector overload, over a vertex count known at compile time
+		*/
+		template <size_t N>
+		sf::Vector2f fixedCentroid(std::span<const sf::Vector2f, N> vertices)
+		{
+			float sum = 0.f;
+
+			for (size_t i = 0; i < N; i++)
+			{
+				size_t nextIndex = (i + 1) % N;
+				sum += vertices[i].x * vertices[nextIndex].y - vertices[nextIndex].x * vertices[i].y;
+			}
+
+			float sArea = sum / 2;
+			float x = 0.f;
+			float y = 0.f;
+
+			for (size_t i = 0; i < N; i++)
+			{
+				size_t nextIndex = (i + 1) % N;
+				float ratio = vertices[i].x * vertices[nextIndex].y - vertices[nextIndex].x * vertices[i].y;
+				x += (vertices[i].x + vertices[nextIndex].x) * ratio;
+				y += (vertices[i].y + vertices[nextIndex].y) * ratio;
+			}
+
+			return sf::Vector2f{ x, y } / (6 * sArea);
+		}
+
+		/**
+		* @brief separatingAxisTest for vertex counts known at compile time: projection loops are unrolled
+		* and tested axes are kept on the stack. The same axes are skipped, so the result is the same
+		*/
+		template <size_t N, size_t M>
+		std::optional<CollisionResponse> fixedSeparatingAxisTest(std::span<const sf::Vector2f, N> aShapeVertices, std::span<const sf::Vector2f, M> bShapeVertices)
+		{
+			ENGINE_PROFILE_SCOPE(Sat);
+			ENGINE_PROFILE_COUNT(PairsTested, 1);
+			SatState state;
+			std::array<sf::Vector2f, N + M> axes;
+			size_t axisCount = 0;
+
+			// false if the edge gives a separating axis
+			auto testEdge = [&](const sf::Vector2f& edgeVector)
+			{
+				for (size_t k = 0; k < axisCount; k++)
+				{
+					if (VectorCollinear{}(axes[k], edgeVector) && VectorHash{}(axes[k]) == VectorHash{}(edgeVector))
+					{
+						ENGINE_PROFILE_COUNT(AxesSkipped, 1);
+						return true;
+					}
+				}
 
-				overlapVectorLength = maxProjectionA - minProjectionB;
-				pointOfCollision = aShapeVertices[maxProjectionA.GetPointIndex()];
+				axes[axisCount++] = edgeVector;
+				return overlapOnAxis(aShapeVertices, bShapeVertices, normal(edgeVector), state);
+			};
+
+			// edges of shape A go first, then edges of shape B
+			for (size_t i = 0; i < N; i++)
+			{
+				if (!testEdge(aShapeVertices[(i + 1) % N] - aShapeVertices[i]))
+				{
+					ENGINE_PROFILE_COUNT(EarlySeparations, 1);
+					return std::nullopt;
+				}
 			}
-			else if (minProjectionA > minProjectionB)
+
+			for (size_t i = 0; i < M; i++)
 			{
-				if (minProjectionA > maxProjectionB)
+				if (!testEdge(bShapeVertices[(i + 1) % M] - bShapeVertices[i]))
 				{
+					ENGINE_PROFILE_COUNT(EarlySeparations, 1);
 					return std::nullopt;
 				}
+			}
+
+			return orientedResponse(state, fixedCentroid(aShapeVertices), fixedCentroid(bShapeVertices));
+		}
+
+		/**
+		* @brief Routes the common pairs of triangles and quads to code specialized for their vertex counts
+		* @param fixed: called with both vertex counts as std::integral_constant
+		* @param generic: called for the other vertex counts
+		*/
+		template <typename Fixed, typename Generic>
+		auto dispatchVertexCounts(size_t aVertices, size_t bVertices, Fixed&& fixed, Generic&& generic)
+		{
+			using Triangle = std::integral_constant<size_t, 3>;
+			using Quad = std::integral_constant<size_t, 4>;
 
-				overlapVectorLength = maxProjectionB - minProjectionA;
-				pointOfCollision = bShapeVertices[minProjectionA.GetPointIndex()];
+			if (aVertices == 4 && bVertices == 4)
+			{
+				return fixed(Quad{}, Quad{});
 			}
 
-			if (overlapVectorLength < lengthMTV)
+			if (aVertices == 3 && bVertices == 3)
 			{
-				lengthMTV = overlapVectorLength;
-				minimumTranslationVector = normalVector * lengthMTV;
+				return fixed(Triangle{}, Triangle{});
 			}
-		}
 
-		sf::Vector2f Acentroid = centroid(aShapeVertices);
-		sf::Vector2f Bcentroid = centroid(bShapeVertices);
-		sf::Vector2f directionAB = Acentroid - Bcentroid;
+			if (aVertices == 3 && bVertices == 4)
+			{
+				return fixed(Triangle{}, Quad{});
+			}
 
-		// if the MTV and the direction from shape A to shape B are opposite, then dot(AB, MTV) < 0
-		// which means you have to rotate MTV by pi (negate it)
-		if (dot(minimumTranslationVector, directionAB) < 0.f)
-		{
-			minimumTranslationVector = -minimumTranslationVector;
+			if (aVertices == 4 && bVertices == 3)
+			{
+				return fixed(Quad{}, Triangle{});
+			}
+
+			return generic();
 		}
+	} // namespace detail
 
-		CollisionResponse response{ pointOfCollision, minimumTranslationVector };
+	/**
+	* @brief Checks two polygons with vertex counts known at compile time for a collision. Uses SAT collision method
+	* and forms collision response, the same as for vertex vectors, but unrolled and without allocations
+	* @param aShapeVertices: first shape vertices
+	* @param bShapeVertices: second shape vertices
+	* @return std::nullopt if no collision detected, CollisionResponse in std::optional when there is collision
+	*/
+	template <size_t N, size_t M>
+	std::optional<CollisionResponse> processCollision(const std::array<sf::Vector2f, N>& aShapeVertices, const std::array<sf::Vector2f, M>& bShapeVertices)
+	{
+		return detail::fixedSeparatingAxisTest(std::span<const sf::Vector2f, N>{ aShapeVertices }, std::span<const sf::Vector2f, M>{ bShapeVertices });
+	}
 
-		return std::optional<CollisionResponse>{ response };
+	/**
+	* @brief Checks two shapes for a collision between them. Uses SAT collision method and forms collision response.
+	* Triangles and quads go to the code for their vertex counts, other shapes don't allocate
+	* when scratch buffers are already big enough
+	* @param aShapeVertices: first shape vertices
+	* @param bShapeVertices: second shape vertices
+	* @param scratch: reusable buffers
+	* @return std::nullopt if no collision detected, CollisionResponse in std::optional when there is collision
+	*/
+	inline std::optional<CollisionResponse> processCollision(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices, CollisionScratch& scratch)
+	{
+		return detail::dispatchVertexCounts(aShapeVertices.size(), bShapeVertices.size(), [&](auto aVertices, auto bVertices)
+		{
+			constexpr size_t N = decltype(aVertices)::value;
+			constexpr size_t M = decltype(bVertices)::value;
+			return detail::fixedSeparatingAxisTest(std::span<const sf::Vector2f, N>{ aShapeVertices.data(), N }, std::span<const sf::Vector2f, M>{ bShapeVertices.data(), M });
+		},
+		[&]()
+		{
+			return detail::separatingAxisTest(aShapeVertices, bShapeVertices, scratch);
+		});
+	}
+
+	/**
+	* @brief Checks two shapes for a collision between them. Uses SAT collision method and forms collision response
+	* @param aShapeVertices: first shape vertices
+	* @param bShapeVertices: second shape vertices
+	* @return std::nullopt if no collision detected, CollisionResponse in std::optional when there is collision
+	*/
+	inline std::optional<CollisionResponse> processCollision(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices)
+	{
+		CollisionScratch scratch;
+		return processCollision(aShapeVertices, bShapeVertices, scratch);
 	}
 
 	/**
@@ -293,45 +551,12 @@ namespace Engine
 	* @param shape: a pointer to shape
 	* @returns a vector with actual vertex coordinates
 	*/
-	std::vector<sf::Vector2f> getVertices(sf::Shape* shape)
-	{
-		size_t verticesAmount = shape->getPointCount();
-		std::vector<sf::Vector2f> verteces(verticesAmount);
-		sf::Transform transform = shape->getTransform();
-
-		for (size_t i = 0; i < verticesAmount; i++)
-		{
-			verteces[i] = transform.transformPoint(shape->getPoint(i));
-		}
-
-		return verteces;
-	}	
+	std::vector<sf::Vector2f> getVertices(const sf::Shape* shape);
 
 	/**
 	* @brief Checks if the shape is concave
 	* @param shape: the inspected shape
 	* @returns true if the shape is concave, false if it's not
 	*/
-	bool isShapeConcave(sf::Shape* shape)
-	{
-		float previousRotateDirection = 0.f;
-		size_t verticesCount = shape->getPointCount();
-		std::vector<sf::Vector2f> vertices = getVertices(shape);
-
-		for (size_t i = 0; i < verticesCount; i++)
-		{
-			sf::Vector2f vectorPreviousVertex{ vertices[(i - 1 + verticesCount) % verticesCount] - vertices[i] };
-			sf::Vector2f vectorNextVertex{ vertices[(i + 1 + verticesCount) % verticesCount] - vertices[i] };
-			float currentRotateDirection = cross(vectorPreviousVertex, vectorNextVertex);
-
-			if (currentRotateDirection * previousRotateDirection < 0)
-			{
-				return true;
-			}
-
-			previousRotateDirection = currentRotateDirection;
-		}
-
-		return false;
-	}
+	bool isShapeConcave(sf::Shape* shape);
 } // namespace Engine
\ No newline at end of file
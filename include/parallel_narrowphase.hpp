@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <collision_response.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Thread pool that runs index ranges split into chunks. Every worker has its own chunk deque:
+	* it takes chunks from the back of its deque and steals from the front of the others when it runs out.
+	* The thread that calls ParallelFor works as worker 0, so a pool of 1 worker starts no threads
+	*/
+	class WorkStealingPool
+	{
+	public:
+		/**
+		* @brief Starts workerCount - 1 threads
+		* @param workerCount: workers including the calling thread, 0 means one per hardware thread
+		*/
+		explicit WorkStealingPool(size_t workerCount = 0)
+		{
+			if (workerCount == 0)
+			{
+				workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+			}
+
+			_queues = std::vector<ChunkQueue>(workerCount);
+
+			for (size_t worker = 1; worker < workerCount; worker++)
+			{
+				_threads.emplace_back([this, worker]() { WorkerLoop(worker); });
+			}
+		}
+
+		WorkStealingPool(const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+		~WorkStealingPool()
+		{
+			{
+				std::lock_guard lock{ _mutex };
+				_isStopping = true;
+			}
+
+			_wakeUp.notify_all();
+
+			for (auto& thread : _threads)
+			{
+				thread.join();
+			}
+		}
+
+		size_t GetWorkerCount() const noexcept
+		{
+			return _queues.size();
+		}
+
+		/**
+		* @brief Calls task(begin, end, worker) for chunks covering [0, count) and waits for all of them.
+		* Chunks of the same worker never run concurrently, so the worker index can select per-thread buffers
+		* @param count: size of the index range
+		* @param grain: maximum chunk size
+		* @param task: callable with (size_t begin, size_t end, size_t worker)
+		*/
+		template <typename Task>
+		void ParallelFor(size_t count, size_t grain, Task&& task)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			grain = std::max<size_t>(1, grain);
+			const size_t CHUNKS = (count + grain - 1) / grain;
+
+			// a worker that is late for the previous call may take a chunk as soon as it is queued,
+			// the queue mutex publishes the task to it
+			_pendingChunks.store(CHUNKS, std::memory_order_relaxed);
+			_task = &task;
+			_invoke = [](void* function, size_t begin, size_t end, size_t worker)
+			{
+				(*static_cast<std::remove_reference_t<Task>*>(function))(begin, end, worker);
+			};
+
+			// chunks are dealt in contiguous blocks, so every worker starts with neighbouring pairs
+			for (size_t chunk = 0; chunk < CHUNKS; chunk++)
+			{
+				ChunkQueue& queue = _queues[chunk * _queues.size() / CHUNKS];
+				std::lock_guard lock{ queue.Mutex };
+				queue.Chunks.push_back(Chunk{ chunk * grain, std::min(count, (chunk + 1) * grain) });
+			}
+
+			{
+				std::lock_guard lock{ _mutex };
+				_generation++;
+			}
+
+			_wakeUp.notify_all();
+			RunChunks(0);
+
+			// the last chunk may still be running on another worker
+			std::unique_lock lock{ _mutex };
+			_finished.wait(lock, [this]() { return _pendingChunks.load(std::memory_order_acquire) == 0 && _activeWorkers == 0; });
+		}
+
+	private:
+		struct Chunk
+		{
+			size_t Begin;
+			size_t End;
+		};
+
+		struct ChunkQueue
+		{
+			std::mutex Mutex;
+			std::deque<Chunk> Chunks;
+		};
+
+		void WorkerLoop(size_t worker)
+		{
+			uint64_t seenGeneration = 0;
+
+			while (true)
+			{
+				{
+					std::unique_lock lock{ _mutex };
+					_wakeUp.wait(lock, [&]() { return _isStopping || _generation != seenGeneration; });
+
+					if (_isStopping)
+					{
+						return;
+					}
+
+					seenGeneration = _generation;
+					_activeWorkers++;
+				}
+
+				RunChunks(worker);
+
+				{
+					std::lock_guard lock{ _mutex };
+					_activeWorkers--;
+				}
+
+				_finished.notify_all();
+			}
+		}
+
+		void RunChunks(size_t worker)
+		{
+			while (std::optional<Chunk> chunk = TakeChunk(worker))
+			{
+				_invoke(_task, chunk->Begin, chunk->End, worker);
+				_pendingChunks.fetch_sub(1, std::memory_order_acq_rel);
+			}
+		}
+
+		/**
+		* @returns a chunk from the back of the own deque or from the front of another one, std::nullopt when all are empty
+		*/
+		std::optional<Chunk> TakeChunk(size_t worker)
+		{
+			{
+				ChunkQueue& own = _queues[worker];
+				std::lock_guard lock{ own.Mutex };
+
+				if (!own.Chunks.empty())
+				{
+					Chunk chunk = own.Chunks.back();
+					own.Chunks.pop_back();
+					return chunk;
+				}
+			}
+
+			for (size_t offset = 1; offset < _queues.size(); offset++)
+			{
+				ChunkQueue& victim = _queues[(worker + offset) % _queues.size()];
+				std::lock_guard lock{ victim.Mutex };
+
+				if (!victim.Chunks.empty())
+				{
+					Chunk chunk = victim.Chunks.front();
+					victim.Chunks.pop_front();
+					return chunk;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		std::vector<ChunkQueue> _queues;
+		std::vector<std::thread> _threads;
+
+		// the task of the current ParallelFor call, type-erased so the pool isn't a template
+		void* _task = nullptr;
+		void (*_invoke)(void*, size_t, size_t, size_t) = nullptr;
+		std::atomic<size_t> _pendingChunks{ 0 };
+
+		std::mutex _mutex;
+		std::condition_variable _wakeUp;
+		std::condition_variable _finished;
+		uint64_t _generation = 0;
+		size_t _activeWorkers = 0;
+		bool _isStopping = false;
+	};
+
+	/**
+	* @brief Shape pair produced by the broadphase, ids are chosen by the caller
+	*/
+	struct CandidatePair
+	{
+		uint32_t IdA;
+		uint32_t IdB;
+		// convex pieces of concave bodies, 0 for convex ones
+		uint16_t PieceA = 0;
+		uint16_t PieceB = 0;
+	};
+
+	/**
+	* @brief Collision found for a candidate pair
+	*/
+	struct PairResponse
+	{
+		// position of the pair in the candidate list
+		uint32_t PairIndex;
+		CandidatePair Pair;
+		CollisionResponse Response;
+	};
+
+	/**
+	* @brief Runs narrowphase tests of candidate pairs on a work-stealing pool. Every worker appends collisions
+	* to its own buffer, the buffers are merged in candidate order, so the result doesn't depend on the worker count
+	* or on which worker got which pair. Responses are only collected, resolving them is up to the caller
+	*/
+	class ParallelNarrowphase
+	{
+	public:
+		/**
+		* @param pool: pool the tests run on
+		* @param grain: pairs in one chunk, bigger chunks steal less often
+		*/
+		explicit ParallelNarrowphase(WorkStealingPool& pool, size_t grain = 32)
+			: _pool(pool), _grain(grain), _buffers(pool.GetWorkerCount()) {}
+
+		/**
+		* @brief Tests every pair
+		* @param pairs: candidate pairs
+		* @param collide: callable with (const CandidatePair&, size_t worker) returning std::optional<CollisionResponse>,
+		* called concurrently, so it must not modify shared state without the worker index
+		* @returns collisions in candidate order, valid until the next call
+		*/
+		template <typename Collide>
+		const std::vector<PairResponse>& Run(const std::vector<CandidatePair>& pairs, Collide&& collide)
+		{
+			for (auto& buffer : _buffers)
+			{
+				buffer.clear();
+			}
+
+			_pool.ParallelFor(pairs.size(), _grain, [&](size_t begin, size_t end, size_t worker)
+			{
+				std::vector<PairResponse>& buffer = _buffers[worker];
+
+				for (size_t i = begin; i < end; i++)
+				{
+					if (std::optional<CollisionResponse> response = collide(pairs[i], worker))
+					{
+						buffer.push_back(PairResponse{ static_cast<uint32_t>(i), pairs[i], *response });
+					}
+				}
+			});
+
+			_merged.clear();
+
+			for (const auto& buffer : _buffers)
+			{
+				_merged.insert(_merged.end(), buffer.begin(), buffer.end());
+			}
+
+			// pair indices are unique, so the order is the same for any schedule
+			std::sort(_merged.begin(), _merged.end(), [](const PairResponse& left, const PairResponse& right)
+			{
+				return left.PairIndex < right.PairIndex;
+			});
+
+			return _merged;
+		}
+
+		/**
+		* @returns collisions found by the last Run
+		*/
+		const std::vector<PairResponse>& GetResponses() const noexcept
+		{
+			return _merged;
+		}
+
+		size_t GetWorkerCount() const noexcept
+		{
+			return _buffers.size();
+		}
+
+	private:
+		WorkStealingPool& _pool;
+		size_t _grain;
+		std::vector<std::vector<PairResponse>> _buffers;
+		std::vector<PairResponse> _merged;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace Engine
+{
+	/**
+	* @brief Parts of the collision pipeline measured by scoped timers, nested phases are counted in both.
+	* The finest phase is one SAT call of a pair, a timer costs more than projecting a single axis
+	*/
+	enum class ProfilePhase : uint8_t
+	{
+		Integration,
+		Broadphase,
+		Vertices,
+		HullUpdate,
+		Axes,
+		Sat,
+		Centroid,
+		Narrowphase,
+		Resolution,
+		TimeOfImpact,
+		Count
+	};
+
+	enum class ProfileCounter : uint8_t
+	{
+		PairsTested,
+		AxesTested,
+		// collinear edges that didn't become a new axis
+		AxesSkipped,
+		// pairs rejected by a separating axis before all axes were tested
+		EarlySeparations,
+		// heap allocations made by the engine code (vertex vectors, growing buffers)
+		Allocations,
+		Count
+	};
+
+	inline constexpr size_t PROFILE_PHASES = static_cast<size_t>(ProfilePhase::Count);
+	inline constexpr size_t PROFILE_COUNTERS = static_cast<size_t>(ProfileCounter::Count);
+
+	inline const char* toString(ProfilePhase phase)
+	{
+		constexpr std::array<const char*, PROFILE_PHASES> NAMES{
+			"integration", "broadphase", "vertices", "hull_update", "axes", "sat", "centroid", "narrowphase", "resolution", "time_of_impact"
+		};
+		return NAMES[static_cast<size_t>(phase)];
+	}
+
+	inline const char* toString(ProfileCounter counter)
+	{
+		constexpr std::array<const char*, PROFILE_COUNTERS> NAMES{
+			"pairs_tested", "axes_tested", "axes_skipped", "early_separations", "allocations"
+		};
+		return NAMES[static_cast<size_t>(counter)];
+	}
+
+	/**
+	* @brief Timers and counters collected over a number of frames
+	*/
+	struct ProfileStats
+	{
+		std::array<uint64_t, PROFILE_PHASES> PhaseNanoseconds{};
+		std::array<uint64_t, PROFILE_PHASES> PhaseCalls{};
+		std::array<uint64_t, PROFILE_COUNTERS> Counters{};
+		uint64_t Frames = 0;
+
+		uint64_t Get(ProfileCounter counter) const noexcept
+		{
+			return Counters[static_cast<size_t>(counter)];
+		}
+
+		/**
+		* @returns average time of the phase per frame in microseconds
+		*/
+		double MicrosecondsPerFrame(ProfilePhase phase) const noexcept
+		{
+			return PhaseNanoseconds[static_cast<size_t>(phase)] / 1000. / (Frames == 0 ? 1 : Frames);
+		}
+
+		/**
+		* @brief Writes the stats as a single line JSON object
+		*/
+		void WriteJson(std::ostream& stream) const
+		{
+			double frames = static_cast<double>(Frames == 0 ? 1 : Frames);
+			stream << "{\"frames\":" << Frames << ",\"phases\":{";
+
+			for (size_t i = 0; i < PROFILE_PHASES; i++)
+			{
+				stream << (i == 0 ? "" : ",") << '"' << toString(static_cast<ProfilePhase>(i)) << "\":{\"calls\":" << PhaseCalls[i]
+					<< ",\"total_us\":" << PhaseNanoseconds[i] / 1000. << ",\"per_frame_us\":" << PhaseNanoseconds[i] / 1000. / frames << '}';
+			}
+
+			stream << "},\"counters\":{";
+
+			for (size_t i = 0; i < PROFILE_COUNTERS; i++)
+			{
+				stream << (i == 0 ? "" : ",") << '"' << toString(static_cast<ProfileCounter>(i)) << "\":{\"total\":" << Counters[i]
+					<< ",\"per_frame\":" << Counters[i] / frames << '}';
+			}
+
+			stream << "}}\n";
+		}
+	};
+
+	/**
+	* @brief Process-wide collector. Counters are atomic, so the parallel narrowphase can report into it.
+	* Instrumented code counts into counters of its own thread first, they are flushed into the shared ones
+	* when a scoped timer ends (once per SAT call or phase) and at the end of a frame
+	*/
+	class Profiler
+	{
+	public:
+		static Profiler& Get()
+		{
+			static Profiler profiler;
+			return profiler;
+		}
+
+		void AddTime(ProfilePhase phase, uint64_t nanoseconds) noexcept
+		{
+			_phaseNanoseconds[static_cast<size_t>(phase)].fetch_add(nanoseconds, std::memory_order_relaxed);
+			_phaseCalls[static_cast<size_t>(phase)].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Add(ProfileCounter counter, uint64_t amount = 1) noexcept
+		{
+			_counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+		}
+
+		/**
+		* @brief Counts into the counters of the calling thread, no atomics for per-axis work
+		*/
+		void AddLocal(ProfileCounter counter, uint64_t amount = 1) noexcept
+		{
+			LocalCounters()[static_cast<size_t>(counter)] += amount;
+		}
+
+		/**
+		* @brief Adds the counters of the calling thread to the shared ones
+		*/
+		void Flush() noexcept
+		{
+			auto& localCounters = LocalCounters();
+
+			for (size_t i = 0; i < PROFILE_COUNTERS; i++)
+			{
+				if (localCounters[i] != 0)
+				{
+					_counters[i].fetch_add(localCounters[i], std::memory_order_relaxed);
+					localCounters[i] = 0;
+				}
+			}
+		}
+
+		void EndFrame() noexcept
+		{
+			Flush();
+			_frames.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		ProfileStats GetStats() const noexcept
+		{
+			ProfileStats stats;
+
+			for (size_t i = 0; i < PROFILE_PHASES; i++)
+			{
+				stats.PhaseNanoseconds[i] = _phaseNanoseconds[i].load(std::memory_order_relaxed);
+				stats.PhaseCalls[i] = _phaseCalls[i].load(std::memory_order_relaxed);
+			}
+
+			for (size_t i = 0; i < PROFILE_COUNTERS; i++)
+			{
+				stats.Counters[i] = _counters[i].load(std::memory_order_relaxed);
+			}
+
+			stats.Frames = _frames.load(std::memory_order_relaxed);
+			return stats;
+		}
+
+		void Reset() noexcept
+		{
+			for (size_t i = 0; i < PROFILE_PHASES; i++)
+			{
+				_phaseNanoseconds[i].store(0, std::memory_order_relaxed);
+				_phaseCalls[i].store(0, std::memory_order_relaxed);
+			}
+
+			for (auto& counter : _counters)
+			{
+				counter.store(0, std::memory_order_relaxed);
+			}
+
+			LocalCounters().fill(0);
+
+			_frames.store(0, std::memory_order_relaxed);
+		}
+
+	private:
+		Profiler() = default;
+
+		static std::array<uint64_t, PROFILE_COUNTERS>& LocalCounters() noexcept
+		{
+			thread_local std::array<uint64_t, PROFILE_COUNTERS> counters{};
+			return counters;
+		}
+
+		std::array<std::atomic<uint64_t>, PROFILE_PHASES> _phaseNanoseconds{};
+		std::array<std::atomic<uint64_t>, PROFILE_PHASES> _phaseCalls{};
+		std::array<std::atomic<uint64_t>, PROFILE_COUNTERS> _counters{};
+		std::atomic<uint64_t> _frames{ 0 };
+	};
+
+	/**
+	* @brief Adds the time between construction and destruction to the phase and flushes the counters of the thread
+	*/
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(ProfilePhase phase) noexcept
+			: _phase(phase), _start(std::chrono::steady_clock::now()) {}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+		~ScopedTimer()
+		{
+			auto duration = std::chrono::steady_clock::now() - _start;
+			Profiler& profiler = Profiler::Get();
+			profiler.AddTime(_phase, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+			profiler.Flush();
+		}
+
+	private:
+		ProfilePhase _phase;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	/**
+	* @brief Writes the collected stats as JSON every N frames and starts collecting anew
+	*/
+	class ProfileReporter
+	{
+	public:
+		/**
+		* @param stream: output, one JSON object per line
+		* @param interval: frames between reports
+		*/
+		ProfileReporter(std::ostream& stream, uint64_t interval)
+			: _stream(stream), _interval(interval == 0 ? 1 : interval) {}
+
+		/**
+		* @brief Counts the frame and reports when the interval is over
+		* @returns true if the stats have been reported
+		*/
+		bool EndFrame()
+		{
+			Profiler& profiler = Profiler::Get();
+			profiler.EndFrame();
+
+			if (profiler.GetStats().Frames < _interval)
+			{
+				return false;
+			}
+
+			_lastStats = profiler.GetStats();
+			profiler.Reset();
+			_lastStats.WriteJson(_stream);
+			return true;
+		}
+
+		/**
+		* @returns stats of the last reported interval
+		*/
+		const ProfileStats& GetLastStats() const noexcept
+		{
+			return _lastStats;
+		}
+
+	private:
+		std::ostream& _stream;
+		uint64_t _interval;
+		ProfileStats _lastStats;
+	};
+} // namespace Engine
+
+// instrumentation points, they compile to nothing unless ENGINE_PROFILING is defined
+#define ENGINE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ENGINE_PROFILE_CONCAT(a, b) ENGINE_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef ENGINE_PROFILING
+#define ENGINE_PROFILE_SCOPE(phase) ::Engine::ScopedTimer ENGINE_PROFILE_CONCAT(profileScope, __LINE__){ ::Engine::ProfilePhase::phase }
+#define ENGINE_PROFILE_COUNT(counter, amount) ::Engine::Profiler::Get().AddLocal(::Engine::ProfileCounter::counter, (amount))
+#else
+#define ENGINE_PROFILE_SCOPE(phase) ((void)0)
+#define ENGINE_PROFILE_COUNT(counter, amount) ((void)0)
+#endif
\ No newline at end of file
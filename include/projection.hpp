@@ -1,3 +1,5 @@
+#pragma once
+
 #include <compare>
 
 #include <SFML/System/Vector2.hpp>
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <world.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Input of a frame, the codes and the meaning of the value are chosen by the application
+	*/
+	struct InputEvent
+	{
+		uint16_t Code = 0;
+		sf::Vector2f Value;
+	};
+
+	struct ReplayFrame
+	{
+		// time passed to World::Advance
+		float FrameTime = 0.f;
+		std::vector<InputEvent> Events;
+		// state of the world after the frame, recorded every few frames
+		std::optional<WorldSnapshot> Snapshot;
+	};
+
+	namespace detail
+	{
+		// "ERPL"
+		inline constexpr uint32_t REPLAY_MAGIC = 0x4c505245;
+		inline constexpr uint32_t REPLAY_VERSION = 1;
+		inline constexpr uint8_t REPLAY_FRAME = 1;
+		inline constexpr uint8_t REPLAY_SNAPSHOT = 2;
+
+		template <typename T>
+		void writeValue(std::ostream& stream, const T& value)
+		{
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template <typename T>
+		bool readValue(std::istream& stream, T& value)
+		{
+			return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+		}
+	} // namespace detail
+
+	/**
+	* @brief Writes a session as a binary recording: a header, then for each frame its time and input events,
+	* followed by a world snapshot every few frames. Values are stored in the byte order of the machine,
+	* an uneventful frame takes 7 bytes
+	*/
+	class ReplayWriter
+	{
+	public:
+		/**
+		* @param stream: binary output stream, must outlive the writer
+		* @param snapshotInterval: frames between snapshots, 0 records none
+		*/
+		explicit ReplayWriter(std::ostream& stream, uint32_t snapshotInterval = 120)
+			: _stream(stream), _snapshotInterval(snapshotInterval)
+		{
+			detail::writeValue(_stream, detail::REPLAY_MAGIC);
+			detail::writeValue(_stream, detail::REPLAY_VERSION);
+		}
+
+		/**
+		* @brief Records a frame after the world has advanced by it
+		* @param frameTime: time passed to World::Advance
+		* @param events: input applied before the world advanced
+		*/
+		void WriteFrame(float frameTime, std::span<const InputEvent> events, const World& world)
+		{
+			detail::writeValue(_stream, detail::REPLAY_FRAME);
+			detail::writeValue(_stream, frameTime);
+			detail::writeValue(_stream, static_cast<uint16_t>(events.size()));
+
+			for (const InputEvent& event : events)
+			{
+				detail::writeValue(_stream, event.Code);
+				detail::writeValue(_stream, event.Value);
+			}
+
+			_frameCount++;
+
+			if (_snapshotInterval != 0 && _frameCount % _snapshotInterval == 0)
+			{
+				WriteSnapshot(world.CaptureSnapshot());
+			}
+		}
+
+		uint64_t GetFrameCount() const noexcept
+		{
+			return _frameCount;
+		}
+
+	private:
+		void WriteSnapshot(const WorldSnapshot& snapshot)
+		{
+			detail::writeValue(_stream, detail::REPLAY_SNAPSHOT);
+			detail::writeValue(_stream, snapshot.StepCount);
+			detail::writeValue(_stream, static_cast<uint32_t>(snapshot.Bodies.size()));
+
+			for (const BodySnapshot& body : snapshot.Bodies)
+			{
+				detail::writeValue(_stream, body.Body);
+				detail::writeValue(_stream, body.Position);
+				detail::writeValue(_stream, body.Rotation);
+				detail::writeValue(_stream, body.Velocity);
+			}
+		}
+
+		std::ostream& _stream;
+		uint32_t _snapshotInterval;
+		uint64_t _frameCount = 0;
+	};
+
+	/**
+	* @brief Reads a recording written by ReplayWriter frame by frame
+	*/
+	class ReplayReader
+	{
+	public:
+		/**
+		* @param stream: binary input stream, must outlive the reader
+		*/
+		explicit ReplayReader(std::istream& stream)
+			: _stream(stream)
+		{
+			uint32_t magic = 0;
+			uint32_t version = 0;
+			_isValid = detail::readValue(_stream, magic) && detail::readValue(_stream, version)
+				&& magic == detail::REPLAY_MAGIC && version == detail::REPLAY_VERSION;
+		}
+
+		/**
+		* @returns false if the stream doesn't start with a recording header of this version
+		*/
+		bool IsValid() const noexcept
+		{
+			return _isValid;
+		}
+
+		/**
+		* @brief Reads the next frame and the snapshot recorded after it
+		* @returns false at the end of the recording or if it is cut off
+		*/
+		bool ReadFrame(ReplayFrame& frame)
+		{
+			uint8_t tag = 0;
+
+			if (!_isValid || !detail::readValue(_stream, tag) || tag != detail::REPLAY_FRAME)
+			{
+				return false;
+			}
+
+			uint16_t eventCount = 0;
+
+			if (!detail::readValue(_stream, frame.FrameTime) || !detail::readValue(_stream, eventCount))
+			{
+				return false;
+			}
+
+			frame.Events.resize(eventCount);
+
+			for (InputEvent& event : frame.Events)
+			{
+				if (!detail::readValue(_stream, event.Code) || !detail::readValue(_stream, event.Value))
+				{
+					return false;
+				}
+			}
+
+			frame.Snapshot.reset();
+
+			if (_stream.peek() == detail::REPLAY_SNAPSHOT)
+			{
+				_stream.get();
+				return ReadSnapshot(frame.Snapshot.emplace());
+			}
+
+			return true;
+		}
+
+	private:
+		bool ReadSnapshot(WorldSnapshot& snapshot)
+		{
+			uint32_t bodyCount = 0;
+
+			if (!detail::readValue(_stream, snapshot.StepCount) || !detail::readValue(_stream, bodyCount))
+			{
+				return false;
+			}
+
+			snapshot.Bodies.resize(bodyCount);
+
+			for (BodySnapshot& body : snapshot.Bodies)
+			{
+				if (!detail::readValue(_stream, body.Body) || !detail::readValue(_stream, body.Position)
+					|| !detail::readValue(_stream, body.Rotation) || !detail::readValue(_stream, body.Velocity))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		std::istream& _stream;
+		bool _isValid = false;
+	};
+
+	/**
+	* @returns largest difference of a position, rotation or velocity component between the snapshots,
+	* infinity if they hold different bodies or step counts
+	*/
+	inline float snapshotDifference(const WorldSnapshot& a, const WorldSnapshot& b)
+	{
+		if (a.StepCount != b.StepCount || a.Bodies.size() != b.Bodies.size())
+		{
+			return std::numeric_limits<float>::infinity();
+		}
+
+		float difference = 0.f;
+
+		for (size_t i = 0; i < a.Bodies.size(); i++)
+		{
+			const BodySnapshot& bodyA = a.Bodies[i];
+			const BodySnapshot& bodyB = b.Bodies[i];
+
+			if (bodyA.Body != bodyB.Body)
+			{
+				return std::numeric_limits<float>::infinity();
+			}
+
+			difference = std::max({ difference,
+				std::abs(bodyA.Position.x - bodyB.Position.x), std::abs(bodyA.Position.y - bodyB.Position.y),
+				std::abs(bodyA.Rotation - bodyB.Rotation),
+				std::abs(bodyA.Velocity.x - bodyB.Velocity.x), std::abs(bodyA.Velocity.y - bodyB.Velocity.y) });
+		}
+
+		return difference;
+	}
+} // namespace Engine
\ No newline at end of file
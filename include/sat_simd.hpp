@@ -0,0 +1,329 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+
+#if defined(__AVX2__)
+#define ENGINE_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Engine
+{
+	/**
+	* @brief Polygon vertices stored as structure of arrays (all x coordinates, then all y coordinates),
+	* so SIMD kernels can load several vertices with one instruction
+	*/
+	struct SoaPolygon
+	{
+		SoaPolygon() = default;
+
+		explicit SoaPolygon(const std::vector<sf::Vector2f>& vertices)
+		{
+			Assign(vertices);
+		}
+
+		/**
+		* @brief Copies vertices into the arrays, reuses their memory when possible
+		* @param vertices: shape vertices
+		*/
+		void Assign(const std::vector<sf::Vector2f>& vertices)
+		{
+			X.resize(vertices.size());
+			Y.resize(vertices.size());
+
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				X[i] = vertices[i].x;
+				Y[i] = vertices[i].y;
+			}
+		}
+
+		size_t size() const noexcept
+		{
+			return X.size();
+		}
+
+		sf::Vector2f operator[](size_t index) const
+		{
+			return sf::Vector2f{ X[index], Y[index] };
+		}
+
+		std::vector<float> X;
+		std::vector<float> Y;
+	};
+
+	namespace simd
+	{
+		/**
+		* @brief Minimum and maximum projections of a polygon onto an axis with indices of the projected vertices
+		*/
+		struct ProjectionRange
+		{
+			float Min;
+			float Max;
+			uint32_t MinIndex;
+			uint32_t MaxIndex;
+		};
+
+		/**
+		* @brief Merges a minimum candidate into the range. On ties the earlier vertex is kept
+		* like std::min over Projection does
+		*/
+		inline void mergeMinimum(ProjectionRange& range, float projection, uint32_t index)
+		{
+			if (projection < range.Min || (projection == range.Min && index < range.MinIndex))
+			{
+				range.Min = projection;
+				range.MinIndex = index;
+			}
+		}
+
+		/**
+		* @brief Merges a maximum candidate into the range. On ties the earlier vertex is kept
+		* like std::max over Projection does
+		*/
+		inline void mergeMaximum(ProjectionRange& range, float projection, uint32_t index)
+		{
+			if (projection > range.Max || (projection == range.Max && index < range.MaxIndex))
+			{
+				range.Max = projection;
+				range.MaxIndex = index;
+			}
+		}
+
+		/**
+		* @brief Projects vertices [first; count) onto the axis one by one
+		*/
+		inline void projectTail(const float* x, const float* y, size_t first, size_t count, float nx, float ny, ProjectionRange& range)
+		{
+			for (size_t i = first; i < count; i++)
+			{
+				float projection = x[i] * nx + y[i] * ny;
+				mergeMinimum(range, projection, static_cast<uint32_t>(i));
+				mergeMaximum(range, projection, static_cast<uint32_t>(i));
+			}
+		}
+
+		/**
+		* @brief Scalar fallback, projects one vertex at a time
+		* @param x, y: vertex coordinates, count must be positive
+		* @param nx, ny: axis
+		*/
+		inline ProjectionRange projectScalar(const float* x, const float* y, size_t count, float nx, float ny)
+		{
+			float first = x[0] * nx + y[0] * ny;
+			ProjectionRange range{ first, first, 0, 0 };
+			projectTail(x, y, 1, count, nx, ny, range);
+			return range;
+		}
+
+#if ENGINE_SIMD_SSE2
+		/**
+		* @brief Projects 4 vertices per instruction. Every lane keeps its own minimum and maximum
+		* with the vertex index, lanes are merged at the end
+		*/
+		inline ProjectionRange projectSse2(const float* x, const float* y, size_t count, float nx, float ny)
+		{
+			constexpr size_t LANES = 4;
+
+			if (count < LANES)
+			{
+				return projectScalar(x, y, count, nx, ny);
+			}
+
+			const __m128 axisX = _mm_set1_ps(nx);
+			const __m128 axisY = _mm_set1_ps(ny);
+			const __m128i step = _mm_set1_epi32(LANES);
+
+			__m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+			__m128 projections = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x), axisX), _mm_mul_ps(_mm_loadu_ps(y), axisY));
+			__m128 minimums = projections;
+			__m128 maximums = projections;
+			__m128i minIndices = indices;
+			__m128i maxIndices = indices;
+
+			size_t i = LANES;
+
+			for (; i + LANES <= count; i += LANES)
+			{
+				indices = _mm_add_epi32(indices, step);
+				projections = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x + i), axisX), _mm_mul_ps(_mm_loadu_ps(y + i), axisY));
+
+				// SSE2 has no blend, select with masks
+				__m128 less = _mm_cmplt_ps(projections, minimums);
+				__m128 greater = _mm_cmpgt_ps(projections, maximums);
+
+				minimums = _mm_or_ps(_mm_and_ps(less, projections), _mm_andnot_ps(less, minimums));
+				maximums = _mm_or_ps(_mm_and_ps(greater, projections), _mm_andnot_ps(greater, maximums));
+
+				__m128i lessMask = _mm_castps_si128(less);
+				__m128i greaterMask = _mm_castps_si128(greater);
+				minIndices = _mm_or_si128(_mm_and_si128(lessMask, indices), _mm_andnot_si128(lessMask, minIndices));
+				maxIndices = _mm_or_si128(_mm_and_si128(greaterMask, indices), _mm_andnot_si128(greaterMask, maxIndices));
+			}
+
+			alignas(16) float laneMin[LANES];
+			alignas(16) float laneMax[LANES];
+			alignas(16) uint32_t laneMinIndex[LANES];
+			alignas(16) uint32_t laneMaxIndex[LANES];
+			_mm_store_ps(laneMin, minimums);
+			_mm_store_ps(laneMax, maximums);
+			_mm_store_si128(reinterpret_cast<__m128i*>(laneMinIndex), minIndices);
+			_mm_store_si128(reinterpret_cast<__m128i*>(laneMaxIndex), maxIndices);
+
+			ProjectionRange range{ laneMin[0], laneMax[0], laneMinIndex[0], laneMaxIndex[0] };
+
+			for (size_t lane = 1; lane < LANES; lane++)
+			{
+				mergeMinimum(range, laneMin[lane], laneMinIndex[lane]);
+				mergeMaximum(range, laneMax[lane], laneMaxIndex[lane]);
+			}
+
+			projectTail(x, y, i, count, nx, ny, range);
+			return range;
+		}
+#endif
+
+#if ENGINE_SIMD_AVX2
+		/**
+		* @brief Projects 8 vertices per instruction, falls back to narrower kernels for small polygons
+		*/
+		inline ProjectionRange projectAvx2(const float* x, const float* y, size_t count, float nx, float ny)
+		{
+			constexpr size_t LANES = 8;
+
+			if (count < LANES)
+			{
+				return projectSse2(x, y, count, nx, ny);
+			}
+
+			const __m256 axisX = _mm256_set1_ps(nx);
+			const __m256 axisY = _mm256_set1_ps(ny);
+			const __m256i step = _mm256_set1_epi32(LANES);
+
+			__m256i indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			__m256 projections = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(x), axisX), _mm256_mul_ps(_mm256_loadu_ps(y), axisY));
+			__m256 minimums = projections;
+			__m256 maximums = projections;
+			__m256 minIndices = _mm256_castsi256_ps(indices);
+			__m256 maxIndices = minIndices;
+
+			size_t i = LANES;
+
+			for (; i + LANES <= count; i += LANES)
+			{
+				indices = _mm256_add_epi32(indices, step);
+				projections = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i), axisX), _mm256_mul_ps(_mm256_loadu_ps(y + i), axisY));
+
+				__m256 less = _mm256_cmp_ps(projections, minimums, _CMP_LT_OQ);
+				__m256 greater = _mm256_cmp_ps(projections, maximums, _CMP_GT_OQ);
+
+				minimums = _mm256_blendv_ps(minimums, projections, less);
+				maximums = _mm256_blendv_ps(maximums, projections, greater);
+				minIndices = _mm256_blendv_ps(minIndices, _mm256_castsi256_ps(indices), less);
+				maxIndices = _mm256_blendv_ps(maxIndices, _mm256_castsi256_ps(indices), greater);
+			}
+
+			alignas(32) float laneMin[LANES];
+			alignas(32) float laneMax[LANES];
+			alignas(32) uint32_t laneMinIndex[LANES];
+			alignas(32) uint32_t laneMaxIndex[LANES];
+			_mm256_store_ps(laneMin, minimums);
+			_mm256_store_ps(laneMax, maximums);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(laneMinIndex), _mm256_castps_si256(minIndices));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(laneMaxIndex), _mm256_castps_si256(maxIndices));
+
+			ProjectionRange range{ laneMin[0], laneMax[0], laneMinIndex[0], laneMaxIndex[0] };
+
+			for (size_t lane = 1; lane < LANES; lane++)
+			{
+				mergeMinimum(range, laneMin[lane], laneMinIndex[lane]);
+				mergeMaximum(range, laneMax[lane], laneMaxIndex[lane]);
+			}
+
+			projectTail(x, y, i, count, nx, ny, range);
+			return range;
+		}
+#endif
+
+		/**
+		* @brief Projects vertices with the widest kernel the build targets (AVX2, SSE2 or scalar)
+		*/
+		inline ProjectionRange project(const float* x, const float* y, size_t count, float nx, float ny)
+		{
+#if ENGINE_SIMD_AVX2
+			return projectAvx2(x, y, count, nx, ny);
+#elif ENGINE_SIMD_SSE2
+			return projectSse2(x, y, count, nx, ny);
+#else
+			return projectScalar(x, y, count, nx, ny);
+#endif
+		}
+	} // namespace simd
+
+	/**
+	* @brief Finds minimum and maximum projections of SoA polygon vertices onto an axis with SIMD kernel.
+	* Gives the same result as the std::vector overload, including the chosen vertex on ties
+	* @param polygon: shape vertices
+	* @param normalVector: axis to project onto
+	*/
+	inline std::pair<Projection, Projection> projectionBounds(const SoaPolygon& polygon, const sf::Vector2f& normalVector)
+	{
+		simd::ProjectionRange range = simd::project(polygon.X.data(), polygon.Y.data(), polygon.size(), normalVector.x, normalVector.y);
+		return { Projection{ range.Min, range.MinIndex }, Projection{ range.Max, range.MaxIndex } };
+	}
+
+	/**
+	* @brief calculates centre point (centroid) of SoA polygon, same arithmetic as for vertex vector
+	*/
+	inline sf::Vector2f centroid(const SoaPolygon& polygon)
+	{
+		const size_t VERTICES = polygon.size();
+		float sum = 0.f;
+
+		for (size_t i = 0; i < VERTICES; i++)
+		{
+			size_t nextIndex = (i + 1) % VERTICES;
+			sum += polygon.X[i] * polygon.Y[nextIndex] - polygon.X[nextIndex] * polygon.Y[i];
+		}
+
+		float sArea = sum / 2;
+		float x = 0.f;
+		float y = 0.f;
+
+		for (size_t i = 0; i < VERTICES; i++)
+		{
+			size_t nextIndex = (i + 1) % VERTICES;
+			float ratio = polygon.X[i] * polygon.Y[nextIndex] - polygon.X[nextIndex] * polygon.Y[i];
+			x += (polygon.X[i] + polygon.X[nextIndex]) * ratio;
+			y += (polygon.Y[i] + polygon.Y[nextIndex]) * ratio;
+		}
+
+		return sf::Vector2f{ x, y } / (6 * sArea);
+	}
+
+	/**
+	* @brief Checks two SoA polygons for a collision with vectorized projections
+	* @param a: first shape vertices
+	* @param b: second shape vertices
+	* @param scratch: reusable buffers
+	* @return the same result as processCollision over vertex vectors
+	*/
+	inline std::optional<CollisionResponse> processCollision(const SoaPolygon& a, const SoaPolygon& b, CollisionScratch& scratch)
+	{
+		return detail::separatingAxisTest(a, b, scratch);
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,535 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <ostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+#include <aabb.hpp>
+#include <static_bvh.hpp>
+#include <convex_decomposition.hpp>
+#include <world.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Binary scene, version 1. Every section is an array of 4-byte values, so the file is used in place once mapped:
+	* header, chunks of a square grid in row order, shapes grouped by chunk, BVH nodes grouped by chunk, vertex pool.
+	* Shapes are convex, a chunk's shapes are in the leaf order of its BVH. Values are in the byte order of the machine
+	*/
+	struct SceneHeader
+	{
+		// "ESCN"
+		static constexpr uint32_t MAGIC = 0x4e435345;
+		static constexpr uint32_t VERSION = 1;
+
+		uint32_t Magic = MAGIC;
+		uint32_t Version = VERSION;
+		uint32_t ChunksX = 0;
+		uint32_t ChunksY = 0;
+		uint32_t ShapeCount = 0;
+		uint32_t NodeCount = 0;
+		uint32_t VertexCount = 0;
+		// side of a chunk in pixels, chunk (0, 0) starts at Bounds.Lower
+		float ChunkSize = 0.f;
+		Aabb Bounds;
+	};
+
+	struct SceneChunk
+	{
+		// bounds of the chunk's shapes, empty chunks have Lower > Upper
+		Aabb Bounds;
+		uint32_t ShapeBegin = 0;
+		uint32_t ShapeCount = 0;
+		uint32_t NodeBegin = 0;
+		uint32_t NodeCount = 0;
+	};
+
+	struct SceneShape
+	{
+		Aabb Bounds;
+		uint32_t VertexBegin = 0;
+		uint32_t VertexCount = 0;
+	};
+
+	// leaves index the chunk's shapes, inner nodes the chunk's nodes
+	using SceneNode = StaticBvh<uint32_t>::Node;
+
+	static_assert(sizeof(SceneHeader) == 48 && sizeof(SceneChunk) == 32 && sizeof(SceneShape) == 24 && sizeof(SceneNode) == 24
+		&& sizeof(sf::Vector2f) == 8, "scene sections are read in place");
+
+	/**
+	* @brief Read-only memory mapping of a whole file
+	*/
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile()
+		{
+			Close();
+		}
+
+		/**
+		* @returns false if the file can't be opened or mapped, an empty file can't be mapped
+		*/
+		bool Open(const std::string& path);
+
+		void Close() noexcept;
+
+		const uint8_t* data() const noexcept
+		{
+			return _data;
+		}
+
+		size_t size() const noexcept
+		{
+			return _size;
+		}
+
+	private:
+		const uint8_t* _data = nullptr;
+		size_t _size = 0;
+	};
+
+	/**
+	* @brief Writes polygons as a scene: concave ones are split into convex pieces, pieces go to the chunk
+	* holding the center of their bounds and a BVH is built over each chunk, so loading does no geometry work
+	* @param polygons: simple polygons in world space in either winding
+	* @param chunkSize: side of a chunk in pixels, the unit of streaming
+	*/
+	void writeScene(std::ostream& stream, std::span<const std::vector<sf::Vector2f>> polygons, float chunkSize);
+
+	/**
+	* @brief Scene mapped from a file: chunks, shapes, trees and vertices are read where they lie in the mapping,
+	* nothing is copied on open. Open walks every chunk, shape and node once to check their ranges,
+	* so it takes time linear in the shape and node count. Spans stay valid while the scene is open
+	*/
+	class SceneFile
+	{
+	public:
+		/**
+		* @returns false if the file can't be mapped or isn't a scene of this version
+		*/
+		bool Open(const std::string& path)
+		{
+			if (!_file.Open(path) || _file.size() < sizeof(SceneHeader))
+			{
+				_file.Close();
+				return false;
+			}
+
+			const SceneHeader& header = GetHeader();
+			size_t chunkCount = static_cast<size_t>(header.ChunksX) * header.ChunksY;
+			size_t expectedSize = sizeof(SceneHeader) + chunkCount * sizeof(SceneChunk) + header.ShapeCount * sizeof(SceneShape)
+				+ header.NodeCount * sizeof(SceneNode) + header.VertexCount * sizeof(sf::Vector2f);
+
+			if (header.Magic != SceneHeader::MAGIC || header.Version != SceneHeader::VERSION || _file.size() != expectedSize)
+			{
+				_file.Close();
+				return false;
+			}
+
+			_chunks = Section<SceneChunk>(sizeof(SceneHeader), chunkCount);
+			_shapes = Section<SceneShape>(sizeof(SceneHeader) + chunkCount * sizeof(SceneChunk), header.ShapeCount);
+			_nodes = Section<SceneNode>(sizeof(SceneHeader) + chunkCount * sizeof(SceneChunk) + header.ShapeCount * sizeof(SceneShape), header.NodeCount);
+			_vertices = Section<sf::Vector2f>(_file.size() - header.VertexCount * sizeof(sf::Vector2f), header.VertexCount);
+			_overhang = 0.f;
+
+			if (!HasValidRanges())
+			{
+				Close();
+				return false;
+			}
+
+			// how far shapes reach out of the cell of their chunk, for queries
+			for (uint32_t chunkIndex = 0; chunkIndex < _chunks.size(); chunkIndex++)
+			{
+				if (_chunks[chunkIndex].ShapeCount == 0)
+				{
+					continue;
+				}
+
+				Aabb cell = GetChunkCell(chunkIndex);
+				sf::Vector2f lower = cell.Lower - _chunks[chunkIndex].Bounds.Lower;
+				sf::Vector2f upper = _chunks[chunkIndex].Bounds.Upper - cell.Upper;
+				_overhang = std::max({ _overhang, lower.x, lower.y, upper.x, upper.y });
+			}
+
+			return true;
+		}
+
+		bool IsOpen() const noexcept
+		{
+			return _file.data() != nullptr;
+		}
+
+		/**
+		* @brief Unmaps the file, spans taken from the scene become invalid
+		*/
+		void Close() noexcept
+		{
+			_file.Close();
+			_chunks = {};
+			_shapes = {};
+			_nodes = {};
+			_vertices = {};
+		}
+
+		const SceneHeader& GetHeader() const noexcept
+		{
+			return *reinterpret_cast<const SceneHeader*>(_file.data());
+		}
+
+		std::span<const SceneChunk> GetChunks() const noexcept
+		{
+			return _chunks;
+		}
+
+		std::span<const SceneShape> GetShapes() const noexcept
+		{
+			return _shapes;
+		}
+
+		/**
+		* @returns world-space vertices of a shape in the mapping
+		*/
+		std::span<const sf::Vector2f> GetPolygon(uint32_t shape) const noexcept
+		{
+			return _vertices.subspan(_shapes[shape].VertexBegin, _shapes[shape].VertexCount);
+		}
+
+		/**
+		* @returns area of the grid cell of a chunk, its shapes are the ones whose bounds are centered in it
+		*/
+		Aabb GetChunkCell(uint32_t chunkIndex) const noexcept
+		{
+			const SceneHeader& header = GetHeader();
+			sf::Vector2f lower = header.Bounds.Lower
+				+ sf::Vector2f{ static_cast<float>(chunkIndex % header.ChunksX), static_cast<float>(chunkIndex / header.ChunksX) } * header.ChunkSize;
+			return Aabb{ lower, lower + sf::Vector2f{ header.ChunkSize, header.ChunkSize } };
+		}
+
+		/**
+		* @brief Calls callback(chunkIndex) for each chunk of the grid cells the box overlaps
+		*/
+		template <typename Callback>
+		void ForEachChunk(const Aabb& aabb, Callback&& callback) const
+		{
+			const SceneHeader& header = GetHeader();
+			sf::Vector2f lower = (aabb.Lower - header.Bounds.Lower) / header.ChunkSize;
+			sf::Vector2f upper = (aabb.Upper - header.Bounds.Lower) / header.ChunkSize;
+
+			if (upper.x < 0.f || upper.y < 0.f || lower.x >= header.ChunksX || lower.y >= header.ChunksY)
+			{
+				return;
+			}
+
+			uint32_t endX = static_cast<uint32_t>(std::min(static_cast<float>(header.ChunksX - 1), upper.x)) + 1;
+			uint32_t endY = static_cast<uint32_t>(std::min(static_cast<float>(header.ChunksY - 1), upper.y)) + 1;
+
+			for (uint32_t y = static_cast<uint32_t>(std::max(0.f, lower.y)); y < endY; y++)
+			{
+				for (uint32_t x = static_cast<uint32_t>(std::max(0.f, lower.x)); x < endX; x++)
+				{
+					callback(y * header.ChunksX + x);
+				}
+			}
+		}
+
+		/**
+		* @brief Calls callback(shapeIndex) for each shape whose bounds overlap the box, using the prebuilt trees in place.
+		* Shapes reach out of the cells of their chunks, so chunks next to the box are searched too
+		* @param callback: returns false to stop the query
+		*/
+		template <typename Callback>
+		void QueryShapes(const Aabb& aabb, Callback&& callback) const
+		{
+			sf::Vector2f margin{ _overhang, _overhang };
+			bool isStopped = false;
+
+			ForEachChunk(Aabb{ aabb.Lower - margin, aabb.Upper + margin }, [&](uint32_t chunkIndex)
+			{
+				const SceneChunk& chunk = _chunks[chunkIndex];
+
+				if (isStopped || chunk.NodeCount == 0 || !chunk.Bounds.Overlaps(aabb))
+				{
+					return;
+				}
+
+				detail::NodeStack stack;
+				stack.Push(0);
+
+				while (!stack.Empty() && !isStopped)
+				{
+					uint32_t nodeIndex = static_cast<uint32_t>(stack.Pop());
+					const SceneNode& node = _nodes[chunk.NodeBegin + nodeIndex];
+
+					if (!node.Bounds.Overlaps(aabb))
+					{
+						continue;
+					}
+
+					if (node.Count == 0)
+					{
+						stack.Push(static_cast<int32_t>(node.Offset));
+						stack.Push(static_cast<int32_t>(nodeIndex + 1));
+						continue;
+					}
+
+					for (uint32_t shape = chunk.ShapeBegin + node.Offset; shape < chunk.ShapeBegin + node.Offset + node.Count && !isStopped; shape++)
+					{
+						isStopped = _shapes[shape].Bounds.Overlaps(aabb) && !callback(shape);
+					}
+				}
+			});
+		}
+
+	private:
+		/**
+		* @brief One pass over the sections checking that every range and child index stays inside its section,
+		* so queries and streaming can read the mapping without checks
+		*/
+		bool HasValidRanges() const noexcept
+		{
+			if (!(GetHeader().ChunkSize > 0.f))
+			{
+				return false;
+			}
+
+			// shapes are convex polygons, the streamer reads their last vertex
+			for (const SceneShape& shape : _shapes)
+			{
+				if (shape.VertexCount < 3 || static_cast<size_t>(shape.VertexBegin) + shape.VertexCount > _vertices.size())
+				{
+					return false;
+				}
+			}
+
+			for (const SceneChunk& chunk : _chunks)
+			{
+				if (static_cast<size_t>(chunk.ShapeBegin) + chunk.ShapeCount > _shapes.size()
+					|| static_cast<size_t>(chunk.NodeBegin) + chunk.NodeCount > _nodes.size())
+				{
+					return false;
+				}
+
+				for (uint32_t nodeIndex = 0; nodeIndex < chunk.NodeCount; nodeIndex++)
+				{
+					const SceneNode& node = _nodes[chunk.NodeBegin + nodeIndex];
+
+					// children come after their parent, so queries always terminate
+					bool isValid = node.Count == 0
+						? nodeIndex + 1 < chunk.NodeCount && node.Offset > nodeIndex + 1 && node.Offset < chunk.NodeCount
+						: static_cast<size_t>(node.Offset) + node.Count <= chunk.ShapeCount;
+
+					if (!isValid)
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		template <typename T>
+		std::span<const T> Section(size_t offset, size_t count) const noexcept
+		{
+			return std::span<const T>{ reinterpret_cast<const T*>(_file.data() + offset), count };
+		}
+
+		MappedFile _file;
+		std::span<const SceneChunk> _chunks;
+		std::span<const SceneShape> _shapes;
+		std::span<const SceneNode> _nodes;
+		std::span<const sf::Vector2f> _vertices;
+		float _overhang = 0.f;
+	};
+
+	/**
+	* @brief Keeps the chunks of a scene around a moving point in a world as static geometry.
+	* A chunk entering the load radius is paged in on a background thread first, reading its mapped shapes and
+	* vertices, so the world only copies memory that is already resident. Chunks leave the world once they are
+	* outside the unload radius, which is larger so a body moving along a chunk border doesn't load and unload it each frame
+	*/
+	class SceneStreamer
+	{
+	public:
+		/**
+		* @param world: gets the shapes of loaded chunks, must outlive the streamer
+		* @param scene: open scene, must outlive the streamer
+		* @param loadRadius: chunks within this distance along both axes of the point are loaded
+		* @param unloadRadius: chunks beyond this distance are unloaded, at least loadRadius
+		*/
+		SceneStreamer(World& world, const SceneFile& scene, float loadRadius, float unloadRadius)
+			: _world(world), _scene(scene), _loadRadius(loadRadius), _unloadRadius(std::max(loadRadius, unloadRadius)),
+			_chunks(scene.GetChunks().size()) {}
+
+		SceneStreamer(const SceneStreamer&) = delete;
+		SceneStreamer& operator=(const SceneStreamer&) = delete;
+
+		~SceneStreamer()
+		{
+			for (ChunkState& chunk : _chunks)
+			{
+				if (chunk.Prefetch.valid())
+				{
+					chunk.Prefetch.wait();
+				}
+
+				Unload(chunk);
+			}
+		}
+
+		/**
+		* @brief Starts paging in the chunks around the point, adds the ones paged in to the world
+		* and removes the ones that are too far away. Call it once per frame before stepping the world
+		*/
+		void Update(const sf::Vector2f& center)
+		{
+			sf::Vector2f load{ _loadRadius, _loadRadius };
+			_scene.ForEachChunk(Aabb{ center - load, center + load }, [this](uint32_t chunkIndex)
+			{
+				ChunkState& chunk = _chunks[chunkIndex];
+
+				if (!chunk.IsLoaded && !chunk.Prefetch.valid() && _scene.GetChunks()[chunkIndex].ShapeCount > 0)
+				{
+					chunk.Prefetch = std::async(std::launch::async, [this, chunkIndex]() { return PageIn(chunkIndex); });
+				}
+			});
+
+			sf::Vector2f unload{ _unloadRadius, _unloadRadius };
+			Aabb keep{ center - unload, center + unload };
+
+			for (uint32_t chunkIndex = 0; chunkIndex < _chunks.size(); chunkIndex++)
+			{
+				ChunkState& chunk = _chunks[chunkIndex];
+				bool isKept = _scene.GetChunkCell(chunkIndex).Overlaps(keep);
+
+				if (chunk.Prefetch.valid() && chunk.Prefetch.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready)
+				{
+					chunk.Prefetch.get();
+
+					if (isKept)
+					{
+						Load(chunkIndex);
+					}
+				}
+				else if (chunk.IsLoaded && !isKept)
+				{
+					Unload(chunk);
+				}
+			}
+		}
+
+		/**
+		* @brief Waits for the chunks being paged in and adds them to the world, e.g. behind a loading screen
+		*/
+		void Flush()
+		{
+			for (uint32_t chunkIndex = 0; chunkIndex < _chunks.size(); chunkIndex++)
+			{
+				if (_chunks[chunkIndex].Prefetch.valid())
+				{
+					_chunks[chunkIndex].Prefetch.get();
+					Load(chunkIndex);
+				}
+			}
+		}
+
+		size_t GetLoadedChunkCount() const noexcept
+		{
+			return static_cast<size_t>(std::count_if(_chunks.begin(), _chunks.end(), [](const ChunkState& chunk) { return chunk.IsLoaded; }));
+		}
+
+		size_t GetPendingChunkCount() const noexcept
+		{
+			return static_cast<size_t>(std::count_if(_chunks.begin(), _chunks.end(), [](const ChunkState& chunk) { return chunk.Prefetch.valid(); }));
+		}
+
+		bool IsChunkLoaded(uint32_t chunkIndex) const noexcept
+		{
+			return _chunks[chunkIndex].IsLoaded;
+		}
+
+	private:
+		struct ChunkState
+		{
+			std::future<float> Prefetch;
+			std::vector<BodyId> Bodies;
+			bool IsLoaded = false;
+		};
+
+		/**
+		* @brief Reads a value of every page of the chunk's shapes and vertices, so the world doesn't wait for the disk
+		* @returns sum of the values, so the reads aren't optimized away
+		*/
+		float PageIn(uint32_t chunkIndex) const
+		{
+			constexpr size_t PAGE_FLOATS = 4096 / sizeof(float);
+			const SceneChunk& chunk = _scene.GetChunks()[chunkIndex];
+			std::span<const SceneShape> shapes = _scene.GetShapes().subspan(chunk.ShapeBegin, chunk.ShapeCount);
+			const SceneShape& last = shapes.back();
+			const float* begin = &_scene.GetPolygon(chunk.ShapeBegin)[0].x;
+			const float* end = &_scene.GetPolygon(chunk.ShapeBegin + chunk.ShapeCount - 1)[last.VertexCount - 1].y;
+			float sum = 0.f;
+
+			for (const SceneShape& shape : shapes)
+			{
+				sum += shape.Bounds.Lower.x;
+			}
+
+			for (const float* value = begin; value <= end; value += PAGE_FLOATS)
+			{
+				sum += *value;
+			}
+
+			return sum;
+		}
+
+		void Load(uint32_t chunkIndex)
+		{
+			const SceneChunk& sceneChunk = _scene.GetChunks()[chunkIndex];
+			ChunkState& chunk = _chunks[chunkIndex];
+			chunk.Bodies.reserve(sceneChunk.ShapeCount);
+
+			for (uint32_t shape = sceneChunk.ShapeBegin; shape < sceneChunk.ShapeBegin + sceneChunk.ShapeCount; shape++)
+			{
+				chunk.Bodies.push_back(_world.CreateStaticGeometry(_scene.GetPolygon(shape)));
+			}
+
+			chunk.IsLoaded = true;
+		}
+
+		void Unload(ChunkState& chunk)
+		{
+			for (BodyId body : chunk.Bodies)
+			{
+				_world.DestroyBody(body);
+			}
+
+			chunk.Bodies.clear();
+			chunk.IsLoaded = false;
+		}
+
+		World& _world;
+		const SceneFile& _scene;
+		float _loadRadius;
+		float _unloadRadius;
+		std::vector<ChunkState> _chunks;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+#include <collision_hull.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Remembers per shape pair the axis that separated the shapes and tests it first next time.
+	* Pairs that stay apart usually exit after a single projection, pairs that collided go straight to full SAT.
+	* Call NextFrame once per frame, it drops pairs that weren't queried lately so the table stays as big as the pair set
+	*/
+	class SeparatingAxisCache
+	{
+	public:
+		/**
+		* @brief Cache effectiveness counters
+		*/
+		struct Statistics
+		{
+			// all processed pairs
+			size_t Queries = 0;
+			// pairs separated by the cached axis, no full SAT run
+			size_t Hits = 0;
+			// known pairs that needed full SAT: the cached axis didn't separate them or they collided last time
+			size_t Misses = 0;
+			// pairs seen for the first time
+			size_t ColdQueries = 0;
+
+			double HitRate() const noexcept
+			{
+				return Queries == 0 ? 0. : static_cast<double>(Hits) / Queries;
+			}
+		};
+
+		/**
+		* @brief Checks two hulls for a collision, starting with the axis cached for the pair
+		* @param idA: unique id of the first shape
+		* @param a: first shape hull
+		* @param idB: unique id of the second shape
+		* @param b: second shape hull
+		* @return the same result as processCollision for the hulls
+		*/
+		std::optional<CollisionResponse> ProcessCollision(uint32_t idA, const CollisionHull& a, uint32_t idB, const CollisionHull& b)
+		{
+			return ProcessCollision(idA, a.GetView(), idB, b.GetView());
+		}
+
+		std::optional<CollisionResponse> ProcessCollision(uint32_t idA, const HullView& a, uint32_t idB, const HullView& b)
+		{
+			ENGINE_PROFILE_SCOPE(Sat);
+			_statistics.Queries++;
+			ENGINE_PROFILE_COUNT(PairsTested, 1);
+
+			auto [entry, isNew] = FindOrInsert(PairKey(idA, idB));
+			entry.LastFrame = _frame;
+
+			if (isNew)
+			{
+				_statistics.ColdQueries++;
+			}
+			else if (entry.Separating && IsSeparatedOnAxis(a, b, entry.Axis))
+			{
+				ENGINE_PROFILE_COUNT(EarlySeparations, 1);
+				_statistics.Hits++;
+				return std::nullopt;
+			}
+			else
+			{
+				_statistics.Misses++;
+			}
+
+			detail::SatState state;
+
+			for (const HullView* hull : { &a, &b })
+			{
+				for (const auto& axis : hull->Axes)
+				{
+					if (!detail::overlapOnAxis(a.Vertices, b.Vertices, axis, state))
+					{
+						ENGINE_PROFILE_COUNT(EarlySeparations, 1);
+						entry.Axis = axis;
+						entry.Separating = true;
+						return std::nullopt;
+					}
+				}
+			}
+
+			// colliding pairs usually keep colliding for several frames, testing the cached axis would be a wasted projection
+			entry.Separating = false;
+			return detail::orientedResponse(state, a.Centroid, b.Centroid);
+		}
+
+		/**
+		* @brief Starts a new frame and drops the pairs that weren't queried in the last frames,
+		* e.g. pairs that left the broadphase or pairs of removed shapes. The table shrinks when most pairs are gone
+		* @param maxIdleFrames: frames a pair may go without queries before it's dropped
+		*/
+		void NextFrame(uint32_t maxIdleFrames = 0)
+		{
+			size_t staleCount = 0;
+
+			for (size_t slot = 0; slot < _keys.size(); slot++)
+			{
+				staleCount += _keys[slot] != EMPTY_KEY && IsStale(_entries[slot], maxIdleFrames);
+			}
+
+			if (staleCount != 0)
+			{
+				// a quarter full after shrinking, so a few new pairs don't grow the table right back
+				size_t liveCount = _size - staleCount;
+				size_t capacity = std::max<size_t>(16, std::bit_ceil(4 * liveCount));
+				Rehash(std::min(capacity, _keys.size()), maxIdleFrames);
+			}
+
+			_frame++;
+		}
+
+		/**
+		* @brief Drops the cached axis of the pair, e.g. when one of the shapes is removed
+		*/
+		void Erase(uint32_t idA, uint32_t idB)
+		{
+			if (_keys.empty())
+			{
+				return;
+			}
+
+			size_t mask = _keys.size() - 1;
+			size_t slot = FindSlot(PairKey(idA, idB));
+
+			if (_keys[slot] == EMPTY_KEY)
+			{
+				return;
+			}
+
+			// backward shift deletion, entries after the removed one move closer to their home slots
+			size_t next = (slot + 1) & mask;
+
+			while (_keys[next] != EMPTY_KEY)
+			{
+				size_t home = HomeSlot(_keys[next]);
+
+				// the entry can fill the hole only if the hole lies between its home slot and its current slot
+				if (((next - home) & mask) >= ((next - slot) & mask))
+				{
+					_keys[slot] = _keys[next];
+					_entries[slot] = _entries[next];
+					slot = next;
+				}
+
+				next = (next + 1) & mask;
+			}
+
+			_keys[slot] = EMPTY_KEY;
+			_size--;
+		}
+
+		void Clear()
+		{
+			std::fill(_keys.begin(), _keys.end(), EMPTY_KEY);
+			_size = 0;
+		}
+
+		size_t Size() const noexcept
+		{
+			return _size;
+		}
+
+		size_t Capacity() const noexcept
+		{
+			return _keys.size();
+		}
+
+		const Statistics& GetStatistics() const noexcept
+		{
+			return _statistics;
+		}
+
+		void ResetStatistics() noexcept
+		{
+			_statistics = Statistics{};
+		}
+
+	private:
+		struct CachedAxis
+		{
+			sf::Vector2f Axis;
+			// frame of the last query, pairs that go unqueried are dropped by NextFrame
+			uint32_t LastFrame = 0;
+			// false if the pair collided last time and has no separating axis
+			bool Separating = false;
+		};
+
+		/**
+		* @brief Order independent key, (a, b) and (b, a) share the cached axis
+		*/
+		static uint64_t PairKey(uint32_t idA, uint32_t idB) noexcept
+		{
+			auto [low, high] = std::minmax(idA, idB);
+			return (static_cast<uint64_t>(high) << 32) | low;
+		}
+
+		static size_t Hash(uint64_t key) noexcept
+		{
+			// splitmix64 finalizer, consecutive ids spread over the whole table
+			key ^= key >> 30;
+			key *= 0xbf58476d1ce4e5b9ull;
+			key ^= key >> 27;
+			key *= 0x94d049bb133111ebull;
+			key ^= key >> 31;
+			return static_cast<size_t>(key);
+		}
+
+		size_t HomeSlot(uint64_t key) const noexcept
+		{
+			return Hash(key) & (_keys.size() - 1);
+		}
+
+		/**
+		* @returns slot holding the key or the empty slot where it would be inserted
+		*/
+		size_t FindSlot(uint64_t key) const noexcept
+		{
+			size_t mask = _keys.size() - 1;
+			size_t slot = Hash(key) & mask;
+
+			while (_keys[slot] != key && _keys[slot] != EMPTY_KEY)
+			{
+				slot = (slot + 1) & mask;
+			}
+
+			return slot;
+		}
+
+		/**
+		* @returns cache entry of the pair and true if the pair has just been added
+		*/
+		std::pair<CachedAxis&, bool> FindOrInsert(uint64_t key)
+		{
+			// keep the load factor under 1/2 so probe sequences stay short
+			if (2 * (_size + 1) > _keys.size())
+			{
+				Grow();
+			}
+
+			size_t slot = FindSlot(key);
+
+			if (_keys[slot] == key)
+			{
+				return { _entries[slot], false };
+			}
+
+			_keys[slot] = key;
+			_entries[slot] = CachedAxis{};
+			_size++;
+			return { _entries[slot], true };
+		}
+
+		void Grow()
+		{
+			Rehash(std::max<size_t>(16, 2 * _keys.size()), std::numeric_limits<uint32_t>::max());
+		}
+
+		bool IsStale(const CachedAxis& entry, uint32_t maxIdleFrames) const noexcept
+		{
+			// unsigned difference, so the frame counter may wrap
+			return _frame - entry.LastFrame > maxIdleFrames;
+		}
+
+		/**
+		* @brief Moves the entries that aren't stale into a table of the given power of two size
+		*/
+		void Rehash(size_t capacity, uint32_t maxIdleFrames)
+		{
+			std::vector<uint64_t> keys(capacity, EMPTY_KEY);
+			std::vector<CachedAxis> entries(keys.size());
+			keys.swap(_keys);
+			entries.swap(_entries);
+			_size = 0;
+
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				if (keys[i] != EMPTY_KEY && !IsStale(entries[i], maxIdleFrames))
+				{
+					size_t slot = FindSlot(keys[i]);
+					_keys[slot] = keys[i];
+					_entries[slot] = entries[i];
+					_size++;
+				}
+			}
+		}
+
+		static bool IsSeparatedOnAxis(const HullView& a, const HullView& b, const sf::Vector2f& axis)
+		{
+			ENGINE_PROFILE_COUNT(AxesTested, 1);
+			auto [minProjectionA, maxProjectionA] = projectionBounds(a.Vertices, axis);
+			auto [minProjectionB, maxProjectionB] = projectionBounds(b.Vertices, axis);
+			return minProjectionB > maxProjectionA || minProjectionA > maxProjectionB;
+		}
+
+		// ids are 32 bit, so (max, max) can't come from a real pair
+		static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+
+		// open addressing table with linear probing, keys and entries in parallel arrays
+		std::vector<uint64_t> _keys;
+		std::vector<CachedAxis> _entries;
+		size_t _size = 0;
+		uint32_t _frame = 0;
+		Statistics _statistics;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+#include <aabb.hpp>
+#include <body_storage.hpp>
+#include <collision_hull.hpp>
+#include <contact_manifold.hpp>
+#include <sat_simd.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Segment from the origin to origin + translation
+	*/
+	struct Ray
+	{
+		sf::Vector2f Origin;
+		sf::Vector2f Translation;
+	};
+
+	struct RayHit
+	{
+		// body that was hit, set by world queries, INVALID_BODY when the ray hits nothing
+		BodyId Body = INVALID_BODY;
+		// part of the translation before the hit, in [0, 1]
+		float Fraction = 1.f;
+		sf::Vector2f Point;
+		// outward unit normal of the hit edge
+		sf::Vector2f Normal;
+	};
+
+	/**
+	* @brief Bodies found by a batch of queries, reused between batches so the memory stays allocated.
+	* The results of a query are Bodies[Offsets[query], Offsets[query + 1])
+	*/
+	struct QueryResults
+	{
+		std::span<const BodyId> operator[](size_t query) const
+		{
+			return std::span<const BodyId>{ Bodies.data() + Offsets[query], Offsets[query + 1] - Offsets[query] };
+		}
+
+		/**
+		* @returns number of queries
+		*/
+		size_t size() const noexcept
+		{
+			return Offsets.empty() ? 0 : Offsets.size() - 1;
+		}
+
+		void clear()
+		{
+			Bodies.clear();
+			Offsets.assign(1, 0);
+		}
+
+		std::vector<BodyId> Bodies;
+		std::vector<uint32_t> Offsets;
+	};
+
+	/**
+	* @brief Clips the ray by the edges of a convex polygon (Cyrus-Beck)
+	* @param vertices: polygon vertices in either winding
+	* @param isCounterClockwise: positive oriented area of the polygon
+	* @return std::nullopt if the ray misses the polygon or starts inside it
+	*/
+	inline std::optional<RayHit> raycast(const Ray& ray, std::span<const sf::Vector2f> vertices, bool isCounterClockwise)
+	{
+		float enter = 0.f;
+		float exit = 1.f;
+		sf::Vector2f hitNormal;
+		bool hasEntered = false;
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			sf::Vector2f edgeNormal = detail::outwardNormal(vertices, i, isCounterClockwise);
+			// negative when the origin is in front of the edge
+			float distance = dot(edgeNormal, vertices[i] - ray.Origin);
+			float speed = dot(edgeNormal, ray.Translation);
+
+			if (speed == 0.f)
+			{
+				// parallel to the edge, outside stays outside
+				if (distance < 0.f)
+				{
+					return std::nullopt;
+				}
+
+				continue;
+			}
+
+			float fraction = distance / speed;
+
+			if (speed < 0.f && fraction > enter)
+			{
+				enter = fraction;
+				hitNormal = edgeNormal;
+				hasEntered = true;
+			}
+			else if (speed > 0.f)
+			{
+				exit = std::min(exit, fraction);
+			}
+
+			if (exit < enter)
+			{
+				return std::nullopt;
+			}
+		}
+
+		if (!hasEntered)
+		{
+			return std::nullopt;
+		}
+
+		return RayHit{ INVALID_BODY, enter, ray.Origin + ray.Translation * enter, hitNormal };
+	}
+
+	inline std::optional<RayHit> raycast(const Ray& ray, const std::vector<sf::Vector2f>& vertices)
+	{
+		return raycast(ray, vertices, orientedArea(vertices) > 0.f);
+	}
+
+	inline std::optional<RayHit> raycast(const Ray& ray, const HullView& hull)
+	{
+		return raycast(ray, hull.Vertices, hull.Area > 0.f);
+	}
+
+	/**
+	* @returns true if the point is inside the convex polygon or on its boundary
+	*/
+	inline bool containsPoint(const HullView& hull, const sf::Vector2f& point)
+	{
+		for (size_t i = 0; i < hull.Vertices.size(); i++)
+		{
+			if (dot(detail::outwardNormal(hull.Vertices, i, hull.Area > 0.f), point - hull.Vertices[i]) > 0.f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	namespace simd
+	{
+		/**
+		* @brief Rays stored as structure of arrays for slab tests of several rays against one box.
+		* Inverse translations of axis-parallel rays are large instead of infinite, so no lane turns into NaN
+		*/
+		struct RayPacket
+		{
+			static constexpr size_t LANES = 4;
+
+			void Set(size_t lane, const Ray& ray)
+			{
+				constexpr float LARGE = std::numeric_limits<float>::max();
+
+				OriginX[lane] = ray.Origin.x;
+				OriginY[lane] = ray.Origin.y;
+				InverseX[lane] = ray.Translation.x != 0.f ? 1.f / ray.Translation.x : LARGE;
+				InverseY[lane] = ray.Translation.y != 0.f ? 1.f / ray.Translation.y : LARGE;
+				MaxFraction[lane] = 1.f;
+			}
+
+			/**
+			* @brief The lane misses every box
+			*/
+			void Disable(size_t lane)
+			{
+				Set(lane, Ray{});
+				MaxFraction[lane] = -1.f;
+			}
+
+			alignas(16) float OriginX[LANES]{};
+			alignas(16) float OriginY[LANES]{};
+			alignas(16) float InverseX[LANES]{};
+			alignas(16) float InverseY[LANES]{};
+			// closest hit found so far, the rest of the ray doesn't need testing
+			alignas(16) float MaxFraction[LANES]{};
+		};
+
+		/**
+		* @returns bit mask of the packet lanes whose rays cross the box before their MaxFraction
+		*/
+		inline uint32_t slabTest(const RayPacket& packet, const Aabb& box)
+		{
+#if ENGINE_SIMD_SSE2
+			const __m128 originX = _mm_load_ps(packet.OriginX);
+			const __m128 originY = _mm_load_ps(packet.OriginY);
+			const __m128 inverseX = _mm_load_ps(packet.InverseX);
+			const __m128 inverseY = _mm_load_ps(packet.InverseY);
+
+			__m128 lowerX = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.Lower.x), originX), inverseX);
+			__m128 upperX = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.Upper.x), originX), inverseX);
+			__m128 lowerY = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.Lower.y), originY), inverseY);
+			__m128 upperY = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.Upper.y), originY), inverseY);
+
+			__m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(lowerX, upperX), _mm_min_ps(lowerY, upperY)), _mm_setzero_ps());
+			__m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(lowerX, upperX), _mm_max_ps(lowerY, upperY)), _mm_load_ps(packet.MaxFraction));
+
+			return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(enter, exit)));
+#else
+			uint32_t mask = 0;
+
+			for (size_t lane = 0; lane < RayPacket::LANES; lane++)
+			{
+				float lowerX = (box.Lower.x - packet.OriginX[lane]) * packet.InverseX[lane];
+				float upperX = (box.Upper.x - packet.OriginX[lane]) * packet.InverseX[lane];
+				float lowerY = (box.Lower.y - packet.OriginY[lane]) * packet.InverseY[lane];
+				float upperY = (box.Upper.y - packet.OriginY[lane]) * packet.InverseY[lane];
+
+				float enter = std::max({ std::min(lowerX, upperX), std::min(lowerY, upperY), 0.f });
+				float exit = std::min({ std::max(lowerX, upperX), std::max(lowerY, upperY), packet.MaxFraction[lane] });
+				mask |= static_cast<uint32_t>(enter <= exit) << lane;
+			}
+
+			return mask;
+#endif
+		}
+	} // namespace simd
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <aabb.hpp>
+#include <dynamic_aabb_tree.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Bounding volume hierarchy of objects that never move, built once and only queried afterwards.
+	* Nodes are stored flat in depth-first order: the left child follows its parent, so a query
+	* mostly walks forward through memory. Leaves hold tight bounds of up to MAX_LEAF_ITEMS objects
+	* @tparam T: user data stored for each object
+	*/
+	template <typename T>
+	class StaticBvh
+	{
+	public:
+		static constexpr uint32_t MAX_LEAF_ITEMS = 4;
+
+		struct Item
+		{
+			Aabb Bounds;
+			T UserData;
+		};
+
+		struct Node
+		{
+			Aabb Bounds;
+			// first item of a leaf or the right child of an inner node
+			uint32_t Offset;
+			// items of a leaf, 0 for inner nodes
+			uint32_t Count;
+		};
+
+		/**
+		* @brief Replaces the tree with one over the items, splitting at the median along the longest axis
+		*/
+		void Build(std::vector<Item> items)
+		{
+			_items = std::move(items);
+			_nodes.clear();
+
+			if (_items.empty())
+			{
+				return;
+			}
+
+			// median splits leave at least 2 items in a leaf, so there are no more nodes than items
+			_nodes.reserve(_items.size());
+			BuildNode(0, static_cast<uint32_t>(_items.size()));
+		}
+
+		void clear() noexcept
+		{
+			_nodes.clear();
+			_items.clear();
+		}
+
+		size_t size() const noexcept
+		{
+			return _items.size();
+		}
+
+		size_t GetNodeCount() const noexcept
+		{
+			return _nodes.size();
+		}
+
+		/**
+		* @brief Calls callback(userData) for each object whose bounds overlap the box
+		* @param aabb: query box
+		* @param callback: returns false to stop the query
+		*/
+		template <typename Callback>
+		void Query(const Aabb& aabb, Callback&& callback) const
+		{
+			Traverse([&aabb](const Aabb& bounds) { return bounds.Overlaps(aabb); }, callback);
+		}
+
+		/**
+		* @brief Walks the subtrees whose bounds pass the test and calls callback(userData) for each object that passes it
+		* @param test: callable with (const Aabb& bounds) returning false to skip the node or object
+		* @param callback: returns false to stop the traversal
+		*/
+		template <typename Test, typename Callback>
+		void Traverse(Test&& test, Callback&& callback) const
+		{
+			if (_nodes.empty())
+			{
+				return;
+			}
+
+			detail::NodeStack stack;
+			stack.Push(0);
+
+			while (!stack.Empty())
+			{
+				const Node& node = _nodes[stack.Pop()];
+
+				if (!test(node.Bounds))
+				{
+					continue;
+				}
+
+				if (node.Count == 0)
+				{
+					// the left child is visited first, it's the next node in memory
+					stack.Push(static_cast<int32_t>(node.Offset));
+					stack.Push(static_cast<int32_t>(&node - _nodes.data() + 1));
+					continue;
+				}
+
+				for (uint32_t i = node.Offset; i < node.Offset + node.Count; i++)
+				{
+					if (test(_items[i].Bounds) && !callback(_items[i].UserData))
+					{
+						return;
+					}
+				}
+			}
+		}
+
+		/**
+		* @returns nodes in depth-first order, e.g. to store a prebuilt tree, the root is the first one
+		*/
+		const std::vector<Node>& GetNodes() const noexcept
+		{
+			return _nodes;
+		}
+
+		/**
+		* @returns items in leaf order, a leaf holds items [Offset, Offset + Count)
+		*/
+		const std::vector<Item>& GetItems() const noexcept
+		{
+			return _items;
+		}
+
+	private:
+		uint32_t BuildNode(uint32_t begin, uint32_t end)
+		{
+			uint32_t nodeId = static_cast<uint32_t>(_nodes.size());
+			_nodes.push_back(Node{ _items[begin].Bounds, begin, end - begin });
+
+			for (uint32_t i = begin + 1; i < end; i++)
+			{
+				_nodes[nodeId].Bounds = Aabb::Union(_nodes[nodeId].Bounds, _items[i].Bounds);
+			}
+
+			if (end - begin <= MAX_LEAF_ITEMS)
+			{
+				return nodeId;
+			}
+
+			// centers are split rather than bounds, so long items don't pull everything to one side
+			Aabb centers{ _items[begin].Bounds.Center(), _items[begin].Bounds.Center() };
+
+			for (uint32_t i = begin + 1; i < end; i++)
+			{
+				sf::Vector2f center = _items[i].Bounds.Center();
+				centers = Aabb::Union(centers, Aabb{ center, center });
+			}
+
+			sf::Vector2f extent = centers.Upper - centers.Lower;
+			bool isSplitAlongX = extent.x >= extent.y;
+			uint32_t middle = begin + (end - begin) / 2;
+
+			std::nth_element(_items.begin() + begin, _items.begin() + middle, _items.begin() + end, [isSplitAlongX](const Item& a, const Item& b)
+			{
+				return isSplitAlongX ? a.Bounds.Center().x < b.Bounds.Center().x : a.Bounds.Center().y < b.Bounds.Center().y;
+			});
+
+			BuildNode(begin, middle);
+			uint32_t right = BuildNode(middle, end);
+			_nodes[nodeId].Offset = right;
+			_nodes[nodeId].Count = 0;
+			return nodeId;
+		}
+
+		std::vector<Node> _nodes;
+		std::vector<Item> _items;
+	};
+} // namespace Engine
\ No newline at end of file
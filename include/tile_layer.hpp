@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <world.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Rectangle of whole tiles, in tile coordinates
+	*/
+	struct TileRect
+	{
+		uint32_t X = 0;
+		uint32_t Y = 0;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+	};
+
+	/**
+	* @brief Covers the solid tiles of a region with rectangles: from each uncovered solid tile in row order
+	* a run is extended to the right, then down while the whole run below is solid and uncovered
+	* @param solid: row-major bitmap of the whole map, nonzero for solid tiles
+	* @param width: tiles in a row of the bitmap
+	* @param region: part of the bitmap to cover, rectangles don't leave it
+	*/
+	std::vector<TileRect> mergeTiles(std::span<const uint8_t> solid, uint32_t width, const TileRect& region);
+
+	/**
+	* @brief Collision layer of a tile grid: solid tiles are merged into few rectangles that are static geometry
+	* of the world, so they go through the same broadphase and narrowphase as any other map part and
+	* a body sliding along a floor meets no edges between tiles. The grid is split into chunks of CHUNK_ROWS rows
+	* over the whole width, an edit rebuilds only the rectangles of its chunk on the next Rebuild.
+	* Runs along a row are never cut: a box sliding onto the next rectangle of a floor would be stopped
+	* by its side as soon as they touch. Walls are cut between chunks
+	*/
+	class TileLayer
+	{
+	public:
+		// rows of a chunk, rectangles end at chunk borders
+		static constexpr uint32_t CHUNK_ROWS = 16;
+
+		/**
+		* @param world: gets the rectangles as static geometry, must outlive the layer
+		* @param width: tiles in a row
+		* @param height: tiles in a column
+		* @param tileSize: size of a tile in pixels
+		* @param origin: position of the top-left corner of tile (0, 0)
+		*/
+		TileLayer(World& world, uint32_t width, uint32_t height, const sf::Vector2f& tileSize, const sf::Vector2f& origin = {})
+			: _world(world), _width(width), _height(height), _tileSize(tileSize), _origin(origin),
+			_tiles(static_cast<size_t>(width) * height, 0), _chunks((height + CHUNK_ROWS - 1) / CHUNK_ROWS) {}
+
+		TileLayer(const TileLayer&) = delete;
+		TileLayer& operator=(const TileLayer&) = delete;
+
+		~TileLayer()
+		{
+			for (Chunk& chunk : _chunks)
+			{
+				Clear(chunk);
+			}
+		}
+
+		/**
+		* @brief Changes a tile, the world sees the change after the next Rebuild
+		*/
+		void SetSolid(uint32_t x, uint32_t y, bool isSolid)
+		{
+			uint8_t& tile = _tiles[static_cast<size_t>(y) * _width + x];
+
+			if ((tile != 0) != isSolid)
+			{
+				tile = isSolid ? 1 : 0;
+				_chunks[y / CHUNK_ROWS].IsDirty = true;
+			}
+		}
+
+		bool IsSolid(uint32_t x, uint32_t y) const
+		{
+			return _tiles[static_cast<size_t>(y) * _width + x] != 0;
+		}
+
+		/**
+		* @brief Replaces the rectangles of the chunks with edited tiles in the world
+		* @returns number of rebuilt chunks
+		*/
+		size_t Rebuild()
+		{
+			size_t rebuilt = 0;
+
+			for (uint32_t chunkIndex = 0; chunkIndex < _chunks.size(); chunkIndex++)
+			{
+				Chunk& chunk = _chunks[chunkIndex];
+
+				if (!chunk.IsDirty)
+				{
+					continue;
+				}
+
+				Clear(chunk);
+
+				TileRect region{ 0, chunkIndex * CHUNK_ROWS, _width, std::min(CHUNK_ROWS, _height - chunkIndex * CHUNK_ROWS) };
+
+				for (const TileRect& rectangle : mergeTiles(_tiles, _width, region))
+				{
+					auto shape = std::make_unique<sf::RectangleShape>(sf::Vector2f{ rectangle.Width * _tileSize.x, rectangle.Height * _tileSize.y });
+					shape->setPosition(_origin + sf::Vector2f{ rectangle.X * _tileSize.x, rectangle.Y * _tileSize.y });
+					chunk.Bodies.push_back(_world.CreateStaticGeometry(shape.get()));
+					chunk.Shapes.push_back(std::move(shape));
+				}
+
+				chunk.IsDirty = false;
+				rebuilt++;
+			}
+
+			return rebuilt;
+		}
+
+		/**
+		* @brief Calls callback(const sf::RectangleShape&) for each merged rectangle, e.g. to draw the layer
+		*/
+		template <typename Callback>
+		void ForEachRectangle(Callback&& callback) const
+		{
+			for (const Chunk& chunk : _chunks)
+			{
+				for (const auto& shape : chunk.Shapes)
+				{
+					callback(static_cast<const sf::RectangleShape&>(*shape));
+				}
+			}
+		}
+
+		size_t GetRectangleCount() const noexcept
+		{
+			size_t count = 0;
+
+			for (const Chunk& chunk : _chunks)
+			{
+				count += chunk.Shapes.size();
+			}
+
+			return count;
+		}
+
+		uint32_t GetWidth() const noexcept
+		{
+			return _width;
+		}
+
+		uint32_t GetHeight() const noexcept
+		{
+			return _height;
+		}
+
+	private:
+		struct Chunk
+		{
+			// shapes are kept behind pointers, the world holds on to them
+			std::vector<std::unique_ptr<sf::RectangleShape>> Shapes;
+			std::vector<BodyId> Bodies;
+			bool IsDirty = false;
+		};
+
+		void Clear(Chunk& chunk)
+		{
+			for (BodyId body : chunk.Bodies)
+			{
+				_world.DestroyBody(body);
+			}
+
+			chunk.Bodies.clear();
+			chunk.Shapes.clear();
+		}
+
+		World& _world;
+		uint32_t _width;
+		uint32_t _height;
+		sf::Vector2f _tileSize;
+		sf::Vector2f _origin;
+		std::vector<uint8_t> _tiles;
+		std::vector<Chunk> _chunks;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <math.hpp>
+#include <collision_hull.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief First contact of a shape moving along a straight line
+	*/
+	struct TimeOfImpact
+	{
+		// part of the displacement covered before the contact, in [0, 1]
+		float Time;
+		// unit normal of the hit, pointing from shape B to shape A like the MTV
+		sf::Vector2f Normal;
+	};
+
+	namespace detail
+	{
+		/**
+		* @brief Swept SAT state: latest entry and earliest exit over the tested axes
+		*/
+		struct SweepState
+		{
+			float Enter = -std::numeric_limits<float>::infinity();
+			float Exit = std::numeric_limits<float>::infinity();
+			sf::Vector2f Normal;
+		};
+
+		/**
+		* @brief Narrows the time interval the shapes overlap in on the axis
+		* @param axis: unit axis
+		* @param displacement: movement of A relative to B
+		* @returns false if the shapes don't meet on this axis during the move
+		*/
+		inline bool sweepOnAxis(std::span<const sf::Vector2f> a, std::span<const sf::Vector2f> b, const sf::Vector2f& axis, const sf::Vector2f& displacement, SweepState& state)
+		{
+			ENGINE_PROFILE_COUNT(AxesTested, 1);
+			auto [minProjectionA, maxProjectionA] = projectionBounds(a, axis);
+			auto [minProjectionB, maxProjectionB] = projectionBounds(b, axis);
+			float speed = dot(displacement, axis);
+
+			float enter = -std::numeric_limits<float>::infinity();
+			float exit = std::numeric_limits<float>::infinity();
+			sf::Vector2f normalVector = axis;
+
+			/*
+			* A moves towards B along the axis
+			*
+			* Amin----Amax  -->  Bmin----Bmax    enters at Bmin - Amax, leaves at Bmax - Amin
+			* Bmin----Bmax  <--  Amin----Amax    enters at Bmax - Amin, leaves at Bmin - Amax
+			*/
+			if (maxProjectionA < minProjectionB)
+			{
+				if (speed <= 0.f)
+				{
+					return false;
+				}
+
+				enter = (minProjectionB - maxProjectionA) / speed;
+				exit = (maxProjectionB - minProjectionA) / speed;
+				normalVector = -axis;
+			}
+			else if (maxProjectionB < minProjectionA)
+			{
+				if (speed >= 0.f)
+				{
+					return false;
+				}
+
+				enter = (maxProjectionB - minProjectionA) / speed;
+				exit = (minProjectionB - maxProjectionA) / speed;
+			}
+			else if (speed != 0.f)
+			{
+				// already overlapping on this axis, only the exit is limited
+				exit = speed > 0.f ? (maxProjectionB - minProjectionA) / speed : (minProjectionB - maxProjectionA) / speed;
+			}
+
+			if (enter > state.Enter)
+			{
+				state.Enter = enter;
+				state.Normal = normalVector;
+			}
+
+			state.Exit = std::min(state.Exit, exit);
+			return state.Enter <= state.Exit && state.Enter <= 1.f;
+		}
+
+		inline std::optional<TimeOfImpact> sweepResult(const SweepState& state)
+		{
+			// overlapping at the start is left to the discrete narrowphase
+			if (state.Enter < 0.f)
+			{
+				return std::nullopt;
+			}
+
+			return TimeOfImpact{ state.Enter, state.Normal };
+		}
+	} // namespace detail
+
+	/**
+	* @brief Swept SAT: finds when shape A moving by the displacement first touches resting shape B.
+	* Shapes only translate during the move, so the edge normals of both shapes are enough
+	* @param aShapeVertices: first shape vertices at the start of the move
+	* @param bShapeVertices: second shape vertices
+	* @param displacement: movement of A relative to B
+	* @return std::nullopt if the shapes don't meet during the move or already overlap at its start
+	*/
+	inline std::optional<TimeOfImpact> sweptSeparatingAxisTest(const std::vector<sf::Vector2f>& aShapeVertices, const std::vector<sf::Vector2f>& bShapeVertices, const sf::Vector2f& displacement)
+	{
+		detail::SweepState state;
+
+		for (const std::vector<sf::Vector2f>* vertices : { &aShapeVertices, &bShapeVertices })
+		{
+			for (size_t i = 0; i < vertices->size(); i++)
+			{
+				sf::Vector2f axis = normal((*vertices)[(i + 1) % vertices->size()] - (*vertices)[i]);
+
+				if (!detail::sweepOnAxis(aShapeVertices, bShapeVertices, axis, displacement, state))
+				{
+					return std::nullopt;
+				}
+			}
+		}
+
+		return detail::sweepResult(state);
+	}
+
+	/**
+	* @brief Swept SAT over hulls, uses their axes and allocates nothing
+	* @param a: moving shape hull at the start of the move
+	* @param b: resting shape hull
+	* @param displacement: movement of A relative to B
+	*/
+	inline std::optional<TimeOfImpact> sweptSeparatingAxisTest(const HullView& a, const HullView& b, const sf::Vector2f& displacement)
+	{
+		detail::SweepState state;
+
+		for (const HullView* hull : { &a, &b })
+		{
+			for (const auto& axis : hull->Axes)
+			{
+				if (!detail::sweepOnAxis(a.Vertices, b.Vertices, axis, displacement, state))
+				{
+					return std::nullopt;
+				}
+			}
+		}
+
+		return detail::sweepResult(state);
+	}
+
+	inline std::optional<TimeOfImpact> sweptSeparatingAxisTest(const CollisionHull& a, const CollisionHull& b, const sf::Vector2f& displacement)
+	{
+		return sweptSeparatingAxisTest(a.GetView(), b.GetView(), displacement);
+	}
+} // namespace Engine
\ No newline at end of file
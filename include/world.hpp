@@ -0,0 +1,1190 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Shape.hpp>
+
+#include <math.hpp>
+#include <aabb.hpp>
+#include <dynamic_aabb_tree.hpp>
+#include <static_bvh.hpp>
+#include <body_storage.hpp>
+#include <collision_hull.hpp>
+#include <contact_manifold.hpp>
+#include <time_of_impact.hpp>
+#include <spatial_query.hpp>
+#include <parallel_narrowphase.hpp>
+#include <profiler.hpp>
+
+namespace Engine
+{
+	struct BodySnapshot
+	{
+		BodyId Body;
+		sf::Vector2f Position;
+		float Rotation;
+		sf::Vector2f Velocity;
+	};
+
+	/**
+	* @brief Motion state of every body, e.g. to check that a replay follows the recorded session
+	*/
+	struct WorldSnapshot
+	{
+		uint64_t StepCount = 0;
+		std::vector<BodySnapshot> Bodies;
+	};
+
+	/**
+	* @brief Simulation without rendering: bodies are made from SFML shapes owned by the caller, the world moves
+	* dynamic bodies under gravity and pushes them out of each other with a fixed time step.
+	* Bodies live in a structure of arrays, shapes are read on creation and SyncBody and written by SyncShapes.
+	* Static bodies don't move by themselves, static geometry never moves and is kept out of the incremental
+	* broadphase in a BVH baked once, which is all dynamic bodies query for it. Contact velocities are solved with sequential impulses
+	* warm started from the contact manifolds of the previous step.
+	* Dynamic bodies touching each other form islands, an island that rests long enough falls asleep:
+	* its bodies aren't integrated and get no candidate pairs until something touches or moves them.
+	* Concave shapes are split into convex pieces that are tested pair by pair, the body stays one broadphase proxy.
+	* Bodies flagged as fast are swept against static bodies, so they don't tunnel through thin parts.
+	* Rays, boxes, points and shapes can be queried against the bodies between steps, queries see the body
+	* geometry tested by the last narrowphase
+	*/
+	class World
+	{
+	public:
+		using BodyId = Engine::BodyId;
+
+		/**
+		* @param timeStep: duration of one step in seconds
+		* @param workerCount: threads of the narrowphase, 1 runs it on the calling thread, 0 uses every hardware thread
+		*/
+		explicit World(float timeStep = 1.f / 120.f, size_t workerCount = 1)
+			: _timeStep(timeStep), _pool(workerCount), _narrowphase(_pool) {}
+
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		/**
+		* @brief Adds a shape that is moved only by the caller, e.g. a map part
+		* @param shape: simple polygon, a concave one is split into convex pieces, must outlive the body
+		*/
+		BodyId CreateStaticBody(sf::Shape* shape)
+		{
+			return CreateBody(shape, true);
+		}
+
+		/**
+		* @brief Adds a map part that never moves. Its world-space data is computed once and it goes into
+		* the baked static BVH instead of the incremental broadphase, the BVH is rebuilt by the next step
+		* or by BakeStaticGeometry after static geometry has been added or removed
+		* @param shape: simple polygon, a concave one is split into convex pieces, must outlive the body
+		*/
+		BodyId CreateStaticGeometry(sf::Shape* shape)
+		{
+			_isStaticGeometryBaked = false;
+			return _bodies.Create(shape, true);
+		}
+
+		/**
+		* @brief Adds static geometry without a shape, e.g. a map part mapped from a scene file
+		* @param polygon: simple polygon in world space, a concave one is split into convex pieces, must outlive the body
+		*/
+		BodyId CreateStaticGeometry(std::span<const sf::Vector2f> polygon)
+		{
+			_isStaticGeometryBaked = false;
+			return _bodies.Create(polygon, true);
+		}
+
+		/**
+		* @brief Builds the BVH of static geometry, e.g. at load time, so the first step doesn't have to
+		*/
+		void BakeStaticGeometry()
+		{
+			ENGINE_PROFILE_SCOPE(Broadphase);
+
+			std::vector<StaticBvh<BodyId>::Item> items;
+
+			for (uint32_t index = 0; index < _bodies.GetStaticCount(); index++)
+			{
+				if (IsStaticGeometry(index))
+				{
+					items.push_back({ _bodies.Bounds[index], _bodies.Handles[index] });
+				}
+			}
+
+			_staticGeometry.Build(std::move(items));
+			_isStaticGeometryBaked = true;
+		}
+
+		/**
+		* @brief Adds a shape that falls and is pushed out of other bodies
+		* @param shape: simple polygon, a concave one is split into convex pieces, must outlive the body
+		*/
+		BodyId CreateDynamicBody(sf::Shape* shape)
+		{
+			return CreateBody(shape, false);
+		}
+
+		/**
+		* @brief Removes the body and wakes the bodies it touches. The handle becomes invalid,
+		* contacts of the last step may still name it
+		*/
+		void DestroyBody(BodyId id)
+		{
+			WakeIsland(id);
+			uint32_t index = _bodies.IndexOf(id);
+			WakeTouching(_bodies.Bounds[index]);
+
+			if (IsStaticGeometry(index))
+			{
+				_isStaticGeometryBaked = false;
+			}
+			else
+			{
+				_broadphase.DestroyProxy(_bodies.Proxies[index]);
+			}
+
+			_bodies.Destroy(id);
+		}
+
+		/**
+		* @returns false for handles of destroyed bodies
+		*/
+		bool IsValid(BodyId id) const noexcept
+		{
+			return _bodies.IsValid(id);
+		}
+
+		/**
+		* @brief Reads the body from its shape after the caller has moved, rotated or reshaped it and wakes the bodies it touches.
+		* The world doesn't read shapes otherwise
+		*/
+		void SyncBody(BodyId id)
+		{
+			uint32_t index = _bodies.IndexOf(id);
+			sf::Vector2f previousPosition = _bodies.Positions[index];
+			Aabb previousBounds = _bodies.Bounds[index];
+
+			if (_bodies.ReadShape(index))
+			{
+				Refit(index, previousPosition, previousBounds);
+			}
+		}
+
+		/**
+		* @brief Teleports the body and its shape, wakes the bodies it touches
+		*/
+		void SetPosition(BodyId id, const sf::Vector2f& position)
+		{
+			uint32_t index = _bodies.IndexOf(id);
+			sf::Vector2f previousPosition = _bodies.Positions[index];
+			Aabb previousBounds = _bodies.Bounds[index];
+
+			_bodies.Positions[index] = position;
+			_bodies.Transform(index);
+			_bodies.WriteShape(index);
+			Refit(index, previousPosition, previousBounds);
+		}
+
+		const sf::Vector2f& GetPosition(BodyId id) const
+		{
+			return _bodies.Positions[_bodies.IndexOf(id)];
+		}
+
+		/**
+		* @brief Rotates the body and its shape around the shape's origin, wakes the bodies it touches
+		* @param rotation: angle in degrees
+		*/
+		void SetRotation(BodyId id, float rotation)
+		{
+			uint32_t index = _bodies.IndexOf(id);
+			Aabb previousBounds = _bodies.Bounds[index];
+
+			_bodies.Rotations[index] = rotation;
+			_bodies.Transform(index);
+			_bodies.WriteShape(index);
+			Refit(index, _bodies.Positions[index], previousBounds);
+		}
+
+		float GetRotation(BodyId id) const
+		{
+			return _bodies.Rotations[_bodies.IndexOf(id)];
+		}
+
+		void SetGravity(const sf::Vector2f& gravity) noexcept
+		{
+			_gravity = gravity;
+		}
+
+		const sf::Vector2f& GetGravity() const noexcept
+		{
+			return _gravity;
+		}
+
+		/**
+		* @brief Sets the velocity and wakes the body's island
+		*/
+		void SetVelocity(BodyId id, const sf::Vector2f& velocity)
+		{
+			WakeIsland(id);
+			_bodies.Velocities[_bodies.IndexOf(id)] = velocity;
+		}
+
+		const sf::Vector2f& GetVelocity(BodyId id) const
+		{
+			return _bodies.Velocities[_bodies.IndexOf(id)];
+		}
+
+		/**
+		* @brief A fast body is moved by swept SAT: it stops at the first static body on its way
+		* and slides along it instead of passing through. Fast bodies aren't swept against dynamic ones
+		*/
+		void SetFastBody(BodyId id, bool isFast)
+		{
+			_bodies.IsFast[_bodies.IndexOf(id)] = isFast;
+		}
+
+		bool IsFastBody(BodyId id) const
+		{
+			return _bodies.IsFast[_bodies.IndexOf(id)];
+		}
+
+		/**
+		* @brief Tests a simplified hull of the body instead of its shape's vertices, e.g. for circles with many points.
+		* The proxy is computed now and again only when the shape's geometry changes, concave shapes keep their pieces
+		* @param lod: vertex budget and tolerance of the proxy, std::nullopt goes back to the shape's vertices
+		* @returns farthest distance of the shape's boundary from the proxy in pixels
+		*/
+		float SetCollisionLod(BodyId id, const std::optional<CollisionLod>& lod)
+		{
+			uint32_t index = _bodies.IndexOf(id);
+			Aabb previousBounds = _bodies.Bounds[index];
+
+			_bodies.SetLod(index, lod);
+			Refit(index, _bodies.Positions[index], previousBounds);
+			return _bodies.Deviations[index];
+		}
+
+		/**
+		* @returns farthest distance of the shape's boundary from its collision proxy, 0 without one
+		*/
+		float GetCollisionDeviation(BodyId id) const
+		{
+			return _bodies.Deviations[_bodies.IndexOf(id)];
+		}
+
+		/**
+		* @param iterations: passes of the velocity solver over all contacts in a step, warm starting
+		* lets resting stacks settle with a few of them
+		*/
+		void SetSolverIterations(size_t iterations) noexcept
+		{
+			_solverIterations = iterations;
+		}
+
+		size_t GetSolverIterations() const noexcept
+		{
+			return _solverIterations;
+		}
+
+		/**
+		* @brief Disabling sleeping wakes every body
+		*/
+		void SetSleepingEnabled(bool isEnabled)
+		{
+			_isSleepingEnabled = isEnabled;
+
+			while (!isEnabled && !_sleepingIslands.empty())
+			{
+				WakeIsland(_sleepingIslands.begin()->second.front());
+			}
+		}
+
+		bool IsSleepingEnabled() const noexcept
+		{
+			return _isSleepingEnabled;
+		}
+
+		bool IsSleeping(BodyId id) const
+		{
+			return _bodies.IsSleeping[_bodies.IndexOf(id)];
+		}
+
+		/**
+		* @brief Wakes the island of the body, does nothing for awake and static bodies
+		*/
+		void WakeBody(BodyId id)
+		{
+			WakeIsland(id);
+		}
+
+		size_t GetSleepingBodyCount() const noexcept
+		{
+			size_t count = 0;
+
+			for (const auto& [key, members] : _sleepingIslands)
+			{
+				count += members.size();
+			}
+
+			return count;
+		}
+
+		/**
+		* @brief Simulates one step: integrates velocities, finds collisions and resolves them.
+		* Only the body arrays change, shapes are written by SyncShapes
+		* @param dt: step duration in seconds
+		*/
+		void Step(float dt)
+		{
+			if (!_isStaticGeometryBaked)
+			{
+				BakeStaticGeometry();
+			}
+
+			Integrate(dt);
+			FindCandidatePairs();
+
+			{
+				ENGINE_PROFILE_SCOPE(Narrowphase);
+
+				_narrowphase.Run(_pairs, [this](const CandidatePair& pair, size_t)
+				{
+					uint32_t a = _bodies.IndexOf(pair.IdA);
+					uint32_t b = _bodies.IndexOf(pair.IdB);
+
+					// circles and boxes have routines of their own, a polygon would need its vertices copied into a collider
+					if (_bodies.ColliderKinds[a] != ColliderKind::Polygon && _bodies.ColliderKinds[b] != ColliderKind::Polygon)
+					{
+						return processCollision(_bodies.GetCollider(a), _bodies.GetCollider(b));
+					}
+
+					return processCollision(_bodies.GetHull(a, pair.PieceA), _bodies.GetHull(b, pair.PieceB));
+				});
+			}
+
+			BuildManifolds();
+			SolveVelocities();
+			Resolve();
+			UpdateSleeping(dt);
+			_stepCount++;
+		}
+
+		/**
+		* @brief Runs as many fixed steps as fit into the elapsed time, the rest is carried over to the next call.
+		* Shapes of dynamic bodies are synced for rendering afterwards
+		* @param frameTime: time since the previous call in seconds
+		* @returns how far the current state is between the last step and the next one, in [0, 1) for interpolation
+		*/
+		float Advance(float frameTime)
+		{
+			// a long stall (e.g. a dragged window) would need more steps than the next frame can afford
+			_accumulator += std::min(frameTime, MAX_FRAME_STEPS * _timeStep);
+
+			while (_accumulator >= _timeStep)
+			{
+				Step(_timeStep);
+				_accumulator -= _timeStep;
+			}
+
+			SyncShapes();
+			return _accumulator / _timeStep;
+		}
+
+		/**
+		* @brief Writes positions and rotations of dynamic bodies to their shapes
+		*/
+		void SyncShapes() const
+		{
+			for (uint32_t index = _bodies.GetStaticCount(); index < _bodies.size(); index++)
+			{
+				_bodies.WriteShape(index);
+			}
+		}
+
+		/**
+		* @brief Position to draw the body at between two steps
+		* @param alpha: value returned by Advance
+		*/
+		sf::Vector2f GetInterpolatedPosition(BodyId id, float alpha) const
+		{
+			uint32_t index = _bodies.IndexOf(id);
+			const sf::Vector2f& previousPosition = _bodies.PreviousPositions[index];
+			return previousPosition + (_bodies.Positions[index] - previousPosition) * alpha;
+		}
+
+		/**
+		* @brief Casts a batch of rays against every body. Rays traverse the trees in packets of simd::RayPacket::LANES:
+		* a node is visited when any ray of the packet crosses it, and a ray skips everything behind its closest hit so far
+		* @param hits: output with a place for every ray, gets the closest hit or Body == INVALID_BODY.
+		* Rays starting inside a body don't hit it
+		*/
+		void Raycast(std::span<const Ray> rays, std::span<RayHit> hits) const
+		{
+			constexpr size_t LANES = simd::RayPacket::LANES;
+			simd::RayPacket packet;
+
+			auto crosses = [&packet](const Aabb& box)
+			{
+				return simd::slabTest(packet, box) != 0;
+			};
+
+			for (size_t first = 0; first < rays.size(); first += LANES)
+			{
+				size_t count = std::min(LANES, rays.size() - first);
+
+				for (size_t lane = 0; lane < LANES; lane++)
+				{
+					if (lane < count)
+					{
+						packet.Set(lane, rays[first + lane]);
+						hits[first + lane] = RayHit{};
+					}
+					else
+					{
+						packet.Disable(lane);
+					}
+				}
+
+				auto castAgainst = [&](uint32_t index)
+				{
+					for (uint32_t piece = 0; piece < _bodies.GetPieceCount(index); piece++)
+					{
+						uint32_t lanes = simd::slabTest(packet, _bodies.GetPieceBounds(index, piece));
+						HullView hull = _bodies.GetHull(index, piece);
+
+						for (size_t lane = 0; lane < count; lane++)
+						{
+							if ((lanes >> lane & 1) == 0)
+							{
+								continue;
+							}
+
+							std::optional<RayHit> hit = raycast(rays[first + lane], hull);
+
+							if (hit && hit->Fraction < packet.MaxFraction[lane])
+							{
+								hit->Body = _bodies.Handles[index];
+								hits[first + lane] = *hit;
+								packet.MaxFraction[lane] = hit->Fraction;
+							}
+						}
+					}
+				};
+
+				_staticGeometry.Traverse(crosses, [&](BodyId id)
+				{
+					// geometry destroyed since the last bake
+					if (_bodies.IsValid(id))
+					{
+						castAgainst(_bodies.IndexOf(id));
+					}
+
+					return true;
+				});
+
+				_broadphase.Traverse(crosses, [&](int32_t proxyId)
+				{
+					castAgainst(_bodies.IndexOf(_broadphase.GetUserData(proxyId)));
+					return true;
+				});
+			}
+		}
+
+		/**
+		* @returns closest hit of the ray or std::nullopt, batches of rays are faster
+		*/
+		std::optional<RayHit> Raycast(const Ray& ray) const
+		{
+			RayHit hit;
+			Raycast(std::span<const Ray>{ &ray, 1 }, std::span<RayHit>{ &hit, 1 });
+			return hit.Body != INVALID_BODY ? std::optional<RayHit>{ hit } : std::nullopt;
+		}
+
+		/**
+		* @param bodies: output, cleared first, bodies whose bounds overlap the box
+		*/
+		void QueryAabb(const Aabb& box, std::vector<BodyId>& bodies) const
+		{
+			bodies.clear();
+			QueryBounds(box, [&](uint32_t index)
+			{
+				bodies.push_back(_bodies.Handles[index]);
+			});
+		}
+
+		/**
+		* @brief Runs QueryAabb for every box
+		* @param results: output, cleared first
+		*/
+		void QueryAabbs(std::span<const Aabb> boxes, QueryResults& results) const
+		{
+			results.clear();
+
+			for (const Aabb& box : boxes)
+			{
+				QueryBounds(box, [&](uint32_t index)
+				{
+					results.Bodies.push_back(_bodies.Handles[index]);
+				});
+
+				results.Offsets.push_back(static_cast<uint32_t>(results.Bodies.size()));
+			}
+		}
+
+		/**
+		* @param bodies: output, cleared first, bodies containing the point
+		*/
+		void QueryPoint(const sf::Vector2f& point, std::vector<BodyId>& bodies) const
+		{
+			bodies.clear();
+			QueryBounds(Aabb{ point, point }, [&](uint32_t index)
+			{
+				if (ContainsPoint(index, point))
+				{
+					bodies.push_back(_bodies.Handles[index]);
+				}
+			});
+		}
+
+		/**
+		* @brief Runs QueryPoint for every point
+		* @param results: output, cleared first
+		*/
+		void QueryPoints(std::span<const sf::Vector2f> points, QueryResults& results) const
+		{
+			results.clear();
+
+			for (const sf::Vector2f& point : points)
+			{
+				QueryBounds(Aabb{ point, point }, [&](uint32_t index)
+				{
+					if (ContainsPoint(index, point))
+					{
+						results.Bodies.push_back(_bodies.Handles[index]);
+					}
+				});
+
+				results.Offsets.push_back(static_cast<uint32_t>(results.Bodies.size()));
+			}
+		}
+
+		/**
+		* @brief Finds bodies overlapping a convex shape that doesn't need to be a body, e.g. an explosion area
+		* @param bodies: output, cleared first
+		*/
+		void QueryShape(const sf::Shape* shape, std::vector<BodyId>& bodies) const
+		{
+			bodies.clear();
+			CollisionHull hull{ shape };
+			HullView view = hull.GetView();
+
+			QueryBounds(Aabb::FromRect(shape->getGlobalBounds()), [&](uint32_t index)
+			{
+				for (uint32_t piece = 0; piece < _bodies.GetPieceCount(index); piece++)
+				{
+					if (processCollision(view, _bodies.GetHull(index, piece)))
+					{
+						bodies.push_back(_bodies.Handles[index]);
+						break;
+					}
+				}
+			});
+		}
+
+		/**
+		* @returns collisions found by the last step in candidate order, bodies of a pair are (dynamic, any)
+		*/
+		const std::vector<PairResponse>& GetContacts() const noexcept
+		{
+			return _narrowphase.GetResponses();
+		}
+
+		/**
+		* @returns contact manifolds of the last step, one per contact in the same order, with solved impulses
+		*/
+		const std::vector<ContactManifold>& GetManifolds() const noexcept
+		{
+			return _manifolds;
+		}
+
+		float GetTimeStep() const noexcept
+		{
+			return _timeStep;
+		}
+
+		uint64_t GetStepCount() const noexcept
+		{
+			return _stepCount;
+		}
+
+		size_t GetBodyCount() const noexcept
+		{
+			return _bodies.size();
+		}
+
+		/**
+		* @returns motion state of the bodies in storage order, the same for worlds that went through the same calls
+		*/
+		WorldSnapshot CaptureSnapshot() const
+		{
+			WorldSnapshot snapshot{ _stepCount, {} };
+			snapshot.Bodies.reserve(_bodies.size());
+
+			for (uint32_t index = 0; index < _bodies.size(); index++)
+			{
+				snapshot.Bodies.push_back(BodySnapshot{ _bodies.Handles[index], _bodies.Positions[index], _bodies.Rotations[index], _bodies.Velocities[index] });
+			}
+
+			return snapshot;
+		}
+
+	private:
+		BodyId CreateBody(sf::Shape* shape, bool isStatic)
+		{
+			BodyId id = _bodies.Create(shape, isStatic);
+			uint32_t index = _bodies.IndexOf(id);
+			_bodies.Proxies[index] = _broadphase.CreateProxy(_bodies.Bounds[index], id);
+			return id;
+		}
+
+		/**
+		* @brief Calls callback(index) for every body whose tight bounds overlap the box
+		*/
+		template <typename Callback>
+		void QueryBounds(const Aabb& box, Callback&& callback) const
+		{
+			_staticGeometry.Query(box, [&](BodyId id)
+			{
+				// geometry destroyed since the last bake
+				if (_bodies.IsValid(id))
+				{
+					callback(_bodies.IndexOf(id));
+				}
+
+				return true;
+			});
+
+			_broadphase.Query(box, [&](int32_t proxyId)
+			{
+				uint32_t index = _bodies.IndexOf(_broadphase.GetUserData(proxyId));
+
+				if (_bodies.Bounds[index].Overlaps(box))
+				{
+					callback(index);
+				}
+
+				return true;
+			});
+		}
+
+		bool ContainsPoint(uint32_t index, const sf::Vector2f& point) const
+		{
+			for (uint32_t piece = 0; piece < _bodies.GetPieceCount(index); piece++)
+			{
+				if (containsPoint(_bodies.GetHull(index, piece), point))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		bool IsStaticGeometry(uint32_t index) const noexcept
+		{
+			return _bodies.Proxies[index] == DynamicAabbTree<BodyId>::NULL_NODE;
+		}
+
+		/**
+		* @brief Moves the proxy of a body the caller has changed. Bodies resting on the old place lose their support,
+		* bodies at the new one are hit, both are woken. Moved static geometry is baked again by the next step
+		*/
+		void Refit(uint32_t index, const sf::Vector2f& previousPosition, const Aabb& previousBounds)
+		{
+			_bodies.PreviousPositions[index] = _bodies.Positions[index];
+
+			if (IsStaticGeometry(index))
+			{
+				_isStaticGeometryBaked = false;
+			}
+			else
+			{
+				_broadphase.MoveProxy(_bodies.Proxies[index], _bodies.Bounds[index], _bodies.Positions[index] - previousPosition);
+			}
+
+			WakeTouching(previousBounds);
+			WakeTouching(_bodies.Bounds[index]);
+		}
+
+		void WakeTouching(const Aabb& bounds)
+		{
+			_broadphase.Query(bounds, [this](int32_t proxyId)
+			{
+				WakeIsland(_broadphase.GetUserData(proxyId));
+				return true;
+			});
+		}
+
+		void Integrate(float dt)
+		{
+			ENGINE_PROFILE_SCOPE(Integration);
+
+			for (uint32_t index = _bodies.GetStaticCount(); index < _bodies.size(); index++)
+			{
+				if (_bodies.IsSleeping[index])
+				{
+					continue;
+				}
+
+				sf::Vector2f& velocity = _bodies.Velocities[index];
+				velocity += _gravity * dt;
+				_bodies.PreviousPositions[index] = _bodies.Positions[index];
+				sf::Vector2f displacement = velocity * dt;
+
+				if (_bodies.IsFast[index])
+				{
+					displacement = SweepFastBody(index, displacement);
+				}
+				else
+				{
+					_bodies.Positions[index] += displacement;
+				}
+
+				// the resolution of the previous step has moved the body too
+				_bodies.Transform(index);
+				_broadphase.MoveProxy(_bodies.Proxies[index], _bodies.Bounds[index], displacement);
+			}
+		}
+
+		/**
+		* @brief Moves the body by the displacement, stopping TOI_SLOP short of the first static body on the way.
+		* The motion into the hit surface is removed from the rest of the move and from the velocity, so the body slides along it
+		* @returns movement the body has made
+		*/
+		sf::Vector2f SweepFastBody(uint32_t index, sf::Vector2f displacement)
+		{
+			ENGINE_PROFILE_SCOPE(TimeOfImpact);
+
+			sf::Vector2f& position = _bodies.Positions[index];
+			sf::Vector2f& velocity = _bodies.Velocities[index];
+			sf::Vector2f start = position;
+
+			for (size_t sweep = 0; sweep < MAX_SWEEPS; sweep++)
+			{
+				float distance = std::sqrt(dot(displacement, displacement));
+
+				if (distance == 0.f)
+				{
+					break;
+				}
+
+				_bodies.Transform(index);
+				const Aabb& bounds = _bodies.Bounds[index];
+				Aabb swept = Aabb::Union(bounds, Aabb{ bounds.Lower + displacement, bounds.Upper + displacement });
+				std::optional<TimeOfImpact> firstHit;
+
+				auto sweepAgainst = [&](uint32_t other)
+				{
+					for (uint32_t piece = 0; piece < _bodies.GetPieceCount(index); piece++)
+					{
+						for (uint32_t otherPiece = 0; otherPiece < _bodies.GetPieceCount(other); otherPiece++)
+						{
+							std::optional<TimeOfImpact> hit = sweptSeparatingAxisTest(_bodies.GetHull(index, piece), _bodies.GetHull(other, otherPiece), displacement);
+
+							if (hit && (!firstHit || hit->Time < firstHit->Time))
+							{
+								firstHit = hit;
+							}
+						}
+					}
+				};
+
+				_staticGeometry.Query(swept, [&](BodyId other)
+				{
+					sweepAgainst(_bodies.IndexOf(other));
+					return true;
+				});
+
+				_broadphase.Query(swept, [&](int32_t proxyId)
+				{
+					uint32_t other = _bodies.IndexOf(_broadphase.GetUserData(proxyId));
+
+					if (other < _bodies.GetStaticCount())
+					{
+						sweepAgainst(other);
+					}
+
+					return true;
+				});
+
+				if (!firstHit)
+				{
+					position += displacement;
+					break;
+				}
+
+				// the gap keeps the next sweep from starting in an overlap
+				float time = std::max(firstHit->Time - TOI_SLOP / distance, 0.f);
+				position += displacement * time;
+
+				const sf::Vector2f& hitNormal = firstHit->Normal;
+				displacement *= 1.f - time;
+				displacement -= hitNormal * std::min(dot(displacement, hitNormal), 0.f);
+				velocity -= hitNormal * std::min(dot(velocity, hitNormal), 0.f);
+			}
+
+			return position - start;
+		}
+
+		/**
+		* @brief Collects pairs of awake bodies, static geometry comes from the baked BVH and the rest from the incremental tree.
+		* A sleeping body touched by an awake one wakes up with its island, then the pairs are collected again, so every pair is still taken once
+		*/
+		void FindCandidatePairs()
+		{
+			ENGINE_PROFILE_SCOPE(Broadphase);
+
+			const uint32_t staticCount = _bodies.GetStaticCount();
+			bool hasWoken = true;
+
+			while (hasWoken)
+			{
+				hasWoken = false;
+				_pairs.clear();
+
+				for (uint32_t index = staticCount; index < _bodies.size(); index++)
+				{
+					if (_bodies.IsSleeping[index])
+					{
+						continue;
+					}
+
+					const Aabb& bounds = _bodies.Bounds[index];
+
+					_staticGeometry.Query(bounds, [&](BodyId other)
+					{
+						AddPairs(index, _bodies.IndexOf(other));
+						return true;
+					});
+
+					_broadphase.Query(bounds, [&](int32_t proxyId)
+					{
+						uint32_t other = _bodies.IndexOf(_broadphase.GetUserData(proxyId));
+						bool isOtherStatic = other < staticCount;
+
+						if (other == index || (!isOtherStatic && !_bodies.Bounds[other].Overlaps(bounds)))
+						{
+							return true;
+						}
+
+						if (_bodies.IsSleeping[other])
+						{
+							WakeIsland(_bodies.Handles[other]);
+							hasWoken = true;
+							return true;
+						}
+
+						// a pair of dynamic bodies is taken once, tight bounds make the check symmetric
+						if (!isOtherStatic && other < index)
+						{
+							return true;
+						}
+
+						AddPairs(index, other);
+						return true;
+					});
+				}
+			}
+		}
+
+		/**
+		* @brief Adds the candidate pair of two bodies, or a pair for every two overlapping pieces when a body is concave.
+		* A concave body stays one broadphase proxy
+		*/
+		void AddPairs(uint32_t a, uint32_t b)
+		{
+			uint32_t piecesA = _bodies.GetPieceCount(a);
+			uint32_t piecesB = _bodies.GetPieceCount(b);
+
+			if (piecesA == 1 && piecesB == 1)
+			{
+				_pairs.push_back(CandidatePair{ _bodies.Handles[a], _bodies.Handles[b] });
+				return;
+			}
+
+			for (uint32_t pieceA = 0; pieceA < piecesA; pieceA++)
+			{
+				for (uint32_t pieceB = 0; pieceB < piecesB; pieceB++)
+				{
+					if (_bodies.GetPieceBounds(a, pieceA).Overlaps(_bodies.GetPieceBounds(b, pieceB)))
+					{
+						_pairs.push_back(CandidatePair{ _bodies.Handles[a], _bodies.Handles[b], static_cast<uint16_t>(pieceA), static_cast<uint16_t>(pieceB) });
+					}
+				}
+			}
+		}
+
+		/**
+		* @brief Clips a manifold for every contact and takes the impulses of matching points from the previous step.
+		* Dense indices of the contact bodies are looked up once for the rest of the step
+		*/
+		void BuildManifolds()
+		{
+			ENGINE_PROFILE_SCOPE(Resolution);
+
+			_manifolds.clear();
+			_contactBodies.clear();
+
+			for (const auto& [pairIndex, pair, response] : _narrowphase.GetResponses())
+			{
+				uint32_t a = _bodies.IndexOf(pair.IdA);
+				uint32_t b = _bodies.IndexOf(pair.IdB);
+				ContactManifold manifold = findContactManifold(_bodies.GetHull(a, pair.PieceA), _bodies.GetHull(b, pair.PieceB), response);
+
+				// touching corners can clip away both points, the SAT point keeps the contact solved
+				if (manifold.PointCount == 0)
+				{
+					manifold.Points[0].Position = response.PointOfCollision;
+					manifold.Points[0].Penetration = std::sqrt(dot(response.MinimumTransitionVector, response.MinimumTransitionVector));
+					manifold.PointCount = 1;
+				}
+
+				_manifoldCache.WarmStart(pair.IdA, pair.IdB, manifold, pair.PieceA, pair.PieceB);
+				_manifolds.push_back(manifold);
+				_contactBodies.push_back({ a, b });
+			}
+		}
+
+		/**
+		* @brief Removes the velocity that moves bodies into each other. Accumulated impulses are applied first,
+		* then every iteration corrects them point by point, an accumulated impulse never pulls the bodies together
+		*/
+		void SolveVelocities()
+		{
+			ENGINE_PROFILE_SCOPE(Resolution);
+
+			std::vector<sf::Vector2f>& velocities = _bodies.Velocities;
+			const std::vector<float>& inverseMasses = _bodies.InverseMasses;
+
+			for (size_t i = 0; i < _manifolds.size(); i++)
+			{
+				auto [a, b] = _contactBodies[i];
+				const ContactManifold& manifold = _manifolds[i];
+
+				for (uint8_t j = 0; j < manifold.PointCount; j++)
+				{
+					sf::Vector2f impulse = manifold.Normal * manifold.Points[j].NormalImpulse;
+					velocities[a] += impulse * inverseMasses[a];
+					velocities[b] -= impulse * inverseMasses[b];
+				}
+			}
+
+			for (size_t iteration = 0; iteration < _solverIterations; iteration++)
+			{
+				for (size_t i = 0; i < _manifolds.size(); i++)
+				{
+					auto [a, b] = _contactBodies[i];
+					ContactManifold& manifold = _manifolds[i];
+					float effectiveMass = 1.f / (inverseMasses[a] + inverseMasses[b]);
+
+					for (uint8_t j = 0; j < manifold.PointCount; j++)
+					{
+						ContactPoint& point = manifold.Points[j];
+						float approach = dot(velocities[a] - velocities[b], manifold.Normal);
+						float accumulated = std::max(point.NormalImpulse - approach * effectiveMass, 0.f);
+						sf::Vector2f impulse = manifold.Normal * (accumulated - point.NormalImpulse);
+						point.NormalImpulse = accumulated;
+
+						velocities[a] += impulse * inverseMasses[a];
+						velocities[b] -= impulse * inverseMasses[b];
+					}
+				}
+			}
+
+			const std::vector<PairResponse>& contacts = _narrowphase.GetResponses();
+
+			for (size_t i = 0; i < contacts.size(); i++)
+			{
+				const CandidatePair& pair = contacts[i].Pair;
+				_manifoldCache.Store(pair.IdA, pair.IdB, _manifolds[i], pair.PieceA, pair.PieceB);
+			}
+
+			_manifoldCache.EndStep();
+		}
+
+		/**
+		* @brief Pushes bodies apart along the MTV
+		*/
+		void Resolve()
+		{
+			ENGINE_PROFILE_SCOPE(Resolution);
+
+			const std::vector<PairResponse>& contacts = _narrowphase.GetResponses();
+
+			for (size_t i = 0; i < contacts.size(); i++)
+			{
+				auto [a, b] = _contactBodies[i];
+				const sf::Vector2f& MTV = contacts[i].Response.MinimumTransitionVector;
+
+				if (b < _bodies.GetStaticCount())
+				{
+					_bodies.Positions[a] += MTV;
+					continue;
+				}
+
+				// bodies have equal masses, each one goes half of the way
+				_bodies.Positions[a] += MTV / 2.f;
+				_bodies.Positions[b] -= MTV / 2.f;
+			}
+		}
+
+		/**
+		* @brief Builds islands of dynamic bodies connected by contacts and puts to sleep the ones
+		* whose bodies have all been resting for TIME_TO_SLEEP
+		*/
+		void UpdateSleeping(float dt)
+		{
+			if (!_isSleepingEnabled)
+			{
+				return;
+			}
+
+			const float MAX_DISPLACEMENT = SLEEP_VELOCITY * dt;
+			const uint32_t staticCount = _bodies.GetStaticCount();
+			_islandParents.resize(_bodies.size());
+			_islandSleepTimes.resize(_bodies.size());
+
+			for (uint32_t index = staticCount; index < _bodies.size(); index++)
+			{
+				_islandParents[index] = index;
+				_islandSleepTimes[index] = std::numeric_limits<float>::infinity();
+
+				// a resting body sinks by the integration and is pushed back by the MTV, so it barely moves in a step.
+				// The MTV alone stays long in stacks, where the pushes leave a steady overlap
+				const sf::Vector2f& velocity = _bodies.Velocities[index];
+				sf::Vector2f displacement = _bodies.Positions[index] - _bodies.PreviousPositions[index];
+				bool isResting = dot(velocity, velocity) <= SLEEP_VELOCITY * SLEEP_VELOCITY
+					&& dot(displacement, displacement) <= MAX_DISPLACEMENT * MAX_DISPLACEMENT;
+				_bodies.SleepTimes[index] = isResting ? _bodies.SleepTimes[index] + dt : 0.f;
+			}
+
+			// static bodies don't link islands, otherwise everything on the ground would be one island
+			for (auto [a, b] : _contactBodies)
+			{
+				if (b >= staticCount)
+				{
+					_islandParents[FindIsland(a)] = FindIsland(b);
+				}
+			}
+
+			for (uint32_t index = staticCount; index < _bodies.size(); index++)
+			{
+				if (!_bodies.IsSleeping[index])
+				{
+					float& islandSleepTime = _islandSleepTimes[FindIsland(index)];
+					islandSleepTime = std::min(islandSleepTime, _bodies.SleepTimes[index]);
+				}
+			}
+
+			for (uint32_t index = staticCount; index < _bodies.size(); index++)
+			{
+				uint32_t root = FindIsland(index);
+
+				if (_bodies.IsSleeping[index] || _islandSleepTimes[root] < TIME_TO_SLEEP)
+				{
+					continue;
+				}
+
+				// the resolution has moved the body, its bounds and proxy are brought in sync for the wake-up check
+				_bodies.IsSleeping[index] = 1;
+				_bodies.Islands[index] = _bodies.Handles[root];
+				_bodies.Velocities[index] = {};
+				_bodies.PreviousPositions[index] = _bodies.Positions[index];
+				_bodies.Transform(index);
+				_broadphase.MoveProxy(_bodies.Proxies[index], _bodies.Bounds[index], {});
+				_sleepingIslands[_bodies.Handles[root]].push_back(_bodies.Handles[index]);
+			}
+		}
+
+		/**
+		* @returns root of the body's island by dense index, sleeping bodies are roots of themselves
+		*/
+		uint32_t FindIsland(uint32_t index)
+		{
+			while (_islandParents[index] != index)
+			{
+				_islandParents[index] = _islandParents[_islandParents[index]];
+				index = _islandParents[index];
+			}
+
+			return index;
+		}
+
+		void WakeIsland(BodyId id)
+		{
+			uint32_t index = _bodies.IndexOf(id);
+
+			if (!_bodies.IsSleeping[index])
+			{
+				return;
+			}
+
+			auto island = _sleepingIslands.find(_bodies.Islands[index]);
+
+			for (BodyId member : island->second)
+			{
+				uint32_t memberIndex = _bodies.IndexOf(member);
+				_bodies.IsSleeping[memberIndex] = 0;
+				_bodies.SleepTimes[memberIndex] = 0.f;
+			}
+
+			_sleepingIslands.erase(island);
+		}
+
+		static constexpr float MAX_FRAME_STEPS = 8.f;
+		// sweeps of a fast body in a step, every hit surface takes one
+		static constexpr size_t MAX_SWEEPS = 4;
+		// distance in pixels a fast body stops before the surface it hits
+		static constexpr float TOI_SLOP = 0.01f;
+		// pixels per second, both the velocity and the movement in a step have to stay below it for a body to rest
+		static constexpr float SLEEP_VELOCITY = 2.f;
+		// seconds an island has to rest before it falls asleep
+		static constexpr float TIME_TO_SLEEP = 0.5f;
+
+		float _timeStep;
+		float _accumulator = 0.f;
+		uint64_t _stepCount = 0;
+		sf::Vector2f _gravity{ 0.f, 981.f };
+		size_t _solverIterations = 4;
+
+		BodyStorage _bodies;
+		DynamicAabbTree<BodyId> _broadphase;
+		StaticBvh<BodyId> _staticGeometry;
+		bool _isStaticGeometryBaked = true;
+		std::vector<CandidatePair> _pairs;
+		std::vector<ContactManifold> _manifolds;
+		// dense indices of the bodies of every contact, valid during the step
+		std::vector<std::pair<uint32_t, uint32_t>> _contactBodies;
+		ContactManifoldCache _manifoldCache;
+
+		bool _isSleepingEnabled = true;
+		// union-find forest of the last step's islands and the shortest rest time of every island root, by dense index
+		std::vector<uint32_t> _islandParents;
+		std::vector<float> _islandSleepTimes;
+		// handles of sleeping island members by the handle of the island root
+		std::unordered_map<BodyId, std::vector<BodyId>> _sleepingIslands;
+
+		WorkStealingPool _pool;
+		ParallelNarrowphase _narrowphase;
+	};
+} // namespace Engine
\ No newline at end of file
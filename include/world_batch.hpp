@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <world.hpp>
+#include <parallel_narrowphase.hpp>
+
+namespace Engine
+{
+	/**
+	* @brief Independent worlds stepped together on one thread pool, e.g. the scenes of a parameter sweep.
+	* A world is stepped by one worker at a time and runs its own narrowphase on that worker, so its bodies,
+	* pairs and scratch buffers stay in that worker's cache and no world waits for another one.
+	* Worlds are dealt to the workers in contiguous blocks of creation order, so worlds built from the same scene
+	* run the same collision work back to back, and idle workers steal the rest
+	*/
+	class WorldBatch
+	{
+	public:
+		/**
+		* @param workerCount: threads stepping the worlds, 1 steps them on the calling thread, 0 uses every hardware thread
+		*/
+		explicit WorldBatch(size_t workerCount = 0)
+			: _pool(workerCount) {}
+
+		/**
+		* @brief Adds an empty world, bodies are created on it directly
+		* @param timeStep: duration of one step of the world in seconds
+		* @returns the world, it stays at its address until clear
+		*/
+		World& CreateWorld(float timeStep = 1.f / 120.f)
+		{
+			_worlds.push_back(std::make_unique<World>(timeStep, 1));
+			return *_worlds.back();
+		}
+
+		World& operator[](size_t index)
+		{
+			return *_worlds[index];
+		}
+
+		const World& operator[](size_t index) const
+		{
+			return *_worlds[index];
+		}
+
+		size_t size() const noexcept
+		{
+			return _worlds.size();
+		}
+
+		void clear() noexcept
+		{
+			_worlds.clear();
+		}
+
+		size_t GetWorkerCount() const noexcept
+		{
+			return _pool.GetWorkerCount();
+		}
+
+		/**
+		* @brief Steps every world steps times with its own time step and waits for all of them
+		*/
+		void Step(size_t steps = 1)
+		{
+			Step(steps, [](World&, size_t, size_t) {});
+		}
+
+		/**
+		* @brief Steps every world steps times with its own time step and waits for all of them
+		* @param beforeStep: callable with (World& world, size_t worldIndex, size_t step) run on the worker before
+		* each step of the world, e.g. to apply the actions of an agent. Calls for different worlds run concurrently
+		*/
+		template <typename Callback>
+		void Step(size_t steps, Callback&& beforeStep)
+		{
+			_pool.ParallelFor(_worlds.size(), GRAIN, [&](size_t begin, size_t end, size_t)
+			{
+				for (size_t index = begin; index < end; index++)
+				{
+					World& world = *_worlds[index];
+
+					for (size_t step = 0; step < steps; step++)
+					{
+						beforeStep(world, index, step);
+						world.Step(world.GetTimeStep());
+					}
+				}
+			});
+		}
+
+	private:
+		// worlds in one chunk, small worlds take a few microseconds a step and are stolen in groups
+		static constexpr size_t GRAIN = 4;
+
+		WorkStealingPool _pool;
+		std::vector<std::unique_ptr<World>> _worlds;
+	};
+} // namespace Engine
\ No newline at end of file
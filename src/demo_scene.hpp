@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include <world.hpp>
+#include <tile_layer.hpp>
+#include <replay.hpp>
+
+/**
+* @brief Input codes of the demo, recorded as Engine::InputEvent
+*/
+enum class DemoInput : uint16_t
+{
+	// value: translation of obj
+	MoveObj,
+	// value: translation of the movable map part
+	MoveMap,
+	// value.x: degrees obj turns by
+	RotateObj,
+	// value.x: degrees the movable map part turns by
+	RotateMap,
+	// obj loses its velocity
+	StopObj
+};
+
+/**
+* @brief Shapes and world of the demo. The window and the headless replay build the same scene
+* and feed it the same input, so a recorded session runs the same steps in both
+*/
+class DemoScene
+{
+public:
+	/**
+	* @param workerCount: narrowphase threads, results don't depend on it
+	*/
+	explicit DemoScene(size_t workerCount = 0)
+		: _world(1.f / 120.f, workerCount), _obj({ 200, 100 }), _movableMapRect({ 200, 100 }), _staticMapRect({ 200, 300 }),
+		_floorLayer(_world, 40, 3, { 32.f, 32.f }, { 0.f, 624.f })
+	{
+		_obj.setPosition({ 200, 250 });
+		_obj.setRotation(-10);
+
+		_movableMapRect.setPosition({ 410, 230 });
+		_movableMapRect.setRotation(-12);
+		_staticMapRect.setPosition({ 600, 300 });
+
+		// the simulation runs with a fixed time step
+		_world.SetGravity({ 0.f, 300.f });
+
+		_objBody = _world.CreateDynamicBody(&_obj);
+		// obj must not fall through the thin map parts however long a frame is
+		_world.SetFastBody(_objBody, true);
+		_movableMapRectBody = _world.CreateStaticBody(&_movableMapRect);
+		_staticMapRectBody = _world.CreateStaticGeometry(&_staticMapRect);
+
+		// the floor is a tile layer, its solid tiles are merged into a few rectangles
+		for (uint32_t x = 0; x < _floorLayer.GetWidth(); x++)
+		{
+			_floorLayer.SetSolid(x, 2, true);
+			_floorLayer.SetSolid(x, 1, x < 6 || x > 33);
+			_floorLayer.SetSolid(x, 0, x < 2 || x > 37);
+		}
+
+		_floorLayer.Rebuild();
+
+		// the parts that never move are baked before the first frame
+		_world.BakeStaticGeometry();
+	}
+
+	DemoScene(const DemoScene&) = delete;
+	DemoScene& operator=(const DemoScene&) = delete;
+
+	/**
+	* @brief Applies the input of a frame to the shapes and advances the world by the frame time
+	* @returns how far the current state is between the last step and the next one
+	*/
+	float Update(std::span<const Engine::InputEvent> events, float frameTime)
+	{
+		for (const Engine::InputEvent& event : events)
+		{
+			switch (static_cast<DemoInput>(event.Code))
+			{
+			case DemoInput::MoveObj:
+				_obj.move(event.Value);
+				break;
+			case DemoInput::MoveMap:
+				_movableMapRect.move(event.Value);
+				break;
+			case DemoInput::RotateObj:
+				_obj.rotate(event.Value.x);
+				break;
+			case DemoInput::RotateMap:
+				_movableMapRect.rotate(event.Value.x);
+				break;
+			case DemoInput::StopObj:
+				_world.SetVelocity(_objBody, {});
+				break;
+			}
+		}
+
+		// the world reads shapes only on sync: obj is moved by the input too, the movable part is static for the world
+		_world.SyncBody(_objBody);
+		_world.SyncBody(_movableMapRectBody);
+		return _world.Advance(frameTime);
+	}
+
+	Engine::World& GetWorld() noexcept
+	{
+		return _world;
+	}
+
+	sf::RectangleShape& GetObj() noexcept
+	{
+		return _obj;
+	}
+
+	Engine::World::BodyId GetObjBody() const noexcept
+	{
+		return _objBody;
+	}
+
+	sf::RectangleShape& GetMovableMapRect() noexcept
+	{
+		return _movableMapRect;
+	}
+
+	Engine::World::BodyId GetMovableMapRectBody() const noexcept
+	{
+		return _movableMapRectBody;
+	}
+
+	sf::RectangleShape& GetStaticMapRect() noexcept
+	{
+		return _staticMapRect;
+	}
+
+	Engine::World::BodyId GetStaticMapRectBody() const noexcept
+	{
+		return _staticMapRectBody;
+	}
+
+	const Engine::TileLayer& GetFloorLayer() const noexcept
+	{
+		return _floorLayer;
+	}
+
+private:
+	Engine::World _world;
+	sf::RectangleShape _obj;
+	sf::RectangleShape _movableMapRect;
+	sf::RectangleShape _staticMapRect;
+	Engine::TileLayer _floorLayer;
+	Engine::World::BodyId _objBody;
+	Engine::World::BodyId _movableMapRectBody;
+	Engine::World::BodyId _staticMapRectBody;
+};
\ No newline at end of file
@@ -1,38 +1,91 @@
-﻿#include <vector>
+﻿#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <vector>
 
 #include <SFML/Graphics.hpp>
 
-#include <math.hpp>
+#include <world.hpp>
+#include <replay.hpp>
 
-int main()
+#include "demo_scene.hpp"
+
+#ifdef ENGINE_PROFILING
+#include <sstream>
+#include <profiler.hpp>
+#endif
+
+namespace
 {
-	sf::RenderWindow window{ sf::VideoMode{ 1280, 720 }, "window" };
+	Engine::InputEvent makeInput(DemoInput input, const sf::Vector2f& value)
+	{
+		return Engine::InputEvent{ static_cast<uint16_t>(input), value };
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	// --record session.rpl writes the frame times and the input, replay_bench runs the session again without a window.
+	// --font file.ttf is the font of the profiling overlay, there is no overlay without it
+	const char* recordingPath = nullptr;
+	[[maybe_unused]] const char* fontPath = nullptr;
 
-	sf::RectangleShape obj({ 200, 100 });
-	
-	sf::RectangleShape movableMapRect({ 200, 100 });
-	sf::RectangleShape staticMapRect({ 200, 300 });
+	for (int i = 1; i < argc; i++)
+	{
+		bool isRecord = std::strcmp(argv[i], "--record") == 0;
+		bool isFont = std::strcmp(argv[i], "--font") == 0;
+
+		if ((!isRecord && !isFont) || i + 1 >= argc)
+		{
+			std::cerr << "usage: " << argv[0] << " [--record session.rpl] [--font file.ttf]\n";
+			return 1;
+		}
+
+		(isRecord ? recordingPath : fontPath) = argv[++i];
+	}
+
+	sf::RenderWindow window{ sf::VideoMode{ 1280, 720 }, "window" };
 
 	sf::CircleShape pointOfCollision{ 5.f };
 	pointOfCollision.setFillColor(sf::Color::Blue);
 
-	std::vector<sf::Shape*> map{ &movableMapRect, &staticMapRect };
+	// the narrowphase uses all cores
+	DemoScene scene{ 0 };
+	Engine::World& world = scene.GetWorld();
+	sf::RectangleShape& obj = scene.GetObj();
+	sf::RectangleShape& movableMapRect = scene.GetMovableMapRect();
+	sf::RectangleShape& staticMapRect = scene.GetStaticMapRect();
+
+	std::ofstream recordingFile;
+	std::optional<Engine::ReplayWriter> recorder;
+
+	if (recordingPath != nullptr)
+	{
+		recordingFile.open(recordingPath, std::ios::binary);
+		recorder.emplace(recordingFile);
+	}
+
+	std::vector<Engine::InputEvent> input;
+	std::vector<Engine::World::BodyId> candidates;
 
-	obj.setPosition({ 200, 250 });
-	obj.setRotation(-10);
-	
-	movableMapRect.setPosition({ 410, 230 });
-	movableMapRect.setRotation(-12);		
-	staticMapRect.setPosition({ 600, 300 });
+	sf::Clock clock;
 
-	const float g = 0.00005f;
-	float currentObjFallVelocity = 0.f;
+#ifdef ENGINE_PROFILING
+	// stats of every 120 frames go to stdout as JSON lines, F1 shows them over the scene
+	Engine::ProfileReporter profileReporter{ std::cout, 120 };
+	sf::Font overlayFont;
+	bool hasOverlayFont = fontPath != nullptr && overlayFont.loadFromFile(fontPath);
+	bool isOverlayVisible = false;
+	sf::Text overlay{ "", overlayFont, 14 };
+	overlay.setFillColor(sf::Color::Yellow);
+	overlay.setPosition({ 10.f, 10.f });
+#endif
 
 	while (window.isOpen())
 	{
-		currentObjFallVelocity += g;
-
 		sf::Event event;
+		input.clear();
 
 		while (window.pollEvent(event))
 		{
@@ -46,30 +99,35 @@ int main()
 				switch (key)
 				{
 				case sf::Keyboard::W:
-					obj.move(sf::Vector2f{ 0.f, -VELOCITY });
+					input.push_back(makeInput(DemoInput::MoveObj, { 0.f, -VELOCITY }));
 					break;
 				case sf::Keyboard::A:
-					obj.move(sf::Vector2f{ -VELOCITY, 0.f });
+					input.push_back(makeInput(DemoInput::MoveObj, { -VELOCITY, 0.f }));
 					break;
 				case sf::Keyboard::S:
-					obj.move(sf::Vector2f{ 0.f, VELOCITY });
+					input.push_back(makeInput(DemoInput::MoveObj, { 0.f, VELOCITY }));
 					break;
 				case sf::Keyboard::D:
-					obj.move(sf::Vector2f{ VELOCITY, 0.f });
+					input.push_back(makeInput(DemoInput::MoveObj, { VELOCITY, 0.f }));
 					break;
 				case sf::Keyboard::Up:
-					movableMapRect.move(sf::Vector2f{ 0.f, -VELOCITY });
-					currentObjFallVelocity = 0.f;
+					input.push_back(makeInput(DemoInput::MoveMap, { 0.f, -VELOCITY }));
+					input.push_back(makeInput(DemoInput::StopObj, {}));
 					break;
 				case sf::Keyboard::Left:
-					movableMapRect.move(sf::Vector2f{ -VELOCITY, 0.f });
+					input.push_back(makeInput(DemoInput::MoveMap, { -VELOCITY, 0.f }));
 					break;
 				case sf::Keyboard::Down:
-					movableMapRect.move(sf::Vector2f{ 0.f, VELOCITY });
+					input.push_back(makeInput(DemoInput::MoveMap, { 0.f, VELOCITY }));
 					break;
 				case sf::Keyboard::Right:
-					movableMapRect.move(sf::Vector2f{ VELOCITY, 0.f });
+					input.push_back(makeInput(DemoInput::MoveMap, { VELOCITY, 0.f }));
+					break;
+#ifdef ENGINE_PROFILING
+				case sf::Keyboard::F1:
+					isOverlayVisible = hasOverlayFont && !isOverlayVisible;
 					break;
+#endif
 				default:
 					break;
 				}
@@ -81,11 +139,11 @@ int main()
 
 				if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl))
 				{
-					movableMapRect.rotate(scrollDirection);
+					input.push_back(makeInput(DemoInput::RotateMap, { scrollDirection, 0.f }));
 				}
 				else
 				{
-					obj.rotate(scrollDirection);
+					input.push_back(makeInput(DemoInput::RotateObj, { scrollDirection, 0.f }));
 				}
 			}
 
@@ -95,47 +153,87 @@ int main()
 			}
 		}
 
+		float frameTime = clock.restart().asSeconds();
+		float alpha = scene.Update(input, frameTime);
+
+		if (recorder)
+		{
+			recorder->WriteFrame(frameTime, input, world);
+		}
+
+		if (!world.GetContacts().empty())
+		{
+			obj.setFillColor(sf::Color::Red);
+		}
+
+		// map parts whose bounds overlap obj's are its broadphase candidates
+		world.QueryAabb(Engine::Aabb::FromRect(obj.getGlobalBounds()), candidates);
+
+		for (Engine::World::BodyId candidate : candidates)
+		{
+			if (candidate == scene.GetMovableMapRectBody())
+			{
+				movableMapRect.setFillColor(sf::Color::Green);
+			}
+			else if (candidate == scene.GetStaticMapRectBody())
+			{
+				staticMapRect.setFillColor(sf::Color::Green);
+			}
+		}
+
 		window.clear(sf::Color::Black);
 
-		auto objVertices = Engine::getVertices(&obj);
+		// obj is drawn between its last two simulated positions
+		sf::Vector2f objPosition = obj.getPosition();
+		obj.setPosition(world.GetInterpolatedPosition(scene.GetObjBody(), alpha));
+		window.draw(obj);
+		obj.setPosition(objPosition);
 
-		sf::FloatRect bounds = obj.getGlobalBounds();
-		std::vector<sf::Shape*> partsCollideCheck;
-		
-		for (auto& part : map)
+		window.draw(movableMapRect);
+		window.draw(staticMapRect);
+		scene.GetFloorLayer().ForEachRectangle([&window](const sf::RectangleShape& rectangle) { window.draw(rectangle); });
+
+		// points of the contact manifolds found by the last step
+		for (const Engine::ContactManifold& manifold : world.GetManifolds())
 		{
-			if (bounds.intersects(part->getGlobalBounds()))
+			for (uint8_t i = 0; i < manifold.PointCount; i++)
 			{
-				partsCollideCheck.push_back(part);
-				part->setFillColor(sf::Color::Green);
+				pointOfCollision.setPosition(manifold.Points[i].Position - sf::Vector2f{ 5.f, 5.f });
+				window.draw(pointOfCollision);
 			}
 		}
 
-		for (const auto& part : partsCollideCheck)
+#ifdef ENGINE_PROFILING
+		if (profileReporter.EndFrame())
 		{
-			std::optional<Engine::CollisionResponse> response = Engine::processCollision(objVertices, Engine::getVertices(part));
+			const Engine::ProfileStats& stats = profileReporter.GetLastStats();
+			std::ostringstream text;
+
+			for (size_t i = 0; i < Engine::PROFILE_PHASES; i++)
+			{
+				auto phase = static_cast<Engine::ProfilePhase>(i);
+				text << Engine::toString(phase) << ": " << stats.MicrosecondsPerFrame(phase) << " us\n";
+			}
 
-			if (response != std::nullopt)
+			for (size_t i = 0; i < Engine::PROFILE_COUNTERS; i++)
 			{
-				sf::Vector2f MTV = response->MinimumTransitionVector;
-				obj.setFillColor(sf::Color::Red);
-				obj.move(MTV);
-				currentObjFallVelocity /= 1.2f;
-				pointOfCollision.setPosition({ response->PointOfCollision.x - 5.f, response->PointOfCollision.y - 5.f });
+				auto counter = static_cast<Engine::ProfileCounter>(i);
+				text << Engine::toString(counter) << ": " << static_cast<double>(stats.Get(counter)) / stats.Frames << '\n';
 			}
+
+			overlay.setString(text.str());
 		}
 
-		window.draw(obj);
-		window.draw(movableMapRect);
-		window.draw(staticMapRect);
-		window.draw(pointOfCollision);
+		if (isOverlayVisible)
+		{
+			window.draw(overlay);
+		}
+#endif
 
 		// paint the rectangles white
 		obj.setFillColor(sf::Color::White);
 		movableMapRect.setFillColor(sf::Color::White);
 		staticMapRect.setFillColor(sf::Color::White);
-		
-		obj.move({ 0.f, currentObjFallVelocity });
 
 		window.display();
 	}
@@ -1,9 +1,79 @@
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_approx.hpp>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <SFML/Graphics/Shape.hpp>
 #include <SFML/Graphics/ConvexShape.hpp>
 #include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/CircleShape.hpp>
 #include <math.hpp>
+#include <dynamic_aabb_tree.hpp>
+#include <static_bvh.hpp>
+#include <sat_simd.hpp>
+#include <collision_hull.hpp>
+#include <separating_axis_cache.hpp>
+#include <gjk.hpp>
+#include <colliders.hpp>
+#include <convex_decomposition.hpp>
+#include <collision_lod.hpp>
+#include <parallel_narrowphase.hpp>
+#include <contact_manifold.hpp>
+#include <time_of_impact.hpp>
+#include <spatial_query.hpp>
+#include <tile_layer.hpp>
+#include <world.hpp>
+#include <world_batch.hpp>
+#include <replay.hpp>
+#include <scene_file.hpp>
+#include <profiler.hpp>
+
+namespace
+{
+	// counts every global heap allocation of the test binary
+	std::atomic<size_t> allocationsCount{ 0 };
+}
+
+// GCC pairs new expressions with the free calls below once the replaced operators are inlined
+// and reports a mismatch, but these operators do allocate with malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+	allocationsCount++;
+
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
 
 TEST_CASE("normal", "[math]")
 {
@@ -213,4 +283,2422 @@ TEST_CASE("shape centroid", "[math]")
 	centroid = Engine::centroid(Engine::getVertices(&square));
 	INFO("Square centroid: (" << centroid.x << "; " << centroid.y << ")");
 	REQUIRE(movedExpected == centroid);
+}
+
+TEST_CASE("AABB tree query", "[broadphase]")
+{
+	std::mt19937 random{ 7 };
+	std::uniform_real_distribution<float> position(0.f, 1000.f);
+	std::uniform_real_distribution<float> size(1.f, 40.f);
+
+	auto randomBox = [&]()
+	{
+		sf::Vector2f lower{ position(random), position(random) };
+		return Engine::Aabb{ lower, lower + sf::Vector2f{ size(random), size(random) } };
+	};
+
+	const float MARGIN = 2.f;
+	Engine::DynamicAabbTree<size_t> tree{ MARGIN };
+	std::vector<Engine::Aabb> boxes;
+	std::vector<int32_t> proxies;
+
+	for (size_t i = 0; i < 500; i++)
+	{
+		boxes.push_back(randomBox());
+		proxies.push_back(tree.CreateProxy(boxes.back(), i));
+	}
+
+	// balanced tree must stay logarithmic
+	REQUIRE(tree.GetProxyCount() == 500);
+	REQUIRE(tree.GetHeight() <= 20);
+
+	// every box overlapping the query must be found, fattening may only add extra candidates
+	for (int query = 0; query < 50; query++)
+	{
+		Engine::Aabb queryBox = randomBox();
+		std::vector<size_t> found;
+
+		tree.Query(queryBox, [&](int32_t proxyId)
+		{
+			found.push_back(tree.GetUserData(proxyId));
+			return true;
+		});
+
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			bool isFound = std::ranges::find(found, i) != found.end();
+
+			if (boxes[i].Overlaps(queryBox))
+			{
+				REQUIRE(isFound);
+			}
+
+			if (isFound)
+			{
+				REQUIRE(boxes[i].Fattened(MARGIN).Overlaps(queryBox));
+			}
+		}
+	}
+}
+
+TEST_CASE("AABB tree move and remove", "[broadphase]")
+{
+	Engine::DynamicAabbTree<int> tree{ 2.f };
+	int32_t a = tree.CreateProxy(Engine::Aabb{ { 0.f, 0.f }, { 10.f, 10.f } }, 1);
+	int32_t b = tree.CreateProxy(Engine::Aabb{ { 100.f, 0.f }, { 110.f, 10.f } }, 2);
+
+	// small move stays inside the fattened box
+	REQUIRE_FALSE(tree.MoveProxy(a, Engine::Aabb{ { 1.f, 0.f }, { 11.f, 10.f } }, { 1.f, 0.f }));
+
+	// big move reinserts the proxy
+	REQUIRE(tree.MoveProxy(a, Engine::Aabb{ { 95.f, 0.f }, { 105.f, 10.f } }, { 94.f, 0.f }));
+
+	std::vector<Engine::DynamicAabbTree<int>::ProxyPair> pairs;
+	tree.QueryOverlappingPairs(pairs);
+	REQUIRE(pairs.size() == 1);
+	REQUIRE(pairs[0] == std::make_pair(std::min(a, b), std::max(a, b)));
+
+	tree.DestroyProxy(b);
+	tree.QueryOverlappingPairs(pairs);
+	REQUIRE(pairs.empty());
+	REQUIRE(tree.GetProxyCount() == 1);
+
+	// freed node is reused
+	int32_t c = tree.CreateProxy(Engine::Aabb{ { 0.f, 0.f }, { 10.f, 10.f } }, 3);
+	REQUIRE(tree.GetUserData(c) == 3);
+	REQUIRE(tree.GetUserData(a) == 1);
+}
+
+TEST_CASE("AABB tree overlapping pairs", "[broadphase]")
+{
+	std::mt19937 random{ 11 };
+	std::uniform_real_distribution<float> position(0.f, 300.f);
+	std::uniform_real_distribution<float> size(1.f, 30.f);
+
+	Engine::DynamicAabbTree<size_t> tree{ 0.f };
+	std::vector<int32_t> proxies;
+
+	for (size_t i = 0; i < 200; i++)
+	{
+		sf::Vector2f lower{ position(random), position(random) };
+		proxies.push_back(tree.CreateProxy(Engine::Aabb{ lower, lower + sf::Vector2f{ size(random), size(random) } }, i));
+	}
+
+	// destroy some proxies so that free nodes are mixed with live ones
+	for (size_t i = 0; i < proxies.size(); i += 3)
+	{
+		tree.DestroyProxy(proxies[i]);
+	}
+
+	std::vector<Engine::DynamicAabbTree<size_t>::ProxyPair> expected;
+
+	for (size_t i = 0; i < proxies.size(); i++)
+	{
+		for (size_t j = i + 1; j < proxies.size(); j++)
+		{
+			if (i % 3 == 0 || j % 3 == 0)
+			{
+				continue;
+			}
+
+			if (tree.GetFatAabb(proxies[i]).Overlaps(tree.GetFatAabb(proxies[j])))
+			{
+				expected.emplace_back(std::min(proxies[i], proxies[j]), std::max(proxies[i], proxies[j]));
+			}
+		}
+	}
+
+	std::ranges::sort(expected);
+
+	std::vector<Engine::DynamicAabbTree<size_t>::ProxyPair> pairs;
+	tree.QueryOverlappingPairs(pairs);
+	REQUIRE(pairs == expected);
+}
+
+TEST_CASE("SAT with scratch doesn't allocate", "[math]")
+{
+	sf::ConvexShape pentagon{ 5 };
+	pentagon.setPoint(0, { 50.f, 2.f });
+	pentagon.setPoint(1, { 89.f, 10.5f });
+	pentagon.setPoint(2, { 92.f, 177.1f });
+	pentagon.setPoint(3, { 50.f, 90.f });
+	pentagon.setPoint(4, { 30.f, 40.f });
+
+	sf::RectangleShape rect{ { 60.f, 40.f } };
+	rect.setPosition({ 60.f, 60.f });
+	rect.setRotation(20.f);
+
+	sf::RectangleShape farRect{ { 60.f, 40.f } };
+	farRect.setPosition({ 500.f, 500.f });
+
+	auto pentagonVertices = Engine::getVertices(&pentagon);
+	auto rectVertices = Engine::getVertices(&rect);
+	auto farRectVertices = Engine::getVertices(&farRect);
+
+	Engine::CollisionScratch scratch;
+	auto expectedCollision = Engine::processCollision(pentagonVertices, rectVertices);
+	auto warmUp = Engine::processCollision(pentagonVertices, rectVertices, scratch);
+
+	size_t collisions = 0;
+	size_t allocationsBefore = allocationsCount.load();
+
+	for (int i = 0; i < 100; i++)
+	{
+		collisions += Engine::processCollision(pentagonVertices, rectVertices, scratch).has_value();
+		collisions += Engine::processCollision(rectVertices, farRectVertices, scratch).has_value();
+	}
+
+	size_t allocations = allocationsCount.load() - allocationsBefore;
+
+	REQUIRE(allocations == 0);
+	REQUIRE(collisions == 100);
+
+	// reused buffers give the same result as fresh ones
+	auto reused = Engine::processCollision(pentagonVertices, rectVertices, scratch);
+	REQUIRE(expectedCollision.has_value());
+	REQUIRE(reused.has_value());
+	REQUIRE(warmUp->MinimumTransitionVector == expectedCollision->MinimumTransitionVector);
+	REQUIRE(reused->MinimumTransitionVector == expectedCollision->MinimumTransitionVector);
+	REQUIRE(reused->PointOfCollision == expectedCollision->PointOfCollision);
+}
+
+TEST_CASE("SIMD projection kernels", "[simd]")
+{
+	std::mt19937 random{ 3 };
+	std::uniform_real_distribution<float> coordinate(-100.f, 100.f);
+
+	for (size_t count = 1; count <= 70; count++)
+	{
+		std::vector<float> x(count);
+		std::vector<float> y(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			// rounded coordinates produce ties, the earliest vertex must win like in scalar code
+			x[i] = std::round(coordinate(random) / 20.f);
+			y[i] = std::round(coordinate(random) / 20.f);
+		}
+
+		sf::Vector2f axis = Engine::normal({ coordinate(random), coordinate(random) });
+		Engine::simd::ProjectionRange expected = Engine::simd::projectScalar(x.data(), y.data(), count, axis.x, axis.y);
+
+		std::vector<Engine::simd::ProjectionRange> actual{ Engine::simd::project(x.data(), y.data(), count, axis.x, axis.y) };
+#if ENGINE_SIMD_SSE2
+		actual.push_back(Engine::simd::projectSse2(x.data(), y.data(), count, axis.x, axis.y));
+#endif
+#if ENGINE_SIMD_AVX2
+		actual.push_back(Engine::simd::projectAvx2(x.data(), y.data(), count, axis.x, axis.y));
+#endif
+
+		for (const auto& range : actual)
+		{
+			INFO("vertices: " << count);
+			REQUIRE(range.Min == expected.Min);
+			REQUIRE(range.Max == expected.Max);
+			REQUIRE(range.MinIndex == expected.MinIndex);
+			REQUIRE(range.MaxIndex == expected.MaxIndex);
+		}
+	}
+}
+
+TEST_CASE("SoA SAT gives the same response", "[simd]")
+{
+	std::mt19937 random{ 5 };
+	std::uniform_real_distribution<float> position(0.f, 120.f);
+	std::uniform_real_distribution<float> angle(0.f, 360.f);
+	std::uniform_int_distribution<size_t> pointCount(3, 40);
+
+	Engine::CollisionScratch scratch;
+	Engine::SoaPolygon soaA;
+	Engine::SoaPolygon soaB;
+	size_t collisions = 0;
+
+	for (int test = 0; test < 500; test++)
+	{
+		sf::CircleShape a{ 40.f, pointCount(random) };
+		a.setPosition({ position(random), position(random) });
+		a.setRotation(angle(random));
+
+		sf::CircleShape b{ 30.f, pointCount(random) };
+		b.setPosition({ position(random), position(random) });
+		b.setRotation(angle(random));
+
+		auto verticesA = Engine::getVertices(&a);
+		auto verticesB = Engine::getVertices(&b);
+		soaA.Assign(verticesA);
+		soaB.Assign(verticesB);
+
+		auto expected = Engine::processCollision(verticesA, verticesB, scratch);
+		auto actual = Engine::processCollision(soaA, soaB, scratch);
+
+		REQUIRE(expected.has_value() == actual.has_value());
+
+		if (expected)
+		{
+			collisions++;
+			REQUIRE(actual->PointOfCollision == expected->PointOfCollision);
+			REQUIRE(actual->MinimumTransitionVector == expected->MinimumTransitionVector);
+		}
+	}
+
+	// make sure both branches were exercised
+	REQUIRE(collisions > 0);
+	REQUIRE(collisions < 500);
+}
+
+TEST_CASE("collision hull follows the shape", "[hull]")
+{
+	sf::RectangleShape rect{ { 40.f, 20.f } };
+	rect.setPosition({ 100.f, 50.f });
+	rect.setRotation(30.f);
+
+	Engine::CollisionHull hull{ &rect };
+	REQUIRE(hull.GetVertices() == Engine::getVertices(&rect));
+
+	// parallel edges of a rectangle give only 2 axes
+	REQUIRE(hull.GetAxes().size() == 2);
+	REQUIRE(std::abs(hull.GetArea()) == Catch::Approx(800.f));
+
+	// static shape is not recomputed
+	REQUIRE_FALSE(hull.Update(&rect));
+
+	rect.move({ 5.f, -3.f });
+	REQUIRE(hull.Update(&rect));
+	REQUIRE(hull.GetVertices() == Engine::getVertices(&rect));
+
+	rect.rotate(45.f);
+	REQUIRE(hull.Update(&rect));
+	REQUIRE(hull.GetVertices() == Engine::getVertices(&rect));
+
+	auto vertices = Engine::getVertices(&rect);
+	sf::Vector2f expectedCentroid = Engine::centroid(vertices);
+	REQUIRE(hull.GetCentroid().x == Catch::Approx(expectedCentroid.x));
+	REQUIRE(hull.GetCentroid().y == Catch::Approx(expectedCentroid.y));
+
+	// every cached axis is perpendicular to one of the edges
+	for (const auto& axis : hull.GetAxes())
+	{
+		bool isEdgeNormal = false;
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			sf::Vector2f edgeNormal = Engine::normal(vertices[(i + 1) % vertices.size()] - vertices[i]);
+			isEdgeNormal = isEdgeNormal || std::abs(Engine::dot(axis, edgeNormal) - 1.f) < 1e-5f;
+		}
+
+		REQUIRE(isEdgeNormal);
+	}
+
+	rect.setScale({ 2.f, 1.f });
+	rect.setOrigin({ 20.f, 10.f });
+	REQUIRE(hull.Update(&rect));
+	REQUIRE(hull.GetVertices() == Engine::getVertices(&rect));
+	REQUIRE(std::abs(hull.GetArea()) == Catch::Approx(1600.f));
+}
+
+TEST_CASE("SAT over collision hulls", "[hull]")
+{
+	std::mt19937 random{ 9 };
+	std::uniform_real_distribution<float> position(0.f, 120.f);
+	std::uniform_real_distribution<float> angle(0.f, 360.f);
+	std::uniform_int_distribution<size_t> pointCount(3, 12);
+
+	Engine::CollisionScratch scratch;
+	size_t collisions = 0;
+
+	for (int test = 0; test < 500; test++)
+	{
+		sf::RectangleShape a{ { 60.f, 30.f } };
+		a.setPosition({ position(random), position(random) });
+		a.setRotation(angle(random));
+
+		sf::CircleShape b{ 30.f, pointCount(random) };
+		b.setPosition({ position(random), position(random) });
+		b.setRotation(angle(random));
+
+		Engine::CollisionHull hullA{ &a };
+		Engine::CollisionHull hullB{ &b };
+
+		auto expected = Engine::processCollision(Engine::getVertices(&a), Engine::getVertices(&b), scratch);
+		auto actual = Engine::processCollision(hullA, hullB);
+
+		REQUIRE(expected.has_value() == actual.has_value());
+
+		if (expected)
+		{
+			collisions++;
+			// rotated cached normals differ from the recomputed ones in the last bits,
+			// so an axis with almost the same overlap may win
+			sf::Vector2f actualMTV = actual->MinimumTransitionVector;
+			sf::Vector2f expectedMTV = expected->MinimumTransitionVector;
+			float actualLength = std::sqrt(Engine::dot(actualMTV, actualMTV));
+			float expectedLength = std::sqrt(Engine::dot(expectedMTV, expectedMTV));
+			INFO("actual: " << actualMTV.x << ' ' << actualMTV.y << ", expected: " << expectedMTV.x << ' ' << expectedMTV.y);
+			REQUIRE(Catch::Approx(actualLength).margin(1e-2f) == expectedLength);
+
+			if (expectedLength > 1e-2f)
+			{
+				REQUIRE(Engine::dot(actualMTV, expectedMTV) / (actualLength * expectedLength) > 0.99f);
+			}
+		}
+	}
+
+	REQUIRE(collisions > 0);
+	REQUIRE(collisions < 500);
+}
+
+TEST_CASE("separating axis cache", "[hull]")
+{
+	sf::RectangleShape a{ { 40.f, 40.f } };
+	a.setRotation(10.f);
+
+	sf::CircleShape b{ 20.f, 8 };
+	b.setPosition({ 100.f, 0.f });
+
+	Engine::CollisionHull hullA{ &a };
+	Engine::CollisionHull hullB{ &b };
+	Engine::SeparatingAxisCache cache;
+
+	// the first query runs full SAT and remembers the separating axis
+	REQUIRE(cache.ProcessCollision(1, hullA, 2, hullB) == std::nullopt);
+	REQUIRE(cache.GetStatistics().ColdQueries == 1);
+
+	// slowly moving pair is separated by the cached axis, the key doesn't depend on the order
+	for (int frame = 0; frame < 10; frame++)
+	{
+		b.move({ -1.f, 0.5f });
+		hullB.Update(&b);
+		REQUIRE(cache.ProcessCollision(2, hullB, 1, hullA) == std::nullopt);
+	}
+
+	REQUIRE(cache.GetStatistics().Hits == 10);
+	REQUIRE(cache.Size() == 1);
+
+	// colliding pair gives the same response as SAT without cache
+	b.setPosition({ 30.f, 10.f });
+	hullB.Update(&b);
+	auto expected = Engine::processCollision(hullA, hullB);
+	auto actual = cache.ProcessCollision(1, hullA, 2, hullB);
+	REQUIRE(expected.has_value());
+	REQUIRE(actual.has_value());
+	REQUIRE(actual->MinimumTransitionVector == expected->MinimumTransitionVector);
+	REQUIRE(actual->PointOfCollision == expected->PointOfCollision);
+	REQUIRE(cache.GetStatistics().Misses == 1);
+
+	// colliding pair has no separating axis, after the response full SAT finds one again
+	b.move(-expected->MinimumTransitionVector * 1.1f);
+	hullB.Update(&b);
+	REQUIRE(cache.ProcessCollision(1, hullA, 2, hullB) == std::nullopt);
+	REQUIRE(cache.GetStatistics().Misses == 2);
+	REQUIRE(cache.ProcessCollision(1, hullA, 2, hullB) == std::nullopt);
+	REQUIRE(cache.GetStatistics().Hits == 11);
+	REQUIRE(cache.GetStatistics().Queries == 14);
+	REQUIRE(cache.GetStatistics().HitRate() == Catch::Approx(11. / 14.));
+}
+
+TEST_CASE("separating axis cache erase", "[hull]")
+{
+	sf::RectangleShape a{ { 10.f, 10.f } };
+	sf::RectangleShape b{ { 10.f, 10.f } };
+	b.setPosition({ 50.f, 0.f });
+
+	Engine::CollisionHull hullA{ &a };
+	Engine::CollisionHull hullB{ &b };
+	Engine::SeparatingAxisCache cache;
+
+	constexpr uint32_t PAIRS = 1000;
+
+	for (uint32_t i = 0; i < PAIRS; i++)
+	{
+		cache.ProcessCollision(i, hullA, i + 1, hullB);
+	}
+
+	REQUIRE(cache.Size() == PAIRS);
+
+	for (uint32_t i = 0; i < PAIRS; i += 2)
+	{
+		cache.Erase(i + 1, i);
+	}
+
+	REQUIRE(cache.Size() == PAIRS / 2);
+	cache.ResetStatistics();
+
+	// remaining pairs are still found after the erased entries were shifted out
+	for (uint32_t i = 0; i < PAIRS; i++)
+	{
+		cache.ProcessCollision(i, hullA, i + 1, hullB);
+	}
+
+	REQUIRE(cache.GetStatistics().Hits == PAIRS / 2);
+	REQUIRE(cache.GetStatistics().ColdQueries == PAIRS / 2);
+
+	cache.Clear();
+	REQUIRE(cache.Size() == 0);
+}
+
+TEST_CASE("separating axis cache drops stale pairs", "[hull]")
+{
+	sf::RectangleShape a{ { 10.f, 10.f } };
+	sf::RectangleShape b{ { 10.f, 10.f } };
+	b.setPosition({ 50.f, 0.f });
+
+	Engine::CollisionHull hullA{ &a };
+	Engine::CollisionHull hullB{ &b };
+	Engine::SeparatingAxisCache cache;
+
+	// a moving window of pairs, every pair is queried for 3 frames and then leaves
+	for (uint32_t frame = 0; frame < 1000; frame++)
+	{
+		for (uint32_t i = frame * 10; i < frame * 10 + 30; i++)
+		{
+			cache.ProcessCollision(i, hullA.GetView(), i + 1, hullB.GetView());
+		}
+
+		cache.NextFrame();
+	}
+
+	REQUIRE(cache.Size() == 30);
+	REQUIRE(cache.Capacity() <= 128);
+	REQUIRE(cache.GetStatistics().Hits == 20 * 1000 - 20);
+
+	// idle frames keep pairs until they run out
+	cache.NextFrame(1);
+	REQUIRE(cache.Size() == 30);
+	cache.NextFrame(1);
+	REQUIRE(cache.Size() == 0);
+	REQUIRE(cache.Capacity() == 16);
+}
+
+
+TEST_CASE("GJK support by hill climbing", "[gjk]")
+{
+	sf::CircleShape circle{ 50.f, 30 };
+	circle.setRotation(17.f);
+	auto vertices = Engine::getVertices(&circle);
+
+	std::mt19937 random{ 3 };
+	std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+
+	for (int test = 0; test < 200; test++)
+	{
+		float directionAngle = angle(random);
+		sf::Vector2f direction{ std::cos(directionAngle), std::sin(directionAngle) };
+
+		float best = -std::numeric_limits<float>::infinity();
+
+		for (const auto& vertex : vertices)
+		{
+			best = std::max(best, Engine::dot(vertex, direction));
+		}
+
+		// every start vertex climbs to the farthest one
+		for (uint32_t start = 0; start < vertices.size(); start++)
+		{
+			uint32_t index = Engine::detail::supportIndex(vertices, direction, start);
+			REQUIRE(Engine::dot(vertices[index], direction) == best);
+		}
+	}
+}
+
+TEST_CASE("GJK/EPA gives the same response as SAT", "[gjk]")
+{
+	std::mt19937 random{ 21 };
+	std::uniform_real_distribution<float> position(0.f, 120.f);
+	std::uniform_real_distribution<float> angle(0.f, 360.f);
+	std::uniform_int_distribution<size_t> pointCount(3, 40);
+
+	Engine::CollisionScratch scratch;
+	Engine::GjkCache cache;
+	size_t collisions = 0;
+
+	for (int test = 0; test < 1000; test++)
+	{
+		sf::RectangleShape a{ { 60.f, 30.f } };
+		a.setPosition({ position(random), position(random) });
+		a.setRotation(angle(random));
+
+		sf::CircleShape b{ 30.f, pointCount(random) };
+		b.setPosition({ position(random), position(random) });
+		b.setRotation(angle(random));
+
+		auto verticesA = Engine::getVertices(&a);
+		auto verticesB = Engine::getVertices(&b);
+		Engine::CollisionHull hullA{ &a };
+		Engine::CollisionHull hullB{ &b };
+
+		auto expected = Engine::processCollision(verticesA, verticesB, scratch);
+
+		// the same cache serves unrelated pairs, the start vertices must not matter
+		for (auto actual : { Engine::gjkCollision(verticesA, verticesB, cache), Engine::gjkCollision(hullA, hullB, cache), Engine::gjkCollision(verticesA, verticesB) })
+		{
+			REQUIRE(expected.has_value() == actual.has_value());
+
+			if (!expected)
+			{
+				continue;
+			}
+
+			sf::Vector2f actualMTV = actual->MinimumTransitionVector;
+			sf::Vector2f expectedMTV = expected->MinimumTransitionVector;
+			float actualLength = std::sqrt(Engine::dot(actualMTV, actualMTV));
+			float expectedLength = std::sqrt(Engine::dot(expectedMTV, expectedMTV));
+			INFO("actual: " << actualMTV.x << ' ' << actualMTV.y << ", expected: " << expectedMTV.x << ' ' << expectedMTV.y);
+			REQUIRE(Catch::Approx(actualLength).margin(1e-2f) == expectedLength);
+
+			// and points the same way, a short MTV has no reliable direction
+			if (expectedLength > 1e-2f)
+			{
+				REQUIRE(Engine::dot(actualMTV, expectedMTV) / (actualLength * expectedLength) > 0.99f);
+			}
+
+			// the MTV pushes A out of B
+			std::vector<sf::Vector2f> movedA = verticesA;
+
+			for (auto& vertex : movedA)
+			{
+				vertex += actualMTV * 1.01f + Engine::unit(actualMTV) * 1e-2f;
+			}
+
+			REQUIRE_FALSE(Engine::processCollision(movedA, verticesB, scratch).has_value());
+
+			// the point of collision is a vertex of one of the shapes
+			bool isVertex = std::ranges::find(verticesA, actual->PointOfCollision) != verticesA.end()
+				|| std::ranges::find(verticesB, actual->PointOfCollision) != verticesB.end();
+			REQUIRE(isVertex);
+		}
+
+		if (expected)
+		{
+			collisions++;
+		}
+
+		auto adaptive = Engine::processCollisionAdaptive(verticesA, verticesB, scratch, cache);
+		REQUIRE(adaptive.has_value() == expected.has_value());
+		REQUIRE(Engine::processCollisionAdaptive(hullA, hullB, cache).has_value() == expected.has_value());
+	}
+
+	REQUIRE(collisions > 0);
+	REQUIRE(collisions < 1000);
+}
+
+TEST_CASE("collider is picked by shape type", "[collider]")
+{
+	sf::CircleShape circle{ 20.f };
+	circle.setPosition({ 100.f, 50.f });
+	sf::RectangleShape rectangle{ { 40.f, 10.f } };
+	sf::ConvexShape triangle{ 3 };
+	triangle.setPoint(0, { 0.f, 0.f });
+	triangle.setPoint(1, { 10.f, 0.f });
+	triangle.setPoint(2, { 0.f, 10.f });
+
+	Engine::Collider circleCollider = Engine::makeCollider(&circle);
+	REQUIRE(std::holds_alternative<Engine::Circle>(circleCollider));
+	REQUIRE(std::get<Engine::Circle>(circleCollider).Center == sf::Vector2f{ 120.f, 70.f });
+	REQUIRE(std::get<Engine::Circle>(circleCollider).Radius == 20.f);
+
+	REQUIRE(std::holds_alternative<Engine::OrientedBox>(Engine::makeCollider(&rectangle)));
+	REQUIRE(std::holds_alternative<Engine::ConvexPolygon>(Engine::makeCollider(&triangle)));
+
+	// a stretched circle is an ellipse
+	circle.setScale({ 2.f, 1.f });
+	REQUIRE(std::holds_alternative<Engine::ConvexPolygon>(Engine::makeCollider(&circle)));
+
+	// a few points make a polygon the circle doesn't approximate
+	sf::CircleShape coarse{ 20.f, Engine::CIRCLE_MIN_POINTS - 1 };
+	REQUIRE(std::holds_alternative<Engine::ConvexPolygon>(Engine::makeCollider(&coarse)));
+	coarse.setPointCount(Engine::CIRCLE_MIN_POINTS);
+	REQUIRE(std::holds_alternative<Engine::Circle>(Engine::makeCollider(&coarse)));
+}
+
+TEST_CASE("oriented boxes give the same response as SAT", "[collider]")
+{
+	std::mt19937 random{ 7 };
+	std::uniform_real_distribution<float> position(0.f, 120.f);
+	std::uniform_real_distribution<float> angle(0.f, 360.f);
+	std::uniform_real_distribution<float> side(5.f, 80.f);
+
+	Engine::CollisionScratch scratch;
+	size_t collisions = 0;
+
+	for (int test = 0; test < 1000; test++)
+	{
+		sf::RectangleShape a{ { side(random), side(random) } };
+		a.setPosition({ position(random), position(random) });
+		a.setRotation(angle(random));
+
+		sf::RectangleShape b{ { side(random), side(random) } };
+		b.setPosition({ position(random), position(random) });
+		b.setRotation(test % 4 == 0 ? 0.f : angle(random));
+
+		auto verticesA = Engine::getVertices(&a);
+		auto verticesB = Engine::getVertices(&b);
+		auto expected = Engine::processCollision(verticesA, verticesB, scratch);
+
+		// a box against a generic polygon goes through the same routine
+		for (auto actual : { Engine::processCollision(Engine::makeCollider(&a), Engine::makeCollider(&b), scratch),
+			Engine::processCollision(Engine::makeCollider(&a), Engine::Collider{ Engine::ConvexPolygon{ verticesB } }, scratch) })
+		{
+			REQUIRE(expected.has_value() == actual.has_value());
+
+			if (!expected)
+			{
+				continue;
+			}
+
+			INFO("actual: " << actual->MinimumTransitionVector.x << ' ' << actual->MinimumTransitionVector.y
+				<< ", expected: " << expected->MinimumTransitionVector.x << ' ' << expected->MinimumTransitionVector.y);
+			REQUIRE(Catch::Approx(actual->MinimumTransitionVector.x).margin(1e-2f) == expected->MinimumTransitionVector.x);
+			REQUIRE(Catch::Approx(actual->MinimumTransitionVector.y).margin(1e-2f) == expected->MinimumTransitionVector.y);
+
+			bool isVertex = std::ranges::find(verticesA, actual->PointOfCollision) != verticesA.end()
+				|| std::ranges::find(verticesB, actual->PointOfCollision) != verticesB.end();
+			REQUIRE(isVertex);
+		}
+
+		if (expected)
+		{
+			collisions++;
+		}
+	}
+
+	REQUIRE(collisions > 0);
+	REQUIRE(collisions < 1000);
+}
+
+TEST_CASE("circle colliders", "[collider]")
+{
+	Engine::Circle a{ { 0.f, 0.f }, 30.f };
+	Engine::Circle b{ { 40.f, 0.f }, 20.f };
+
+	auto response = Engine::processCollision(a, b);
+	REQUIRE(response.has_value());
+	REQUIRE(response->MinimumTransitionVector == sf::Vector2f{ -10.f, 0.f });
+	REQUIRE(response->PointOfCollision == sf::Vector2f{ 30.f, 0.f });
+
+	b.Center = { 50.1f, 0.f };
+	REQUIRE_FALSE(Engine::processCollision(a, b).has_value());
+
+	// a circle against a polygon matches SAT over a finely tessellated circle
+	std::mt19937 random{ 11 };
+	std::uniform_real_distribution<float> position(0.f, 120.f);
+	std::uniform_real_distribution<float> angle(0.f, 360.f);
+	Engine::CollisionScratch scratch;
+	size_t collisions = 0;
+
+	for (int test = 0; test < 500; test++)
+	{
+		sf::RectangleShape rectangle{ { 70.f, 25.f } };
+		rectangle.setPosition({ position(random), position(random) });
+		rectangle.setRotation(angle(random));
+
+		sf::CircleShape circle{ 25.f, 720 };
+		circle.setPosition({ position(random), position(random) });
+
+		Engine::Collider circleCollider = Engine::makeCollider(&circle);
+		auto actual = Engine::processCollision(circleCollider, Engine::makeCollider(&rectangle), scratch);
+		auto expected = Engine::processCollision(Engine::getVertices(&circle), Engine::getVertices(&rectangle), scratch);
+
+		// the tessellated circle is a bit smaller, skip the pairs that only touch
+		if (expected.has_value() != actual.has_value())
+		{
+			REQUIRE(actual.has_value());
+			REQUIRE(std::sqrt(Engine::dot(actual->MinimumTransitionVector, actual->MinimumTransitionVector)) < 1e-2f);
+			continue;
+		}
+
+		if (!expected)
+		{
+			continue;
+		}
+
+		// near a corner SAT can push only along one of the tessellated circle normals
+		collisions++;
+		REQUIRE(Catch::Approx(actual->MinimumTransitionVector.x).margin(0.1f) == expected->MinimumTransitionVector.x);
+		REQUIRE(Catch::Approx(actual->MinimumTransitionVector.y).margin(0.1f) == expected->MinimumTransitionVector.y);
+
+		// the reversed pair pushes the rectangle out of the circle
+		auto reversed = Engine::processCollision(Engine::makeCollider(&rectangle), circleCollider, scratch);
+		REQUIRE(reversed.has_value());
+		REQUIRE(reversed->MinimumTransitionVector == -actual->MinimumTransitionVector);
+	}
+
+	REQUIRE(collisions > 0);
+}
+
+TEST_CASE("capsule colliders", "[collider]")
+{
+	Engine::Capsule capsule{ { 0.f, 0.f }, { 100.f, 0.f }, 10.f };
+
+	// lying on top of a box
+	Engine::OrientedBox box = Engine::OrientedBox::FromVertices({ sf::Vector2f{ 40.f, 5.f }, { 60.f, 5.f }, { 60.f, 50.f }, { 40.f, 50.f } });
+	auto response = Engine::processCollision(capsule, box);
+	REQUIRE(response.has_value());
+	REQUIRE(response->MinimumTransitionVector == sf::Vector2f{ 0.f, -5.f });
+
+	// the core crosses the box, the shorter way is up
+	box = Engine::OrientedBox::FromVertices({ sf::Vector2f{ 40.f, -5.f }, { 60.f, -5.f }, { 60.f, 50.f }, { 40.f, 50.f } });
+	response = Engine::processCollision(capsule, box);
+	REQUIRE(response.has_value());
+	REQUIRE(response->MinimumTransitionVector == sf::Vector2f{ 0.f, -15.f });
+
+	// the round end against a circle
+	response = Engine::processCollision(capsule, Engine::Circle{ { 115.f, 0.f }, 10.f });
+	REQUIRE(response.has_value());
+	REQUIRE(response->MinimumTransitionVector == sf::Vector2f{ -5.f, 0.f });
+
+	REQUIRE_FALSE(Engine::processCollision(capsule, Engine::Circle{ { 50.f, 21.f }, 10.f }).has_value());
+
+	// crossing capsules
+	Engine::Capsule crossing{ { 50.f, -30.f }, { 50.f, 10.f }, 5.f };
+	response = Engine::processCollision(capsule, crossing);
+	REQUIRE(response.has_value());
+	REQUIRE(response->MinimumTransitionVector == sf::Vector2f{ 0.f, 25.f });
+
+	// parallel capsules
+	Engine::Capsule parallel{ { 20.f, 15.f }, { 80.f, 15.f }, 10.f };
+	response = Engine::processCollision(capsule, parallel);
+	REQUIRE(response.has_value());
+	REQUIRE(response->MinimumTransitionVector == sf::Vector2f{ 0.f, -5.f });
+}
+
+TEST_CASE("work-stealing pool runs every index once", "[parallel]")
+{
+	Engine::WorkStealingPool pool{ 4 };
+	REQUIRE(pool.GetWorkerCount() == 4);
+
+	std::vector<std::atomic<int>> visits(1000);
+
+	// the pool is reused between calls, uneven chunks make workers steal
+	for (size_t grain : { 1, 7, 64, 5000 })
+	{
+		for (auto& visit : visits)
+		{
+			visit = 0;
+		}
+
+		pool.ParallelFor(visits.size(), grain, [&](size_t begin, size_t end, size_t)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				visits[i]++;
+			}
+		});
+
+		REQUIRE(std::ranges::all_of(visits, [](const std::atomic<int>& visit) { return visit == 1; }));
+	}
+}
+
+TEST_CASE("parallel narrowphase is deterministic", "[parallel]")
+{
+	std::mt19937 random{ 5 };
+	std::uniform_real_distribution<float> position(0.f, 1000.f);
+	std::uniform_real_distribution<float> angle(0.f, 360.f);
+
+	std::vector<sf::RectangleShape> shapes(300, sf::RectangleShape{ { 60.f, 40.f } });
+	std::vector<Engine::CollisionHull> hulls;
+
+	for (auto& shape : shapes)
+	{
+		shape.setPosition({ position(random), position(random) });
+		shape.setRotation(angle(random));
+		hulls.emplace_back(&shape);
+	}
+
+	std::vector<Engine::CandidatePair> pairs;
+
+	for (uint32_t i = 0; i < shapes.size(); i++)
+	{
+		for (uint32_t j = i + 1; j < shapes.size(); j++)
+		{
+			if (shapes[i].getGlobalBounds().intersects(shapes[j].getGlobalBounds()))
+			{
+				pairs.push_back(Engine::CandidatePair{ i, j });
+			}
+		}
+	}
+
+	auto collide = [&](const Engine::CandidatePair& pair, size_t)
+	{
+		return Engine::processCollision(hulls[pair.IdA], hulls[pair.IdB]);
+	};
+
+	std::vector<Engine::PairResponse> expected;
+
+	for (uint32_t i = 0; i < pairs.size(); i++)
+	{
+		if (auto response = collide(pairs[i], 0))
+		{
+			expected.push_back(Engine::PairResponse{ i, pairs[i], *response });
+		}
+	}
+
+	REQUIRE(expected.size() > 0);
+
+	for (size_t workers : { 1, 3, 8 })
+	{
+		Engine::WorkStealingPool pool{ workers };
+		Engine::ParallelNarrowphase narrowphase{ pool, 4 };
+
+		for (int run = 0; run < 3; run++)
+		{
+			const std::vector<Engine::PairResponse>& actual = narrowphase.Run(pairs, collide);
+			REQUIRE(actual.size() == expected.size());
+
+			// bit for bit the same as the serial loop
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				REQUIRE(actual[i].PairIndex == expected[i].PairIndex);
+				REQUIRE(actual[i].Pair.IdA == expected[i].Pair.IdA);
+				REQUIRE(actual[i].Pair.IdB == expected[i].Pair.IdB);
+				REQUIRE(actual[i].Response.MinimumTransitionVector == expected[i].Response.MinimumTransitionVector);
+				REQUIRE(actual[i].Response.PointOfCollision == expected[i].Response.PointOfCollision);
+			}
+		}
+	}
+}
+
+TEST_CASE("contact manifold clipping", "[manifold]")
+{
+	sf::RectangleShape box{ { 40.f, 20.f } };
+	sf::RectangleShape ground{ { 100.f, 20.f } };
+	ground.setPosition({ -30.f, 19.f });
+
+	std::vector<sf::Vector2f> boxVertices = Engine::getVertices(&box);
+	std::vector<sf::Vector2f> groundVertices = Engine::getVertices(&ground);
+	auto response = Engine::processCollision(boxVertices, groundVertices);
+	REQUIRE(response);
+
+	// the ground edge is clipped to the bottom of the box
+	Engine::ContactManifold manifold = Engine::findContactManifold(boxVertices, groundVertices, *response);
+	REQUIRE(manifold.PointCount == 2);
+	REQUIRE(Catch::Approx(manifold.Normal.x).margin(1e-5f) == 0.f);
+	REQUIRE(Catch::Approx(manifold.Normal.y) == -1.f);
+
+	std::vector<float> xs;
+
+	for (const auto& point : manifold.Points)
+	{
+		REQUIRE(Catch::Approx(point.Position.y) == 19.f);
+		REQUIRE(Catch::Approx(point.Penetration) == 1.f);
+		REQUIRE(point.Id.ClipSide != 0);
+		xs.push_back(point.Position.x);
+	}
+
+	std::sort(xs.begin(), xs.end());
+	REQUIRE(Catch::Approx(xs[0]).margin(1e-4f) == 0.f);
+	REQUIRE(Catch::Approx(xs[1]) == 40.f);
+
+	// hulls give the same manifold
+	Engine::CollisionHull boxHull{ &box };
+	Engine::CollisionHull groundHull{ &ground };
+	Engine::ContactManifold hullManifold = Engine::findContactManifold(boxHull, groundHull, *response);
+	REQUIRE(hullManifold.PointCount == 2);
+	REQUIRE(hullManifold.Points[0].Id == manifold.Points[0].Id);
+	REQUIRE(hullManifold.Points[1].Position == manifold.Points[1].Position);
+
+	// sliding along the ground keeps the features
+	box.move({ 3.f, 0.f });
+	boxVertices = Engine::getVertices(&box);
+	Engine::ContactManifold moved = Engine::findContactManifold(boxVertices, groundVertices, *Engine::processCollision(boxVertices, groundVertices));
+	REQUIRE(moved.PointCount == 2);
+	REQUIRE(moved.Points[0].Id == manifold.Points[0].Id);
+	REQUIRE(moved.Points[1].Id == manifold.Points[1].Id);
+
+	// a corner gives a single point
+	sf::RectangleShape tilted{ { 20.f, 20.f } };
+	tilted.setOrigin({ 10.f, 10.f });
+	tilted.setRotation(45.f);
+	tilted.setPosition({ 0.f, 19.f - 10.f * std::sqrt(2.f) + 2.f });
+	std::vector<sf::Vector2f> tiltedVertices = Engine::getVertices(&tilted);
+	Engine::ContactManifold corner = Engine::findContactManifold(tiltedVertices, groundVertices, *Engine::processCollision(tiltedVertices, groundVertices));
+	REQUIRE(corner.PointCount == 1);
+	REQUIRE(Catch::Approx(corner.Points[0].Penetration).margin(1e-3f) == 2.f);
+	REQUIRE(Catch::Approx(corner.Points[0].Position.x).margin(1e-3f) == 0.f);
+}
+
+TEST_CASE("contact manifold cache", "[manifold]")
+{
+	Engine::ContactManifold manifold;
+	manifold.PointCount = 2;
+	manifold.Points[0].Id = Engine::ContactId{ 1, 2, 1, false };
+	manifold.Points[1].Id = Engine::ContactId{ 1, 2, 2, false };
+	manifold.Points[0].NormalImpulse = 3.f;
+	manifold.Points[1].NormalImpulse = 4.f;
+
+	Engine::ContactManifoldCache cache;
+	cache.Store(0, 1, manifold);
+	cache.EndStep();
+
+	// only the point with the same features inherits the impulse
+	Engine::ContactManifold next;
+	next.PointCount = 2;
+	next.Points[0].Id = Engine::ContactId{ 1, 2, 2, false };
+	next.Points[1].Id = Engine::ContactId{ 1, 3, 0, false };
+	REQUIRE(cache.WarmStart(0, 1, next) == 1);
+	REQUIRE(next.Points[0].NormalImpulse == 4.f);
+	REQUIRE(next.Points[1].NormalImpulse == 0.f);
+	REQUIRE(cache.WarmStart(1, 0, next) == 0);
+
+	// a pair that isn't stored during a step is forgotten
+	REQUIRE(cache.size() == 1);
+	cache.EndStep();
+	REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("world fixed time step", "[world]")
+{
+	sf::RectangleShape box{ { 20.f, 20.f } };
+	sf::RectangleShape ground{ { 400.f, 50.f } };
+	ground.setPosition({ -200.f, 100.f });
+
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+	Engine::World::BodyId boxBody = world.CreateDynamicBody(&box);
+	world.CreateStaticBody(&ground);
+
+	// the rest of the frame time is carried over
+	float alpha = world.Advance(0.025f);
+	REQUIRE(world.GetStepCount() == 2);
+	REQUIRE(Catch::Approx(alpha).margin(1e-3f) == 0.5f);
+
+	sf::Vector2f interpolated = world.GetInterpolatedPosition(boxBody, alpha);
+	REQUIRE(interpolated.y > 0.f);
+	REQUIRE(interpolated.y < box.getPosition().y);
+
+	alpha = world.Advance(0.005f);
+	REQUIRE(world.GetStepCount() == 3);
+	REQUIRE(Catch::Approx(alpha).margin(1e-3f) == 0.f);
+
+	// the box falls onto the ground and stays on it
+	for (int step = 0; step < 300; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	REQUIRE(Catch::Approx(world.GetPosition(boxBody).y).margin(1.f) == 80.f);
+	REQUIRE(Catch::Approx(world.GetVelocity(boxBody).y).margin(1e-3f) == 0.f);
+
+	// the resting box is asleep and isn't tested against the ground anymore
+	REQUIRE(world.IsSleeping(boxBody));
+	REQUIRE(world.GetContacts().empty());
+}
+
+TEST_CASE("world tests circles and boxes with their own routines", "[world]")
+{
+	// 16-gons turned half a step have no vertex on the x axis, 79 px apart they are separated
+	// and the circles they approximate overlap by 1 px
+	sf::CircleShape left{ 40.f, Engine::CIRCLE_MIN_POINTS };
+	left.setOrigin({ 40.f, 40.f });
+	left.setRotation(11.25f);
+	sf::CircleShape right = left;
+	right.setPosition({ 79.f, 0.f });
+
+	sf::RectangleShape box{ { 20.f, 20.f } };
+	box.setPosition({ -10.f, 200.f });
+
+	Engine::World world;
+	world.SetGravity({ 0.f, 0.f });
+	Engine::World::BodyId leftBody = world.CreateStaticBody(&left);
+	Engine::World::BodyId rightBody = world.CreateDynamicBody(&right);
+	world.CreateDynamicBody(&box);
+	world.Step(world.GetTimeStep());
+
+	REQUIRE(world.GetContacts().size() == 1);
+	const Engine::PairResponse& contact = world.GetContacts().front();
+	REQUIRE(std::minmax(contact.Pair.IdA, contact.Pair.IdB) == std::minmax(leftBody, rightBody));
+
+	// the MTV of two circles lies on the line through their centers
+	sf::Vector2f mtv = contact.Response.MinimumTransitionVector;
+	REQUIRE(Catch::Approx(std::abs(mtv.x)).margin(1e-3f) == 1.f);
+	REQUIRE(Catch::Approx(mtv.y).margin(1e-3f) == 0.f);
+	REQUIRE_FALSE(Engine::processCollision(Engine::getVertices(&left), Engine::getVertices(&right)).has_value());
+}
+
+TEST_CASE("world tests low point count circles as polygons", "[world]")
+{
+	// a triangle, the box lies inside the circle around it but off the triangle
+	sf::CircleShape triangle{ 50.f, 3 };
+	sf::RectangleShape box{ { 10.f, 10.f } };
+	box.setPosition({ 20.f, 20.f });
+
+	Engine::CollisionScratch scratch;
+	REQUIRE_FALSE(Engine::processCollision(Engine::getVertices(&triangle), Engine::getVertices(&box), scratch).has_value());
+	REQUIRE_FALSE(Engine::processCollision(Engine::makeCollider(&triangle), Engine::makeCollider(&box), scratch).has_value());
+
+	Engine::World world;
+	world.SetGravity({ 0.f, 0.f });
+	world.CreateStaticBody(&triangle);
+	Engine::World::BodyId boxBody = world.CreateDynamicBody(&box);
+	world.Step(world.GetTimeStep());
+
+	REQUIRE(world.GetContacts().empty());
+	REQUIRE(world.GetPosition(boxBody) == sf::Vector2f{ 20.f, 20.f });
+}
+
+TEST_CASE("world step doesn't depend on worker count", "[world]")
+{
+	auto simulate = [](size_t workers)
+	{
+		std::vector<sf::RectangleShape> boxes(100, sf::RectangleShape{ { 10.f, 10.f } });
+		sf::RectangleShape ground{ { 1000.f, 20.f } };
+		ground.setPosition({ 0.f, 300.f });
+
+		Engine::World world{ 1.f / 120.f, workers };
+		world.CreateStaticBody(&ground);
+
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			boxes[i].setPosition({ 100.f + 7.f * (i % 10) + i / 10, -15.f * (i / 10) });
+			world.CreateDynamicBody(&boxes[i]);
+		}
+
+		for (int step = 0; step < 200; step++)
+		{
+			world.Step(world.GetTimeStep());
+		}
+
+		// steps don't touch the shapes
+		world.SyncShapes();
+		std::vector<sf::Vector2f> positions;
+
+		for (const auto& box : boxes)
+		{
+			positions.push_back(box.getPosition());
+		}
+
+		return positions;
+	};
+
+	std::vector<sf::Vector2f> expected = simulate(1);
+	REQUIRE(simulate(4) == expected);
+
+	// boxes are stopped by the ground
+	REQUIRE(std::ranges::all_of(expected, [](const sf::Vector2f& position) { return position.y < 300.f; }));
+}
+
+TEST_CASE("profiler timers and counters", "[profiler]")
+{
+	Engine::Profiler& profiler = Engine::Profiler::Get();
+	profiler.Reset();
+
+	{
+		Engine::ScopedTimer timer{ Engine::ProfilePhase::Narrowphase };
+		profiler.Add(Engine::ProfileCounter::PairsTested, 3);
+		profiler.Add(Engine::ProfileCounter::EarlySeparations);
+	}
+
+	Engine::ProfileStats stats = profiler.GetStats();
+	REQUIRE(stats.PhaseCalls[static_cast<size_t>(Engine::ProfilePhase::Narrowphase)] == 1);
+	REQUIRE(stats.PhaseCalls[static_cast<size_t>(Engine::ProfilePhase::Broadphase)] == 0);
+	REQUIRE(stats.Get(Engine::ProfileCounter::PairsTested) == 3);
+	REQUIRE(stats.Get(Engine::ProfileCounter::EarlySeparations) == 1);
+
+	// per-axis counts stay in the thread until its timer ends
+	{
+		Engine::ScopedTimer timer{ Engine::ProfilePhase::Sat };
+		profiler.AddLocal(Engine::ProfileCounter::AxesTested, 4);
+		REQUIRE(profiler.GetStats().Get(Engine::ProfileCounter::AxesTested) == 0);
+	}
+
+	REQUIRE(profiler.GetStats().Get(Engine::ProfileCounter::AxesTested) == 4);
+	REQUIRE(profiler.GetStats().PhaseCalls[static_cast<size_t>(Engine::ProfilePhase::Sat)] == 1);
+
+	// a report every 2 frames
+	std::ostringstream output;
+	Engine::ProfileReporter reporter{ output, 2 };
+	REQUIRE_FALSE(reporter.EndFrame());
+	REQUIRE(output.str().empty());
+	REQUIRE(reporter.EndFrame());
+
+	REQUIRE(reporter.GetLastStats().Frames == 2);
+	REQUIRE(reporter.GetLastStats().Get(Engine::ProfileCounter::PairsTested) == 3);
+	REQUIRE(profiler.GetStats().Get(Engine::ProfileCounter::PairsTested) == 0);
+
+	std::string json = output.str();
+	REQUIRE(json.starts_with("{\"frames\":2,\"phases\":{\"integration\":{\"calls\":0,"));
+	REQUIRE(json.find("\"pairs_tested\":{\"total\":3,\"per_frame\":1.5}") != std::string::npos);
+	REQUIRE(json.ends_with("}}\n"));
+}
+
+TEST_CASE("world warm starts resting contacts", "[world]")
+{
+	std::vector<sf::RectangleShape> boxes(8, sf::RectangleShape{ { 20.f, 20.f } });
+	sf::RectangleShape ground{ { 200.f, 50.f } };
+	ground.setPosition({ -100.f, 0.f });
+
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+	world.SetSolverIterations(2);
+	// the settled stack would fall asleep and drop its contacts
+	world.SetSleepingEnabled(false);
+	world.CreateStaticBody(&ground);
+
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		boxes[i].setPosition({ 0.f, -20.5f * (i + 1) });
+		world.CreateDynamicBody(&boxes[i]);
+	}
+
+	for (int step = 0; step < 400; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	// the stack rests with a few iterations, every contact carries the weight of the boxes above it
+	REQUIRE(world.GetManifolds().size() == boxes.size());
+
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		REQUIRE(std::abs(world.GetVelocity(static_cast<Engine::World::BodyId>(i + 1)).y) < 1.f);
+	}
+
+	for (size_t i = 0; i < world.GetContacts().size(); i++)
+	{
+		const Engine::ContactManifold& manifold = world.GetManifolds()[i];
+		REQUIRE(manifold.PointCount == 2);
+
+		float impulse = manifold.Points[0].NormalImpulse + manifold.Points[1].NormalImpulse;
+		REQUIRE(impulse > 0.f);
+	}
+
+	auto groundPair = std::ranges::find_if(world.GetContacts(), [](const Engine::PairResponse& contact) { return contact.Pair.IdB == 0; });
+	REQUIRE(groundPair != world.GetContacts().end());
+
+	const Engine::ContactManifold& groundContact = world.GetManifolds()[groundPair - world.GetContacts().begin()];
+	REQUIRE(Catch::Approx(groundContact.Points[0].NormalImpulse + groundContact.Points[1].NormalImpulse).epsilon(0.1f) == 500.f * 0.01f * boxes.size());
+}
+
+TEST_CASE("world islands sleep and wake up", "[world]")
+{
+	std::vector<sf::RectangleShape> boxes(5, sf::RectangleShape{ { 20.f, 20.f } });
+	sf::RectangleShape ground{ { 400.f, 50.f } };
+	ground.setPosition({ -100.f, 0.f });
+
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+	world.CreateStaticBody(&ground);
+
+	// a stack of 3 boxes, a single box aside and a box held high above the stack
+	std::vector<Engine::World::BodyId> bodies;
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		boxes[i].setPosition({ 0.f, -20.f * (i + 1) });
+	}
+
+	boxes[3].setPosition({ 200.f, -20.f });
+	boxes[4].setPosition({ 0.f, -300.f });
+
+	for (auto& box : boxes)
+	{
+		bodies.push_back(world.CreateDynamicBody(&box));
+	}
+
+	// the held box keeps moving up, so it stays awake
+	for (int step = 0; step < 100; step++)
+	{
+		world.SetVelocity(bodies[4], { 0.f, -world.GetGravity().y * world.GetTimeStep() });
+		world.Step(world.GetTimeStep());
+	}
+
+	REQUIRE(world.GetSleepingBodyCount() == 4);
+	REQUIRE_FALSE(world.IsSleeping(bodies[4]));
+	REQUIRE(world.GetContacts().empty());
+
+	// sleeping bodies stay where they are
+	sf::Vector2f topPosition = world.GetPosition(bodies[2]);
+	world.Step(world.GetTimeStep());
+	REQUIRE(world.GetPosition(bodies[2]) == topPosition);
+
+	// the released box wakes the stack it falls onto, the single box sleeps on
+	bool hasStackWoken = false;
+
+	for (int step = 0; step < 200; step++)
+	{
+		world.Step(world.GetTimeStep());
+		hasStackWoken = hasStackWoken || !world.IsSleeping(bodies[0]);
+		REQUIRE(world.IsSleeping(bodies[3]));
+	}
+
+	REQUIRE(hasStackWoken);
+	REQUIRE(world.GetPosition(bodies[4]).y < world.GetPosition(bodies[2]).y);
+
+	// moving a sleeping body wakes it
+	world.SetPosition(bodies[3], world.GetPosition(bodies[3]) + sf::Vector2f{ 0.f, -30.f });
+	REQUIRE(boxes[3].getPosition() == world.GetPosition(bodies[3]));
+	world.Step(world.GetTimeStep());
+	REQUIRE_FALSE(world.IsSleeping(bodies[3]));
+
+	world.SetSleepingEnabled(false);
+	REQUIRE(world.GetSleepingBodyCount() == 0);
+}
+
+TEST_CASE("swept SAT time of impact", "[toi]")
+{
+	sf::RectangleShape box{ { 10.f, 10.f } };
+	sf::RectangleShape wall{ { 2.f, 100.f } };
+	wall.setPosition({ 50.f, -50.f });
+
+	std::vector<sf::Vector2f> boxVertices = Engine::getVertices(&box);
+	std::vector<sf::Vector2f> wallVertices = Engine::getVertices(&wall);
+
+	// the box's right side reaches the wall after 40 of 100 pixels
+	auto hit = Engine::sweptSeparatingAxisTest(boxVertices, wallVertices, { 100.f, 0.f });
+	REQUIRE(hit);
+	REQUIRE(Catch::Approx(hit->Time) == 0.4f);
+	REQUIRE(Catch::Approx(hit->Normal.x) == -1.f);
+	REQUIRE(Catch::Approx(hit->Normal.y).margin(1e-6f) == 0.f);
+
+	// hulls give the same time
+	Engine::CollisionHull boxHull{ &box };
+	Engine::CollisionHull wallHull{ &wall };
+	auto hullHit = Engine::sweptSeparatingAxisTest(boxHull, wallHull, { 100.f, 0.f });
+	REQUIRE(hullHit);
+	REQUIRE(Catch::Approx(hullHit->Time) == 0.4f);
+
+	// diagonal move, the box meets the wall when its right side gets there
+	auto diagonal = Engine::sweptSeparatingAxisTest(boxVertices, wallVertices, { 80.f, 40.f });
+	REQUIRE(diagonal);
+	REQUIRE(Catch::Approx(diagonal->Time) == 0.5f);
+
+	// too short, moving away, passing by and overlapping at the start
+	REQUIRE_FALSE(Engine::sweptSeparatingAxisTest(boxVertices, wallVertices, { 30.f, 0.f }));
+	REQUIRE_FALSE(Engine::sweptSeparatingAxisTest(boxVertices, wallVertices, { -100.f, 0.f }));
+	REQUIRE_FALSE(Engine::sweptSeparatingAxisTest(boxVertices, wallVertices, { 0.f, 100.f }));
+	REQUIRE_FALSE(Engine::sweptSeparatingAxisTest(boxVertices, wallVertices, { 100.f, -200.f }));
+
+	box.setPosition({ 45.f, 0.f });
+	REQUIRE_FALSE(Engine::sweptSeparatingAxisTest(Engine::getVertices(&box), wallVertices, { 100.f, 0.f }));
+}
+
+TEST_CASE("fast bodies don't tunnel", "[toi]")
+{
+	auto shoot = [](bool isFast)
+	{
+		sf::RectangleShape bullet{ { 10.f, 10.f } };
+		sf::RectangleShape wall{ { 2.f, 100.f } };
+		wall.setPosition({ 150.f, -50.f });
+
+		// 100 pixels per step, far more than the wall is thick
+		Engine::World world{ 1.f / 60.f };
+		world.SetGravity({ 0.f, 0.f });
+		Engine::World::BodyId bulletBody = world.CreateDynamicBody(&bullet);
+		world.CreateStaticBody(&wall);
+		world.SetFastBody(bulletBody, isFast);
+		world.SetVelocity(bulletBody, { 6000.f, 0.f });
+
+		for (int step = 0; step < 10; step++)
+		{
+			world.Step(world.GetTimeStep());
+		}
+
+		return std::pair{ world.GetPosition(bulletBody), world.GetVelocity(bulletBody) };
+	};
+
+	REQUIRE(shoot(false).first.x > 150.f);
+
+	// the fast bullet stops at the wall and loses the velocity into it
+	auto [position, velocity] = shoot(true);
+	REQUIRE(Catch::Approx(position.x).margin(0.1f) == 140.f);
+	REQUIRE(position.x <= 140.f);
+	REQUIRE(velocity.x == 0.f);
+}
+
+TEST_CASE("world bodies have generational handles", "[world]")
+{
+	std::vector<sf::RectangleShape> boxes(3, sf::RectangleShape{ { 20.f, 20.f } });
+	sf::RectangleShape ground{ { 400.f, 50.f } };
+	ground.setPosition({ -100.f, 0.f });
+
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		boxes[i].setPosition({ 60.f * i, -20.f });
+	}
+
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+	Engine::World::BodyId first = world.CreateDynamicBody(&boxes[0]);
+	Engine::World::BodyId second = world.CreateDynamicBody(&boxes[1]);
+	world.CreateStaticBody(&ground);
+
+	// a fresh world hands out handles in creation order, static bodies are stored first without changing them
+	REQUIRE(first == 0);
+	REQUIRE(second == 1);
+	REQUIRE(world.GetPosition(second) == boxes[1].getPosition());
+
+	world.DestroyBody(first);
+	REQUIRE_FALSE(world.IsValid(first));
+	REQUIRE(world.IsValid(second));
+	REQUIRE(world.GetBodyCount() == 2);
+
+	// the freed slot is reused with a new generation, the old handle stays invalid
+	Engine::World::BodyId third = world.CreateDynamicBody(&boxes[2]);
+	REQUIRE(third != first);
+	REQUIRE((third & Engine::BodyStorage::INDEX_MASK) == (first & Engine::BodyStorage::INDEX_MASK));
+	REQUIRE_FALSE(world.IsValid(first));
+	REQUIRE(world.GetPosition(third) == boxes[2].getPosition());
+
+	for (int step = 0; step < 10; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	// both boxes rest on the ground and are written to their shapes on sync
+	REQUIRE(world.GetContacts().size() == 2);
+	REQUIRE(boxes[1].getPosition().y == -20.f);
+	world.SyncShapes();
+	REQUIRE(boxes[1].getPosition() == world.GetPosition(second));
+	REQUIRE(boxes[2].getPosition() == world.GetPosition(third));
+}
+
+TEST_CASE("static BVH queries", "[static_bvh]")
+{
+	std::mt19937 random{ 7 };
+	std::uniform_real_distribution<float> position(0.f, 500.f);
+	std::uniform_real_distribution<float> size(1.f, 40.f);
+	std::vector<Engine::StaticBvh<size_t>::Item> items;
+
+	for (size_t i = 0; i < 200; i++)
+	{
+		sf::Vector2f lower{ position(random), position(random) };
+		items.push_back({ Engine::Aabb{ lower, lower + sf::Vector2f{ size(random), size(random) } }, i });
+	}
+
+	Engine::StaticBvh<size_t> bvh;
+	bvh.Build(items);
+	REQUIRE(bvh.size() == items.size());
+	REQUIRE(bvh.GetNodeCount() <= items.size());
+
+	// the tree finds exactly the items a brute force search finds
+	for (size_t query = 0; query < 50; query++)
+	{
+		sf::Vector2f lower{ position(random), position(random) };
+		Engine::Aabb box{ lower, lower + sf::Vector2f{ 60.f, 30.f } };
+
+		std::vector<size_t> found;
+		bvh.Query(box, [&](size_t item) { found.push_back(item); return true; });
+		std::ranges::sort(found);
+
+		std::vector<size_t> expected;
+
+		for (const auto& item : items)
+		{
+			if (item.Bounds.Overlaps(box))
+			{
+				expected.push_back(item.UserData);
+			}
+		}
+
+		REQUIRE(found == expected);
+	}
+
+	// a query stops when the callback returns false
+	size_t calls = 0;
+	bvh.Query(Engine::Aabb{ { 0.f, 0.f }, { 600.f, 600.f } }, [&](size_t) { calls++; return calls < 3; });
+	REQUIRE(calls == 3);
+
+	bvh.clear();
+	bvh.Query(Engine::Aabb{ { 0.f, 0.f }, { 600.f, 600.f } }, [&](size_t) { calls++; return true; });
+	REQUIRE(calls == 3);
+}
+
+TEST_CASE("world static geometry", "[world]")
+{
+	std::vector<sf::RectangleShape> steps(10, sf::RectangleShape{ { 40.f, 10.f } });
+	sf::RectangleShape box{ { 20.f, 20.f } };
+	box.setPosition({ 110.f, -100.f });
+
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+	Engine::World::BodyId boxBody = world.CreateDynamicBody(&box);
+	std::vector<Engine::World::BodyId> stepBodies;
+
+	for (size_t i = 0; i < steps.size(); i++)
+	{
+		steps[i].setPosition({ 40.f * i, 10.f * i });
+		stepBodies.push_back(world.CreateStaticGeometry(&steps[i]));
+	}
+
+	world.BakeStaticGeometry();
+
+	for (int step = 0; step < 200; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	// the box lands on the higher of the two steps under it, which are found in the baked tree
+	REQUIRE(Catch::Approx(world.GetPosition(boxBody).y).margin(1.f) == 0.f);
+	REQUIRE(world.IsSleeping(boxBody));
+
+	// removed geometry is baked out by the next step, the box falls through the gap
+	world.DestroyBody(stepBodies[2]);
+	world.DestroyBody(stepBodies[3]);
+	REQUIRE_FALSE(world.IsSleeping(boxBody));
+
+	for (int step = 0; step < 60; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	REQUIRE(world.GetPosition(boxBody).y > 50.f);
+}
+
+TEST_CASE("raycast against polygons", "[query]")
+{
+	sf::RectangleShape box{ { 20.f, 20.f } };
+	box.setPosition({ 50.f, -10.f });
+	std::vector<sf::Vector2f> vertices = Engine::getVertices(&box);
+
+	auto hit = Engine::raycast(Engine::Ray{ { 0.f, 0.f }, { 100.f, 0.f } }, vertices);
+	REQUIRE(hit);
+	REQUIRE(Catch::Approx(hit->Fraction) == 0.5f);
+	REQUIRE(Catch::Approx(hit->Point.x) == 50.f);
+	REQUIRE(Catch::Approx(hit->Normal.x) == -1.f);
+	REQUIRE(Catch::Approx(hit->Normal.y).margin(1e-6f) == 0.f);
+
+	// the winding doesn't matter
+	std::vector<sf::Vector2f> reversed{ vertices.rbegin(), vertices.rend() };
+	auto reversedHit = Engine::raycast(Engine::Ray{ { 0.f, 0.f }, { 100.f, 0.f } }, reversed);
+	REQUIRE(reversedHit);
+	REQUIRE(Catch::Approx(reversedHit->Fraction) == 0.5f);
+
+	// hitting the top from above
+	auto topHit = Engine::raycast(Engine::Ray{ { 60.f, -50.f }, { 0.f, 80.f } }, vertices);
+	REQUIRE(topHit);
+	REQUIRE(Catch::Approx(topHit->Fraction) == 0.5f);
+	REQUIRE(Catch::Approx(topHit->Normal.y) == -1.f);
+
+	// too short, passing by, pointing away and starting inside
+	REQUIRE_FALSE(Engine::raycast(Engine::Ray{ { 0.f, 0.f }, { 40.f, 0.f } }, vertices));
+	REQUIRE_FALSE(Engine::raycast(Engine::Ray{ { 0.f, -20.f }, { 100.f, 0.f } }, vertices));
+	REQUIRE_FALSE(Engine::raycast(Engine::Ray{ { 0.f, 0.f }, { -100.f, 0.f } }, vertices));
+	REQUIRE_FALSE(Engine::raycast(Engine::Ray{ { 60.f, 0.f }, { 100.f, 0.f } }, vertices));
+
+	Engine::CollisionHull hull{ &box };
+	REQUIRE(Engine::containsPoint(hull.GetView(), { 60.f, 0.f }));
+	REQUIRE(Engine::containsPoint(hull.GetView(), { 50.f, 10.f }));
+	REQUIRE_FALSE(Engine::containsPoint(hull.GetView(), { 49.f, 0.f }));
+}
+
+TEST_CASE("world batched spatial queries", "[query]")
+{
+	std::mt19937 random{ 11 };
+	std::uniform_real_distribution<float> position(0.f, 400.f);
+	std::vector<sf::RectangleShape> walls(40, sf::RectangleShape{ { 30.f, 8.f } });
+	std::vector<sf::CircleShape> balls(20, sf::CircleShape{ 6.f, 8 });
+
+	Engine::World world;
+	std::vector<const sf::Shape*> shapes;
+	std::vector<Engine::World::BodyId> bodies;
+
+	for (auto& wall : walls)
+	{
+		wall.setPosition({ position(random), position(random) });
+		wall.setRotation(position(random));
+		shapes.push_back(&wall);
+		bodies.push_back(world.CreateStaticGeometry(&wall));
+	}
+
+	for (auto& ball : balls)
+	{
+		ball.setPosition({ position(random), position(random) });
+		shapes.push_back(&ball);
+		bodies.push_back(world.CreateDynamicBody(&ball));
+	}
+
+	world.BakeStaticGeometry();
+
+	// 10 packets and a partial one
+	std::vector<Engine::Ray> rays(43);
+
+	for (auto& ray : rays)
+	{
+		ray = Engine::Ray{ { position(random), position(random) }, { position(random) - 200.f, position(random) - 200.f } };
+	}
+
+	std::vector<Engine::RayHit> hits(rays.size());
+	world.Raycast(rays, hits);
+	size_t hitCount = 0;
+
+	// the closest hit of a brute force search over every shape
+	for (size_t i = 0; i < rays.size(); i++)
+	{
+		Engine::RayHit expected;
+
+		for (size_t body = 0; body < shapes.size(); body++)
+		{
+			auto hit = Engine::raycast(rays[i], Engine::getVertices(shapes[body]));
+
+			if (hit && hit->Fraction < expected.Fraction)
+			{
+				expected = *hit;
+				expected.Body = bodies[body];
+			}
+		}
+
+		REQUIRE(hits[i].Body == expected.Body);
+		REQUIRE(Catch::Approx(hits[i].Fraction).margin(1e-4f) == expected.Fraction);
+		hitCount += hits[i].Body != Engine::INVALID_BODY;
+
+		auto single = world.Raycast(rays[i]);
+		REQUIRE(single.has_value() == (expected.Body != Engine::INVALID_BODY));
+	}
+
+	REQUIRE(hitCount > 0);
+	REQUIRE(hitCount < rays.size());
+
+	// a point inside a ball finds the ball, its bounding box corner finds nothing
+	sf::Vector2f center = balls[0].getPosition() + sf::Vector2f{ 6.f, 6.f };
+	std::vector<Engine::World::BodyId> found;
+	world.QueryPoint(center, found);
+	REQUIRE(std::ranges::find(found, bodies[walls.size()]) != found.end());
+
+	world.QueryPoint(balls[0].getPosition() + sf::Vector2f{ 0.5f, 0.5f }, found);
+	REQUIRE(std::ranges::find(found, bodies[walls.size()]) == found.end());
+
+	// a batch of boxes gives the same bodies as single queries
+	std::vector<Engine::Aabb> boxes;
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		sf::Vector2f lower{ position(random), position(random) };
+		boxes.push_back(Engine::Aabb{ lower, lower + sf::Vector2f{ 80.f, 80.f } });
+	}
+
+	Engine::QueryResults results;
+	world.QueryAabbs(boxes, results);
+	REQUIRE(results.size() == boxes.size());
+
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		world.QueryAabb(boxes[i], found);
+		REQUIRE(std::ranges::equal(results[i], found));
+	}
+
+	std::vector<sf::Vector2f> points{ center, { -100.f, -100.f } };
+	world.QueryPoints(points, results);
+	REQUIRE(results.size() == 2);
+	REQUIRE_FALSE(results[0].empty());
+	REQUIRE(results[1].empty());
+
+	// a shape that isn't a body overlaps the ball it covers
+	sf::RectangleShape area{ { 4.f, 4.f } };
+	area.setPosition(center);
+	world.QueryShape(&area, found);
+	REQUIRE(std::ranges::find(found, bodies[walls.size()]) != found.end());
+}
+
+TEST_CASE("convex decomposition", "[decomposition]")
+{
+	auto totalArea = [](const std::vector<std::vector<sf::Vector2f>>& pieces)
+	{
+		float area = 0.f;
+
+		for (const auto& piece : pieces)
+		{
+			REQUIRE(Engine::isConvex(piece));
+			area += Engine::orientedArea(piece);
+		}
+
+		return area;
+	};
+
+	// a convex polygon is its only piece
+	std::vector<sf::Vector2f> square{ { 0.f, 0.f }, { 10.f, 0.f }, { 10.f, 10.f }, { 0.f, 10.f } };
+	REQUIRE(Engine::isConvex(square));
+	REQUIRE(Engine::decomposeConvex(square).size() == 1);
+
+	// an L takes the minimal 2 pieces in both windings
+	std::vector<sf::Vector2f> corner{ { 0.f, 0.f }, { 30.f, 0.f }, { 30.f, 10.f }, { 10.f, 10.f }, { 10.f, 30.f }, { 0.f, 30.f } };
+	REQUIRE_FALSE(Engine::isConvex(corner));
+	auto pieces = Engine::decomposeConvex(corner);
+	REQUIRE(pieces.size() == 2);
+	REQUIRE(Catch::Approx(totalArea(pieces)) == Engine::orientedArea(corner));
+
+	std::vector<sf::Vector2f> reversed{ corner.rbegin(), corner.rend() };
+	pieces = Engine::decomposeConvex(reversed);
+	REQUIRE(pieces.size() == 2);
+	REQUIRE(Catch::Approx(totalArea(pieces)) == Engine::orientedArea(reversed));
+
+	// a star has 5 reflex corners, its 8 triangles merge into fewer pieces that cover it exactly
+	std::vector<sf::Vector2f> star;
+
+	for (int i = 0; i < 10; i++)
+	{
+		float radius = i % 2 == 0 ? 30.f : 10.f;
+		float angle = i * 3.14159265f / 5.f;
+		star.push_back({ radius * std::cos(angle), radius * std::sin(angle) });
+	}
+
+	pieces = Engine::decomposeConvex(star);
+	REQUIRE(pieces.size() < 8);
+	REQUIRE(Catch::Approx(totalArea(pieces)) == Engine::orientedArea(star));
+}
+
+TEST_CASE("body pools stay bounded when geometry is read again", "[decomposition]")
+{
+	const std::vector<sf::Vector2f> CUP_POINTS{ { 0.f, 0.f }, { 10.f, 0.f }, { 10.f, 90.f }, { 90.f, 90.f },
+		{ 90.f, 0.f }, { 100.f, 0.f }, { 100.f, 100.f }, { 0.f, 100.f } };
+	sf::ConvexShape cup;
+	sf::RectangleShape box{ { 20.f, 20.f } };
+
+	auto makeCup = [&](size_t pointCount)
+	{
+		// all points make the cup, the first 3 a triangle
+		cup.setPointCount(pointCount);
+
+		for (size_t i = 0; i < pointCount; i++)
+		{
+			cup.setPoint(i, CUP_POINTS[i == 2 && pointCount == 3 ? 6 : i]);
+		}
+	};
+
+	makeCup(CUP_POINTS.size());
+	Engine::BodyStorage storage;
+	Engine::BodyId cupBody = storage.Create(&cup, false);
+	storage.Create(&box, false);
+	size_t vertices = storage.LocalVertices.size();
+	size_t axes = storage.LocalAxes.size();
+	size_t pieces = storage.Pieces.size();
+
+	// the same counts reuse the ranges of the body
+	for (int i = 0; i < 1000; i++)
+	{
+		cup.setScale({ 1.f + i % 2, 1.f + i % 2 });
+		storage.ReadShape(storage.IndexOf(cupBody));
+	}
+
+	REQUIRE(storage.LocalVertices.size() == vertices);
+	REQUIRE(storage.LocalAxes.size() == axes);
+	REQUIRE(storage.Pieces.size() == pieces);
+
+	// changing counts are compacted away
+	for (int i = 0; i < 1000; i++)
+	{
+		makeCup(i % 2 == 0 ? 3 : CUP_POINTS.size());
+		storage.ReadShape(storage.IndexOf(cupBody));
+	}
+
+	REQUIRE(storage.LocalVertices.size() <= 2 * vertices);
+	REQUIRE(storage.LocalAxes.size() <= 2 * axes);
+	REQUIRE(storage.Pieces.size() <= 2 * pieces);
+
+	// the body reads as a fresh one
+	Engine::BodyStorage fresh;
+	Engine::BodyId freshBody = fresh.Create(&cup, false);
+	uint32_t index = storage.IndexOf(cupBody);
+	REQUIRE(storage.GetPieceCount(index) == fresh.GetPieceCount(fresh.IndexOf(freshBody)));
+
+	for (uint32_t piece = 0; piece < storage.GetPieceCount(index); piece++)
+	{
+		Engine::HullView actual = storage.GetHull(index, piece);
+		Engine::HullView expected = fresh.GetHull(fresh.IndexOf(freshBody), piece);
+		REQUIRE(std::ranges::equal(actual.Vertices, expected.Vertices));
+		REQUIRE(std::ranges::equal(actual.Axes, expected.Axes));
+		REQUIRE(actual.Centroid == expected.Centroid);
+	}
+}
+
+TEST_CASE("world concave bodies", "[decomposition]")
+{
+	// a cup: the box falls inside and rests on the inner floor, the hull of the cup would push it out
+	sf::ConvexShape cup{ 8 };
+	const std::vector<sf::Vector2f> CUP_POINTS{ { 0.f, 0.f }, { 10.f, 0.f }, { 10.f, 90.f }, { 90.f, 90.f },
+		{ 90.f, 0.f }, { 100.f, 0.f }, { 100.f, 100.f }, { 0.f, 100.f } };
+
+	for (size_t i = 0; i < CUP_POINTS.size(); i++)
+	{
+		cup.setPoint(i, CUP_POINTS[i]);
+	}
+
+	sf::RectangleShape box{ { 20.f, 20.f } };
+	box.setPosition({ 40.f, 20.f });
+
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+	Engine::World::BodyId cupBody = world.CreateStaticGeometry(&cup);
+	Engine::World::BodyId boxBody = world.CreateDynamicBody(&box);
+
+	for (int step = 0; step < 200; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	REQUIRE(Catch::Approx(world.GetPosition(boxBody).y).margin(1.f) == 70.f);
+	REQUIRE(Catch::Approx(world.GetPosition(boxBody).x).margin(0.1f) == 40.f);
+
+	// a ray into the cup passes the opening and hits the inner floor
+	auto hit = world.Raycast(Engine::Ray{ { 20.f, -10.f }, { 0.f, 200.f } });
+	REQUIRE(hit);
+	REQUIRE(hit->Body == cupBody);
+	REQUIRE(Catch::Approx(hit->Point.y) == 90.f);
+
+	// the opening isn't part of the cup, a wall is
+	std::vector<Engine::World::BodyId> found;
+	world.QueryPoint({ 30.f, 50.f }, found);
+	REQUIRE(found.empty());
+	world.QueryPoint({ 5.f, 50.f }, found);
+	REQUIRE(found.size() == 1);
+}
+
+TEST_CASE("collision proxy simplification", "[lod]")
+{
+	sf::CircleShape circle{ 50.f, 64 };
+	std::vector<sf::Vector2f> vertices = Engine::getVertices(&circle);
+
+	// the budget removes vertices above the tolerance, the greedy octagon stays closer than a regular hexagon would
+	Engine::SimplifiedPolygon octagon = Engine::simplifyConvexPolygon(vertices, Engine::CollisionLod{ 8, 0.5f });
+	REQUIRE(octagon.Vertices.size() == 8);
+	REQUIRE(octagon.MaxDeviation > 0.5f);
+	REQUIRE(octagon.MaxDeviation < 50.f * (1.f - std::cos(3.14159265f / 6.f)));
+	REQUIRE(Engine::isConvex(octagon.Vertices));
+	REQUIRE(std::abs(Engine::orientedArea(octagon.Vertices)) < std::abs(Engine::orientedArea(vertices)));
+
+	// within the budget only removals below the tolerance happen
+	Engine::SimplifiedPolygon precise = Engine::simplifyConvexPolygon(vertices, Engine::CollisionLod{ 64, 0.5f });
+	REQUIRE(precise.Vertices.size() < 64);
+	REQUIRE(precise.Vertices.size() > 8);
+	REQUIRE(precise.MaxDeviation <= 0.5f);
+
+	// collinear vertices cost nothing, a box with split edges comes back as a box
+	const std::vector<sf::Vector2f> BOX{ { 0.f, 0.f }, { 5.f, 0.f }, { 10.f, 0.f }, { 10.f, 10.f }, { 0.f, 10.f }, { 0.f, 5.f } };
+	Engine::SimplifiedPolygon box = Engine::simplifyConvexPolygon(BOX, Engine::CollisionLod{ 64, 0.5f });
+	REQUIRE(box.Vertices.size() == 4);
+	REQUIRE(box.MaxDeviation == 0.f);
+
+	// no budget goes below a triangle
+	REQUIRE(Engine::simplifyConvexPolygon(vertices, Engine::CollisionLod{ 0, 0.f }).Vertices.size() == 3);
+}
+
+TEST_CASE("world collision proxies", "[lod]")
+{
+	sf::RectangleShape ground{ { 400.f, 20.f } };
+	ground.setPosition({ -200.f, 100.f });
+	sf::CircleShape ball{ 20.f, 90 };
+	ball.setOrigin({ 20.f, 20.f });
+
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+	Engine::World::BodyId groundBody = world.CreateStaticGeometry(&ground);
+	Engine::World::BodyId ballBody = world.CreateDynamicBody(&ball);
+
+	// a triangle proxy, the ball rests on its lowest vertex or edge instead of on the circle
+	const Engine::CollisionLod LOD{ 3, 0.f };
+	std::vector<sf::Vector2f> localPoints;
+
+	for (size_t i = 0; i < ball.getPointCount(); i++)
+	{
+		localPoints.push_back(ball.getPoint(i) - ball.getOrigin());
+	}
+
+	Engine::SimplifiedPolygon proxy = Engine::simplifyConvexPolygon(localPoints, LOD);
+	float proxyBottom = std::ranges::max(proxy.Vertices, {}, &sf::Vector2f::y).y;
+
+	REQUIRE(world.GetCollisionDeviation(ballBody) == 0.f);
+	float deviation = world.SetCollisionLod(ballBody, LOD);
+	REQUIRE(deviation > 0.f);
+	REQUIRE(deviation == world.GetCollisionDeviation(ballBody));
+	REQUIRE(world.SetCollisionLod(groundBody, Engine::CollisionLod{}) == 0.f);
+
+	for (int step = 0; step < 200; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	// the proxy lies inside the ball, so it sinks by at most the deviation, here by clearly more than the solver slop
+	REQUIRE(100.f - proxyBottom > 80.f + 1.f);
+	REQUIRE(Catch::Approx(world.GetPosition(ballBody).y).margin(0.5f) == 100.f - proxyBottom);
+	REQUIRE(world.GetPosition(ballBody).y < 80.f + deviation + 1.f);
+
+	// the render geometry is back in use
+	REQUIRE(world.SetCollisionLod(ballBody, std::nullopt) == 0.f);
+}
+
+TEST_CASE("greedy tile merging", "[tiles]")
+{
+	// an L of 5 tiles, a block of 4 and a single tile
+	const std::vector<uint8_t> TILES{
+		1, 0, 0, 1, 1,
+		1, 0, 0, 1, 1,
+		1, 1, 1, 0, 0,
+		0, 0, 0, 0, 1 };
+
+	std::vector<Engine::TileRect> rectangles = Engine::mergeTiles(TILES, 5, Engine::TileRect{ 0, 0, 5, 4 });
+	REQUIRE(rectangles.size() == 4);
+
+	uint32_t coveredTiles = 0;
+
+	for (const Engine::TileRect& rectangle : rectangles)
+	{
+		coveredTiles += rectangle.Width * rectangle.Height;
+
+		for (uint32_t y = rectangle.Y; y < rectangle.Y + rectangle.Height; y++)
+		{
+			for (uint32_t x = rectangle.X; x < rectangle.X + rectangle.Width; x++)
+			{
+				REQUIRE(TILES[y * 5 + x] == 1);
+			}
+		}
+	}
+
+	REQUIRE(coveredTiles == 10);
+	REQUIRE(rectangles[1].X == 3);
+	REQUIRE(rectangles[1].Width == 2);
+	REQUIRE(rectangles[1].Height == 2);
+
+	// a region cuts the block in half
+	rectangles = Engine::mergeTiles(TILES, 5, Engine::TileRect{ 4, 0, 1, 4 });
+	REQUIRE(rectangles.size() == 2);
+	REQUIRE(rectangles[0].Height == 2);
+}
+
+TEST_CASE("world tile layer", "[tiles]")
+{
+	Engine::World world{ 0.01f };
+	world.SetGravity({ 0.f, 500.f });
+
+	// three chunks, a floor in the last one and a ledge in the first one
+	Engine::TileLayer layer{ world, 40, 40, { 10.f, 10.f }, { -100.f, -350.f } };
+
+	for (uint32_t x = 0; x < 40; x++)
+	{
+		layer.SetSolid(x, 38, true);
+		layer.SetSolid(x, 39, true);
+	}
+
+	layer.SetSolid(5, 2, true);
+	layer.SetSolid(6, 2, true);
+
+	REQUIRE(layer.Rebuild() == 2);
+	REQUIRE(layer.GetRectangleCount() == 2);
+	REQUIRE(layer.Rebuild() == 0);
+
+	// a box slides along the merged floor, every tile edge it crosses would stop it
+	sf::RectangleShape box{ { 10.f, 10.f } };
+	box.setPosition({ 40.f, 19.f });
+	Engine::World::BodyId boxBody = world.CreateDynamicBody(&box);
+	world.SetVelocity(boxBody, { 100.f, 0.f });
+
+	for (int step = 0; step < 20; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	REQUIRE(world.GetPosition(boxBody).x > 55.f);
+	REQUIRE(Catch::Approx(world.GetPosition(boxBody).y).margin(0.5f) == 20.f);
+
+	// digging a hole rebuilds only its chunk, a box falls through it
+	layer.SetSolid(25, 38, false);
+	layer.SetSolid(26, 38, false);
+	layer.SetSolid(25, 39, false);
+	layer.SetSolid(26, 39, false);
+	REQUIRE(layer.Rebuild() == 1);
+	REQUIRE(layer.GetRectangleCount() == 3);
+
+	sf::RectangleShape ball{ { 8.f, 8.f } };
+	ball.setPosition({ 151.f, 0.f });
+	Engine::World::BodyId ballBody = world.CreateDynamicBody(&ball);
+
+	for (int step = 0; step < 60; step++)
+	{
+		world.Step(world.GetTimeStep());
+	}
+
+	REQUIRE(world.GetPosition(ballBody).y > 50.f);
+	REQUIRE(Catch::Approx(world.GetPosition(boxBody).y).margin(0.5f) == 20.f);
+}
+
+TEST_CASE("world batch", "[batch]")
+{
+	const size_t WORLDS = 24;
+	std::vector<sf::RectangleShape> floors(WORLDS, sf::RectangleShape{ { 200.f, 20.f } });
+	std::vector<sf::RectangleShape> boxes(WORLDS, sf::RectangleShape{ { 10.f, 10.f } });
+	sf::RectangleShape serialFloor{ { 200.f, 20.f } };
+	sf::RectangleShape serialBox{ { 10.f, 10.f } };
+
+	std::vector<Engine::World::BodyId> boxBodies(WORLDS);
+	Engine::WorldBatch batch{ 4 };
+	REQUIRE(batch.GetWorkerCount() == 4);
+
+	for (size_t i = 0; i < WORLDS; i++)
+	{
+		Engine::World& world = batch.CreateWorld(0.01f);
+		world.SetGravity({ 0.f, 500.f });
+		floors[i].setPosition({ 0.f, 100.f });
+		boxes[i].setPosition({ 50.f + i, 0.f });
+		world.CreateStaticGeometry(&floors[i]);
+		boxBodies[i] = world.CreateDynamicBody(&boxes[i]);
+	}
+
+	// the same scene as the last world, stepped alone
+	Engine::World serialWorld{ 0.01f };
+	serialWorld.SetGravity({ 0.f, 500.f });
+	serialFloor.setPosition({ 0.f, 100.f });
+	serialBox.setPosition({ 50.f + WORLDS - 1, 0.f });
+	serialWorld.CreateStaticGeometry(&serialFloor);
+	Engine::World::BodyId serialBody = serialWorld.CreateDynamicBody(&serialBox);
+
+	// the callback runs on the workers, results are checked afterwards
+	std::vector<size_t> stepsSeen(WORLDS, 0);
+	std::vector<uint8_t> isInOrder(WORLDS, 1);
+
+	batch.Step(100, [&](Engine::World& world, size_t index, size_t step)
+	{
+		isInOrder[index] &= stepsSeen[index] == step ? 1 : 0;
+		stepsSeen[index]++;
+
+		// pushes each box sideways by its index in the first step
+		if (step == 0)
+		{
+			world.SetVelocity(boxBodies[index], { static_cast<float>(index), 0.f });
+		}
+	});
+
+	serialWorld.SetVelocity(serialBody, { static_cast<float>(WORLDS - 1), 0.f });
+
+	for (int step = 0; step < 100; step++)
+	{
+		serialWorld.Step(serialWorld.GetTimeStep());
+	}
+
+	REQUIRE(std::all_of(stepsSeen.begin(), stepsSeen.end(), [](size_t steps) { return steps == 100; }));
+	REQUIRE(std::all_of(isInOrder.begin(), isInOrder.end(), [](uint8_t isStepInOrder) { return isStepInOrder == 1; }));
+
+	// worlds don't share state, each one ends where it would alone
+	for (size_t i = 0; i < WORLDS; i++)
+	{
+		REQUIRE(Catch::Approx(batch[i].GetPosition(boxBodies[i]).y).margin(0.5f) == 90.f);
+	}
+
+	REQUIRE(batch[WORLDS - 1].GetPosition(boxBodies[WORLDS - 1]) == serialWorld.GetPosition(serialBody));
+}
+
+TEST_CASE("replay recording", "[replay]")
+{
+	// a box is pushed by recorded input and falls onto a floor
+	auto simulate = [](std::ostream* recording, std::istream* replay, Engine::WorldSnapshot& lastSnapshot, size_t& snapshotCount)
+	{
+		sf::RectangleShape floor{ { 200.f, 20.f } };
+		floor.setPosition({ 0.f, 100.f });
+		sf::RectangleShape box{ { 10.f, 10.f } };
+		box.setPosition({ 50.f, 0.f });
+
+		Engine::World world{ 0.01f };
+		world.SetGravity({ 0.f, 500.f });
+		world.CreateStaticGeometry(&floor);
+		Engine::World::BodyId boxBody = world.CreateDynamicBody(&box);
+
+		auto apply = [&](const std::vector<Engine::InputEvent>& events, float frameTime)
+		{
+			for (const Engine::InputEvent& event : events)
+			{
+				box.move(event.Value);
+			}
+
+			world.SyncBody(boxBody);
+			world.Advance(frameTime);
+		};
+
+		if (recording != nullptr)
+		{
+			Engine::ReplayWriter writer{ *recording, 10 };
+
+			for (int frame = 0; frame < 95; frame++)
+			{
+				std::vector<Engine::InputEvent> events;
+
+				if (frame % 7 == 0)
+				{
+					events.push_back(Engine::InputEvent{ 0, { 1.f + frame, 0.f } });
+				}
+
+				// uneven frame times, some frames run no step and some several
+				float frameTime = 0.004f + 0.003f * (frame % 5);
+				apply(events, frameTime);
+				writer.WriteFrame(frameTime, events, world);
+			}
+
+			REQUIRE(writer.GetFrameCount() == 95);
+			lastSnapshot = world.CaptureSnapshot();
+			return;
+		}
+
+		Engine::ReplayReader reader{ *replay };
+		REQUIRE(reader.IsValid());
+		Engine::ReplayFrame frame;
+		size_t frames = 0;
+
+		while (reader.ReadFrame(frame))
+		{
+			apply(frame.Events, frame.FrameTime);
+			frames++;
+
+			if (frame.Snapshot)
+			{
+				REQUIRE(Engine::snapshotDifference(world.CaptureSnapshot(), *frame.Snapshot) == 0.f);
+				snapshotCount++;
+			}
+		}
+
+		REQUIRE(frames == 95);
+		lastSnapshot = world.CaptureSnapshot();
+	};
+
+	std::stringstream recording;
+	Engine::WorldSnapshot recorded;
+	Engine::WorldSnapshot replayed;
+	size_t snapshotCount = 0;
+
+	simulate(&recording, nullptr, recorded, snapshotCount);
+	REQUIRE(recorded.StepCount > 0);
+	REQUIRE(recorded.Bodies.size() == 2);
+
+	std::stringstream replay{ recording.str() };
+	simulate(nullptr, &replay, replayed, snapshotCount);
+	REQUIRE(snapshotCount == 9);
+	REQUIRE(Engine::snapshotDifference(recorded, replayed) == 0.f);
+
+	// a different state is caught
+	replayed.Bodies[1].Position.x += 0.25f;
+	REQUIRE(Engine::snapshotDifference(recorded, replayed) == 0.25f);
+	replayed.StepCount++;
+	REQUIRE(Engine::snapshotDifference(recorded, replayed) == std::numeric_limits<float>::infinity());
+}
+
+TEST_CASE("replay reader rejects broken recordings", "[replay]")
+{
+	std::stringstream notRecording{ "not a recording" };
+	REQUIRE_FALSE(Engine::ReplayReader{ notRecording }.IsValid());
+
+	std::stringstream recording;
+	Engine::World world;
+	Engine::ReplayWriter writer{ recording, 0 };
+	const std::vector<Engine::InputEvent> EVENTS{ { 3, { 1.f, 2.f } }, { 4, { -1.f, 0.f } } };
+	writer.WriteFrame(0.016f, EVENTS, world);
+	writer.WriteFrame(0.017f, {}, world);
+
+	// header, a frame with two events and an uneventful one
+	std::string bytes = recording.str();
+	REQUIRE(bytes.size() == 8 + 7 + 2 * 10 + 7);
+
+	std::stringstream whole{ bytes };
+	Engine::ReplayReader reader{ whole };
+	Engine::ReplayFrame frame;
+	REQUIRE(reader.ReadFrame(frame));
+	REQUIRE(frame.FrameTime == 0.016f);
+	REQUIRE(frame.Events.size() == 2);
+	REQUIRE(frame.Events[1].Code == 4);
+	REQUIRE(frame.Events[1].Value == sf::Vector2f{ -1.f, 0.f });
+	REQUIRE_FALSE(frame.Snapshot);
+	REQUIRE(reader.ReadFrame(frame));
+	REQUIRE(frame.Events.empty());
+	REQUIRE_FALSE(reader.ReadFrame(frame));
+
+	// a recording cut off in the middle of a frame ends before it
+	std::stringstream cut{ bytes.substr(0, bytes.size() - 3) };
+	Engine::ReplayReader cutReader{ cut };
+	REQUIRE(cutReader.ReadFrame(frame));
+	REQUIRE_FALSE(cutReader.ReadFrame(frame));
+}
+
+TEST_CASE("scene file round trip", "[scene]")
+{
+	sf::RectangleShape platform{ { 100.f, 20.f } };
+	platform.setPosition({ 10.f, 10.f });
+	platform.setRotation(20.f);
+	const std::vector<std::vector<sf::Vector2f>> POLYGONS{
+		Engine::getVertices(&platform),
+		// an L, split into two pieces
+		{ { 300.f, 50.f }, { 340.f, 50.f }, { 340.f, 60.f }, { 310.f, 60.f }, { 310.f, 90.f }, { 300.f, 90.f } },
+		// a bar across three chunks, centered in the middle one
+		{ { 0.f, 250.f }, { 390.f, 250.f }, { 390.f, 260.f }, { 0.f, 260.f } } };
+	std::string path = (std::filesystem::temp_directory_path() / "unittest_round_trip.scene").string();
+
+	{
+		std::ofstream output{ path, std::ios::binary };
+		Engine::writeScene(output, POLYGONS, 100.f);
+	}
+
+	Engine::SceneFile scene;
+	REQUIRE(scene.Open(path));
+	const Engine::SceneHeader& header = scene.GetHeader();
+	REQUIRE(header.ShapeCount == 4);
+	REQUIRE(header.ChunksX == 4);
+	REQUIRE(header.ChunksY == 3);
+
+	// the pieces cover the polygons and every piece is convex
+	float polygonArea = 0.f;
+	float shapeArea = 0.f;
+	uint32_t vertexCount = 0;
+
+	for (const auto& polygon : POLYGONS)
+	{
+		polygonArea += std::abs(Engine::orientedArea(polygon));
+	}
+
+	for (uint32_t shape = 0; shape < header.ShapeCount; shape++)
+	{
+		std::vector<sf::Vector2f> polygon(scene.GetPolygon(shape).begin(), scene.GetPolygon(shape).end());
+		shapeArea += std::abs(Engine::orientedArea(polygon));
+		vertexCount += static_cast<uint32_t>(polygon.size());
+		REQUIRE(Engine::isConvex(polygon));
+	}
+
+	REQUIRE(shapeArea == Catch::Approx(polygonArea));
+	REQUIRE(vertexCount == header.VertexCount);
+
+	// the prebuilt trees find the same shapes as testing every shape, the bar from chunks away too
+	std::mt19937 random{ 7 };
+	std::uniform_real_distribution<float> position(-50.f, 450.f);
+
+	for (int i = 0; i < 200; i++)
+	{
+		sf::Vector2f lower{ position(random), position(random) };
+		Engine::Aabb box{ lower, lower + sf::Vector2f{ 30.f, 30.f } };
+		std::vector<uint32_t> expected;
+		std::vector<uint32_t> found;
+
+		for (uint32_t shape = 0; shape < header.ShapeCount; shape++)
+		{
+			if (scene.GetShapes()[shape].Bounds.Overlaps(box))
+			{
+				expected.push_back(shape);
+			}
+		}
+
+		scene.QueryShapes(box, [&](uint32_t shape) { found.push_back(shape); return true; });
+		std::sort(found.begin(), found.end());
+		REQUIRE(found == expected);
+	}
+
+	std::vector<uint32_t> barHits;
+	scene.QueryShapes(Engine::Aabb{ { 5.f, 252.f }, { 6.f, 253.f } }, [&](uint32_t shape) { barHits.push_back(shape); return true; });
+	REQUIRE(barHits.size() == 1);
+
+	scene.Close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("scene file rejects other files", "[scene]")
+{
+	const std::vector<std::vector<sf::Vector2f>> POLYGONS{ { { 0.f, 0.f }, { 10.f, 0.f }, { 10.f, 10.f } } };
+	std::string path = (std::filesystem::temp_directory_path() / "unittest_broken.scene").string();
+	std::stringstream bytes;
+	Engine::writeScene(bytes, POLYGONS, 100.f);
+	std::string scene = bytes.str();
+
+	auto open = [&](const std::string& content)
+	{
+		{
+			std::ofstream output{ path, std::ios::binary };
+			output << content;
+		}
+
+		Engine::SceneFile file;
+		return file.Open(path);
+	};
+
+	REQUIRE(open(scene));
+	REQUIRE_FALSE(open(scene.substr(0, scene.size() - 4)));
+	REQUIRE_FALSE(open(scene + "tail"));
+	REQUIRE_FALSE(open("ESCN"));
+	REQUIRE_FALSE(open(""));
+
+	std::string otherVersion = scene;
+	otherVersion[4] = 2;
+	REQUIRE_FALSE(open(otherVersion));
+
+	// right size, but a range or child index points out of its section
+	Engine::SceneHeader header;
+	std::memcpy(&header, scene.data(), sizeof(header));
+	size_t chunks = sizeof(Engine::SceneHeader);
+	size_t shapes = chunks + header.ChunksX * header.ChunksY * sizeof(Engine::SceneChunk);
+	size_t nodes = shapes + header.ShapeCount * sizeof(Engine::SceneShape);
+
+	auto corrupt = [&](size_t offset, uint32_t value)
+	{
+		std::string content = scene;
+		std::memcpy(content.data() + offset, &value, sizeof(value));
+		return content;
+	};
+
+	REQUIRE(open(corrupt(chunks + offsetof(Engine::SceneChunk, ShapeBegin), 0)));
+	REQUIRE_FALSE(open(corrupt(chunks + offsetof(Engine::SceneChunk, ShapeBegin), 1)));
+	REQUIRE_FALSE(open(corrupt(chunks + offsetof(Engine::SceneChunk, ShapeCount), 2)));
+	REQUIRE_FALSE(open(corrupt(chunks + offsetof(Engine::SceneChunk, NodeBegin), 0xffffffff)));
+	REQUIRE_FALSE(open(corrupt(chunks + offsetof(Engine::SceneChunk, NodeCount), 2)));
+	REQUIRE_FALSE(open(corrupt(shapes + offsetof(Engine::SceneShape, VertexBegin), 1)));
+	REQUIRE_FALSE(open(corrupt(shapes + offsetof(Engine::SceneShape, VertexCount), 4)));
+	REQUIRE_FALSE(open(corrupt(shapes + offsetof(Engine::SceneShape, VertexCount), 2)));
+	REQUIRE_FALSE(open(corrupt(shapes + offsetof(Engine::SceneShape, VertexCount), 0)));
+	REQUIRE_FALSE(open(corrupt(nodes + offsetof(Engine::SceneNode, Offset), 1)));
+	// a leaf turned into an inner node whose children are outside the chunk
+	REQUIRE_FALSE(open(corrupt(nodes + offsetof(Engine::SceneNode, Count), 0)));
+
+	std::filesystem::remove(path);
+	Engine::SceneFile missing;
+	REQUIRE_FALSE(missing.Open(path));
+	REQUIRE_FALSE(missing.IsOpen());
+}
+
+TEST_CASE("scene streaming", "[scene]")
+{
+	// platforms every 50 px on a 1000 px square
+	std::vector<std::vector<sf::Vector2f>> polygons;
+
+	for (int y = 0; y < 20; y++)
+	{
+		for (int x = 0; x < 20; x++)
+		{
+			sf::Vector2f position{ 50.f * x, 50.f * y };
+			polygons.push_back({ position, position + sf::Vector2f{ 30.f, 0.f }, position + sf::Vector2f{ 30.f, 5.f }, position + sf::Vector2f{ 0.f, 5.f } });
+		}
+	}
+
+	std::string path = (std::filesystem::temp_directory_path() / "unittest_streaming.scene").string();
+
+	{
+		std::ofstream output{ path, std::ios::binary };
+		Engine::writeScene(output, polygons, 200.f);
+	}
+
+	Engine::SceneFile scene;
+	REQUIRE(scene.Open(path));
+	REQUIRE(scene.GetChunks().size() == 25);
+
+	Engine::World world;
+	auto loadedShapes = [&](const Engine::SceneStreamer& streamer)
+	{
+		size_t shapes = 0;
+
+		for (uint32_t chunk = 0; chunk < scene.GetChunks().size(); chunk++)
+		{
+			shapes += streamer.IsChunkLoaded(chunk) ? scene.GetChunks()[chunk].ShapeCount : 0;
+		}
+
+		return shapes;
+	};
+
+	{
+		Engine::SceneStreamer streamer{ world, scene, 150.f, 300.f };
+		streamer.Update({ 100.f, 100.f });
+		streamer.Flush();
+
+		// the cells within 150 px of the point: 2x2 chunks
+		REQUIRE(streamer.GetPendingChunkCount() == 0);
+		REQUIRE(streamer.GetLoadedChunkCount() == 4);
+		REQUIRE(streamer.IsChunkLoaded(0));
+		REQUIRE(streamer.IsChunkLoaded(6));
+		REQUIRE_FALSE(streamer.IsChunkLoaded(2));
+		REQUIRE(world.GetBodyCount() == loadedShapes(streamer));
+
+		// loaded chunks collide
+		world.Step(world.GetTimeStep());
+		auto hit = world.Raycast(Engine::Ray{ { 65.f, 30.f }, { 0.f, 40.f } });
+		REQUIRE(hit);
+		REQUIRE(hit->Point.y == Catch::Approx(50.f));
+
+		// a little movement keeps the chunks, a long one swaps them
+		streamer.Update({ 150.f, 150.f });
+		streamer.Flush();
+		REQUIRE(streamer.IsChunkLoaded(0));
+
+		streamer.Update({ 900.f, 900.f });
+		REQUIRE_FALSE(streamer.IsChunkLoaded(0));
+		streamer.Flush();
+		REQUIRE(streamer.IsChunkLoaded(24));
+		REQUIRE_FALSE(streamer.IsChunkLoaded(6));
+		REQUIRE(world.GetBodyCount() == loadedShapes(streamer));
+
+		world.Step(world.GetTimeStep());
+		REQUIRE_FALSE(world.Raycast(Engine::Ray{ { 65.f, 30.f }, { 0.f, 40.f } }));
+	}
+
+	// the streamer takes its chunks along
+	REQUIRE(world.GetBodyCount() == 0);
+
+	scene.Close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("fixed-size SAT", "[sat]")
+{
+	std::mt19937 random{ 11 };
+	std::uniform_real_distribution<float> position(0.f, 60.f);
+	std::uniform_real_distribution<float> rotation(0.f, 360.f);
+	Engine::CollisionScratch scratch;
+	size_t collisions = 0;
+
+	for (int i = 0; i < 200; i++)
+	{
+		// triangles and quads, with parallel edges in the quads
+		sf::CircleShape triangle{ 20.f, 3 };
+		sf::RectangleShape quad{ { 40.f, 20.f } };
+		triangle.setPosition({ position(random), position(random) });
+		triangle.setRotation(rotation(random));
+		quad.setPosition({ position(random), position(random) });
+		quad.setRotation(rotation(random));
+
+		auto verticesA = Engine::getVertices(&triangle);
+		auto verticesB = Engine::getVertices(&quad);
+		std::array<sf::Vector2f, 3> arrayA;
+		std::array<sf::Vector2f, 4> arrayB;
+		std::copy(verticesA.begin(), verticesA.end(), arrayA.begin());
+		std::copy(verticesB.begin(), verticesB.end(), arrayB.begin());
+
+		for (auto [expected, actual] : {
+			std::pair{ Engine::detail::separatingAxisTest(verticesA, verticesB, scratch), Engine::processCollision(arrayA, arrayB) },
+			std::pair{ Engine::detail::separatingAxisTest(verticesB, verticesA, scratch), Engine::processCollision(arrayB, arrayA) },
+			std::pair{ Engine::detail::separatingAxisTest(verticesB, verticesB, scratch), Engine::processCollision(verticesB, verticesB, scratch) } })
+		{
+			REQUIRE(actual.has_value() == expected.has_value());
+
+			if (expected)
+			{
+				REQUIRE(actual->MinimumTransitionVector == expected->MinimumTransitionVector);
+				REQUIRE(actual->PointOfCollision == expected->PointOfCollision);
+			}
+		}
+
+		// the cached hulls take the specialized path for both vertex counts
+		Engine::CollisionHull hullA{ &triangle };
+		Engine::CollisionHull hullB{ &quad };
+		auto expected = Engine::detail::hullSeparatingAxisTest(hullA.GetView(), hullB.GetView(), hullA.GetView().Vertices, hullB.GetView().Vertices);
+		auto actual = Engine::processCollision(hullA, hullB);
+		REQUIRE(actual.has_value() == expected.has_value());
+
+		if (expected)
+		{
+			collisions++;
+			REQUIRE(actual->MinimumTransitionVector == expected->MinimumTransitionVector);
+			REQUIRE(actual->PointOfCollision == expected->PointOfCollision);
+		}
+	}
+
+	// both separated and colliding pairs are compared
+	REQUIRE(collisions > 20);
+	REQUIRE(collisions < 180);
+}
+
+TEST_CASE("body handles stay valid after a slot is reused many times", "[world]")
+{
+	sf::RectangleShape box{ { 20.f, 20.f } };
+	Engine::World world;
+	Engine::World::BodyId previous = world.CreateDynamicBody(&box);
+	bool isAlwaysValid = true;
+	bool isAlwaysNew = true;
+
+	// more reuses than the generation bits of a handle hold
+	for (int i = 0; i < 10000; i++)
+	{
+		world.DestroyBody(previous);
+		Engine::World::BodyId id = world.CreateDynamicBody(&box);
+		isAlwaysValid = isAlwaysValid && world.IsValid(id) && id != Engine::INVALID_BODY;
+		isAlwaysNew = isAlwaysNew && id != previous && !world.IsValid(previous);
+		previous = id;
+	}
+
+	REQUIRE(isAlwaysValid);
+	REQUIRE(isAlwaysNew);
+	REQUIRE(world.GetBodyCount() == 1);
 }
\ No newline at end of file